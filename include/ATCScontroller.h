@@ -4,9 +4,14 @@
 #include "FlightsScheduler.h"
 #include "Runway.h"
 #include "RunwayManager.h"
+#include "RunwayMatcher.h"
+#include "ControllerSignal.h"
+#include "LogHistogram.h"
 #include "Radar.h"
+#include "WorldSnapshot.h"
 #include <vector>
 #include <mutex>
+#include <atomic>
 #include <string>
 
 /**
@@ -15,32 +20,73 @@
  */
 class ATCScontroller 
 {
+public:
+    static const size_t candidateWindow = 16;   // Flights per queue looked at for the free runways
+    
 private:
     FlightsScheduler scheduler;      // Flight scheduler for managing flight queues
     int schedulingInterval;          // How often to run scheduling (in seconds)
-    time_t lastScheduleTime;         // Last time we ran the scheduling algorithm
+    SimTime lastScheduleTime;        // Last simulated time we ran the scheduling algorithm
     RunwayManager* runwayManager;    // Pointer to runway manager (now we're properly modular!)
+    RunwayMatcher runwayMatcher;     // Free runways by capability for each assignment round
+    std::vector<IndexedHeap::Entry> candidates; // Reused peek buffer of assignRunway()
+    bool cargoDeparturesFirst;       // Which flow's cargo gets the next cargo runway (they take turns)
     Radar radar;                     // Radar system for detecting violations
+    bool verbose;                    // Print runway assignments to the console
+    SimTime runwayLeaseMs;           // How long a runway lease lasts before the runway can be taken back
+    const WorldSnapshotBuffer* worldSnapshots; // Published by the engine (status queries read these)
+    ControllerSignal signal;         // Queue inserts, runway releases and emergencies since the last round
+    LogHistogram reactionNs;         // Wall time from the first signal of a batch to its round
     
     // Mutex for thread-safe access to controller data
     std::mutex controllerMutex;
     
+    // Give back a runway leased to a flight that left its queue before we could claim it
+    void dropLease(RunwayClass* runway, Aircraft* aircraft);
+    
 public:
     // Constructor
     ATCScontroller();
     
-    // Set the runway manager - call this after construction
+    // Set the runway manager - call this after construction (and after changing runway capabilities)
     void setRunwayManager(RunwayManager* rwManager);
     
     // Set the pipe for AVN Generator communication
     void setAVNPipe(int pipeWriteEnd);
     
+    // Turn runway assignment console output on or off
+    void setVerbose(bool enabled);
+    
+    // How long a flight may hold its runway - a flight that hasn't released it by then loses it
+    void setRunwayLeaseMs(SimTime leaseMs);
+    
+    // Where the status queries get their snapshots (nullptr = scan the live table)
+    void setWorldSnapshots(const WorldSnapshotBuffer* snapshots);
+    
     // Monitor flights in the airspace
     void monitorFlight();
     
-    // Assign runways to aircraft
+    // Assign runways to aircraft - matches the queue heads to the free runways by capability
     void assignRunway();
     
+    // Event-driven alternative to monitorFlight(): one assignment round for everything
+    // signalled since the last one - returns the ControllerSignal reasons (0 = nothing to do)
+    unsigned handleSignals();
+    
+    // Block on the signal and handle each batch until 'running' goes false (a controller thread)
+    void runEventLoop(const std::atomic<bool>& running);
+    
+    // What the engine signals: a runway was given back, an aircraft's fields changed
+    // (signals if that declared or changed an emergency)
+    void notifyRunwayFreed();
+    void syncAircraft(const Aircraft* aircraft);
+    
+    ControllerSignal& getSignal();
+    
+    // Signal-to-round latency of handleSignals() (wall nanoseconds) and a one-line summary
+    LogHistogram::Snapshot getReactionTimes() const;
+    std::string getReactionReport() const;
+    
     // Handle detected violations (now delegates to Radar)
     void handleViolations();
     
@@ -54,6 +100,9 @@ public:
     void scheduleArrival(Aircraft* aircraft);
     void scheduleDeparture(Aircraft* aircraft);
     
+    // Forget a flight that finished or gave up (drops it from the queues)
+    void removeFlight(Aircraft* aircraft);
+    
     // Get the scheduler
     FlightsScheduler* getScheduler();
     
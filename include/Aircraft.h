@@ -2,8 +2,10 @@
 #define AIRCONTROLX_AIRCRAFT_H
 
 #include <string>
+#include <functional>
 #include "Common.h"
 #include "Timer.h"
+#include "AircraftTable.h"
 
 /**
  * Aircraft class representing a flight in the AirControlX system.
@@ -25,8 +27,13 @@ public:
     bool isFaulty;             // Flag for faulty aircraft
     bool isActive;             // Flag for active flight
     int aircraftIndex;         // Tells which index the aircraft belongs to in AirLine
-    time_t queueEntryTime;     // When the aircraft entered the queue (for FCFS)
+    SimTime queueEntryTime;    // Simulated time the aircraft entered the queue (-1 if not queued)
     bool hasRunwayAssigned;    // Whether a runway has been assigned
+    int assignedRunway;        // RunwayManager index of the runway it got (-1 = none)
+    RunwayLease runwayLease;   // Lease it holds on that runway (noRunwayLease = none)
+    unsigned long long randomKey; // CounterRandom stream of this aircraft (from airline + index)
+    AircraftHandle tableHandle;   // Row in the scheduler's AircraftTable (invalid if not scheduled)
+    std::function<void(Aircraft*)> onRunwayAssigned;  // Called by AssignRunaway() (set by whoever waits for the runway)
 
     // Constructor
     Aircraft(int index, const std::string& airlineName, AirCraftType aircraftType);
@@ -49,7 +56,15 @@ public:
     // Check if aircraft is airborne
     bool isinAir() const;
     
+    // Score shown to users: staticPriority() + 1 point per second in the queue (reads the clock)
     int calculatePriorityScore() const;
+    
+    // Emergency level and type part of the score - doesn't change while waiting
+    int staticPriority() const;
+    
+    // Queue key that orders aircraft like calculatePriorityScore() at any moment
+    // without reading the clock: staticPriority() * 1000 - queueEntryTime
+    long long priorityKey() const;
     // Check if aircraft is on the ground
     bool isOnGround() const;
     
@@ -59,7 +74,8 @@ public:
     // Request runway assignment
     void RequestRunawayAssignment();
     
-    // Assign runway to aircraft
+    // Notify whoever is waiting for the runway (it sets hasRunwayAssigned under its own lock),
+    // or mark the runway as assigned if nobody is
     void AssignRunaway();
 
     //Update the position of the aircraft
@@ -120,6 +136,17 @@ public:
      * Useful for SFML text displays
      */
     std::string getTypeString() const;
+
+    // The same display helpers without an Aircraft (used for snapshot views)
+    static std::string stateName(FlightState state);
+    static std::string displayName(const std::string& flightNumber, FlightState state, int emergencyLevel, bool violation);
+    static float rotationAngle(Direction direction);
+    static void statusColor(FlightState state, int emergencyLevel, bool violation, int color[3]);
+
+private:
+    // Deterministic random number for this aircraft at the current simulated time
+    // (slot tells apart several draws made at the same moment)
+    int randomRange(int slot, int minValue, int maxValue) const;
 };
 
 #endif // AIRCONTROLX_AIRCRAFT_H
\ No newline at end of file
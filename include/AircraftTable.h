@@ -0,0 +1,163 @@
+#ifndef AIRCONTROLX_AIRCRAFTTABLE_H
+#define AIRCONTROLX_AIRCRAFTTABLE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "Common.h"
+#include "SimClock.h"
+
+class Aircraft;
+
+// 32-bit row number of an aircraft in an AircraftTable
+typedef unsigned int AircraftHandle;
+static const AircraftHandle invalidAircraftHandle = 0xFFFFFFFFu;
+
+// Handle plus the row's generation when it was taken - stale once the row is freed
+struct AircraftRef
+{
+    AircraftHandle handle;
+    unsigned int generation;
+};
+
+/**
+ * AircraftTable keeps the fields that scans look at (state, speed, position,
+ * emergency level, flags, queue entry time) as contiguous columns, one row
+ * per aircraft. A sweep over 100k aircraft then reads a few hundred KB of
+ * columns instead of chasing 100k Aircraft* through strings and timers.
+ * The Aircraft object stays the owner of the cold data (flight number,
+ * airline, timer) and is reachable through the row's aircraft column.
+ *
+ * Rows live in fixed-size blocks that never move, so rows can be updated
+ * while other rows are being added. Freed rows are reused before the
+ * table grows. The table is a mirror: update() copies an aircraft's hot
+ * fields into its row, and the engine calls it after every step and event.
+ *
+ * Every row has a generation that is bumped when the row is freed, so an
+ * AircraftRef taken earlier can tell a finished flight from the new flight
+ * that reused its row.
+ */
+class AircraftTable
+{
+public:
+    // Bits of the flags column
+    enum Flags : unsigned char
+    {
+        FlagLive = 1,               // Row is in use
+        FlagViolation = 2,          // Aircraft::HasViolation
+        FlagActiveViolation = 4,    // Aircraft::hasActiveViolation
+        FlagFaulty = 8,             // Aircraft::isFaulty
+        FlagActive = 16,            // Aircraft::isActive
+        FlagRunwayAssigned = 32     // Aircraft::hasRunwayAssigned
+    };
+
+    static const int blockBits = 12;
+    static const size_t blockSize = size_t(1) << blockBits;   // Rows per block
+    static const size_t maxBlocks = 4096;                     // 16M rows
+
+    // One block of rows - every array is a column
+    struct Block
+    {
+        unsigned char state[blockSize];      // FlightState
+        unsigned char type[blockSize];       // AirCraftType
+        unsigned char direction[blockSize];  // Direction
+        unsigned char emergency[blockSize];  // EmergencyNo
+        unsigned char flags[blockSize];      // Flags bits
+        int speed[blockSize];
+        int x[blockSize];
+        int y[blockSize];
+        SimTime queueEntry[blockSize];       // -1 if not queued
+        unsigned int generation[blockSize];  // Bumped every time the row is freed
+        Aircraft* aircraft[blockSize];       // Cold data
+    };
+
+    AircraftTable();
+
+    // Give the aircraft a row (sets aircraft->tableHandle); invalid handle if full
+    AircraftHandle insert(Aircraft* aircraft);
+
+    // Free the aircraft's row (resets aircraft->tableHandle)
+    void remove(Aircraft* aircraft);
+
+    // Copy the aircraft's hot fields into its row (no-op without a row)
+    void update(const Aircraft& aircraft);
+
+    // Set or clear flag bits of a row
+    void setFlags(AircraftHandle handle, unsigned char bits, bool on);
+
+    // The flags column value update() writes for this aircraft (FlagLive included)
+    static unsigned char flagsOf(const Aircraft& aircraft);
+
+    Aircraft* get(AircraftHandle handle) const;
+    
+    // Reference to the aircraft's current row (invalid handle if it has none)
+    AircraftRef refOf(const Aircraft* aircraft) const;
+    
+    // The aircraft behind a reference - nullptr once its row was freed, even if reused since
+    Aircraft* resolve(const AircraftRef& ref) const;
+    int getEmergencyLevel(AircraftHandle handle) const;
+    size_t size() const;        // Live rows
+    size_t capacity() const;    // Rows allocated
+
+    // Scans over the columns
+    std::vector<Aircraft*> collectByState(FlightState state) const;
+    std::vector<Aircraft*> collectByType(AirCraftType type) const;
+    std::vector<Aircraft*> collectByEmergencyLevel(int level) const;
+    std::vector<Aircraft*> collectEmergencies() const;                  // Any level > 0
+    std::vector<Aircraft*> collectWithFlags(unsigned char bits) const;  // Any of the bits set
+    int countWithFlags(unsigned char bits) const;
+    int countEmergencies() const;
+    void countByState(int counts[8]) const;    // Indexed by FlightState
+    void countByType(int counts[5]) const;     // Indexed by AirCraftType
+    Aircraft* findAt(int x, int y, int radius) const;
+
+    // forEachBlock() with insert/remove held off, so the rows' Aircraft (cold data) can be read too
+    template <typename Visitor>
+    void forEachBlockLocked(Visitor visit) const
+    {
+        std::lock_guard<std::mutex> lock(structureMutex);
+        forEachBlock(visit);
+    }
+
+    /**
+     * Call visit(block, rows) for every allocated block, where rows is how many
+     * of its rows have been handed out. Rows without FlagLive are free.
+     */
+    template <typename Visitor>
+    void forEachBlock(Visitor visit) const
+    {
+        size_t rows = rowCount.load(std::memory_order_acquire);
+        for (size_t b = 0; b * blockSize < rows; b++)
+        {
+            size_t inBlock = rows - b * blockSize;
+            visit(*blocks[b], inBlock < blockSize ? inBlock : blockSize);
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Block>> blocks;  // Reserved up front so it never reallocates
+    std::vector<AircraftHandle> freeRows;
+    std::atomic<size_t> rowCount;               // Rows handed out so far (high-water mark)
+    std::atomic<size_t> liveCount;
+    mutable std::mutex structureMutex;          // Guards insert/remove
+
+    // Collect the aircraft of every live row matching the predicate
+    template <typename Predicate>
+    std::vector<Aircraft*> collect(Predicate matches) const
+    {
+        std::vector<Aircraft*> result;
+        forEachBlock([&](const Block& block, size_t rows) {
+            for (size_t r = 0; r < rows; r++)
+            {
+                if ((block.flags[r] & FlagLive) && matches(block, r))
+                {
+                    result.push_back(block.aircraft[r]);
+                }
+            }
+        });
+        return result;
+    }
+};
+
+#endif // AIRCONTROLX_AIRCRAFTTABLE_H
@@ -17,6 +17,7 @@ public:
     std::vector<Aircraft> aircrafts; // Fleet of aircraft
     int activeFlights;             // Number of currently active flights
     int maxFlights;                // Maximum allowed simultaneous flights
+    double weight;                 // Share of the runways under fair scheduling
     
     // Constructor
     Airline();
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
 #include "Airline.h"
 #include "Common.h"
 
@@ -15,6 +16,9 @@ class AirlineManager
 private:
     // Collection of airlines in the system
     std::vector<Airline*> airlines;
+    
+    // Position in our random stream - one step per getRandomAirline() call
+    std::atomic<unsigned long long> randomCounter;
 
 public:
     // Constructor and destructor
@@ -22,7 +26,8 @@ public:
     ~AirlineManager();
     
     // Initialize all airlines with their configurations
-    void initialize();
+    // totalAircraft scales the six fleets proportionally (20 = the standard fleet sizes)
+    void initialize(int totalAircraft = 20);
     
     // Get all airlines
     std::vector<Airline*>& getAllAirlines();
@@ -0,0 +1,129 @@
+#ifndef AIRCONTROLX_AIRPORTNETWORK_H
+#define AIRCONTROLX_AIRPORTNETWORK_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include "SimClock.h"
+#include "Aircraft.h"
+#include "RunwayManager.h"
+#include "ATCScontroller.h"
+#include "SimulationEngine.h"
+#include "HandoffRing.h"
+
+/**
+ * AirportNetwork simulates a region of airports, each one a shard with its
+ * own clock, runways, controller and single-worker engine pinned to a core.
+ * Shards share nothing while they run: a departure that reaches cruise is
+ * pushed onto the destination's lock-free HandoffRing and becomes an
+ * arrival there once its flight time is up.
+ *
+ * Time moves in windows no longer than the shortest flight between two
+ * airports (the lookahead). Every shard runs its engine up to the end of
+ * the window in parallel; a flight handed off in the window can't arrive
+ * before the next one starts, so the network only meets at the window
+ * boundary to deliver the handoffs. Shards run independently in between,
+ * which is what lets the network scale with the number of cores.
+ *
+ * Flights fly 'legs' legs: leave the home airport, land at a random other
+ * airport, turn around, leave again, and so on.
+ */
+class AirportNetwork
+{
+public:
+    // One airport shard
+    struct Airport
+    {
+        std::string code;               // AP00, AP01, ...
+        double x, y;                    // Position on the regional map (km)
+        int cpu;                        // CPU its engine is pinned to (-1 = none)
+        SimClock clock;                 // As-fast-as-possible, moved by the network's windows
+        RunwayManager runways;
+        ATCScontroller controller;
+        std::unique_ptr<SimulationEngine> engine;   // After the parts it uses, so it goes first
+
+        HandoffRing inbound;            // Flights on their way here
+        std::mutex overflowMutex;       // Handoffs that found 'inbound' full
+        std::vector<HandoffRing::Handoff> overflow;
+        std::vector<HandoffRing::Handoff> delivering;   // Reused drain buffer (network thread)
+
+        std::atomic<unsigned long long> departures;     // Left here for another airport
+        std::atomic<unsigned long long> arrivals;       // Reached the gate here
+        std::atomic<unsigned long long> timeouts;       // Gave up waiting for a runway here
+
+        Airport();
+    };
+
+    AirportNetwork();
+    ~AirportNetwork();
+
+    // Build 'airportCount' airports of 'runwaysPerAirport' runways on a grid 'spacingKm' apart,
+    // pinned round-robin to the hardware threads when 'pinCores' is set (call once, before anything else)
+    void initialize(int airportCount, int runwaysPerAirport = 3, double spacingKm = 150.0, bool pinCores = true);
+
+    // Start a flight at its home airport as a departure, delayMs into the run (call before start())
+    void addFlight(Aircraft* aircraft, int homeAirport, SimTime delayMs, int legs = 2);
+
+    // Start every airport's engine
+    bool start();
+
+    // Run windows on the calling thread until every flight has flown its legs or timed out
+    void run();
+
+    // Stop every airport's engine
+    void stop();
+
+    // Simulated flight time between two airports: taxi-out to touchdown at cruise speed
+    SimTime flightTime(int from, int to) const;
+
+    // Longest window that keeps every handoff in a later window (the shortest flight)
+    SimTime getLookahead() const;
+
+    // Statistics
+    int getAirportCount() const;
+    Airport& getAirport(int index);
+    const Airport& getAirport(int index) const;
+    unsigned long long getWindowCount() const;
+    unsigned long long getHandoffCount() const;     // Flights delivered to another airport
+    unsigned long long getOverflowCount() const;    // Handoffs that found their ring full
+    int getCompletedFlightCount() const;            // Departures and arrivals, all airports
+    int getTimedOutFlightCount() const;
+    unsigned long long getProcessedEventCount() const;
+    SimTime getSimulatedTime() const;               // Clock of the airport furthest ahead
+
+private:
+    // Where a flight is headed and how many legs it has left
+    struct Itinerary
+    {
+        int destination;
+        int legsLeft;
+    };
+
+    std::deque<Airport> airports;           // Deque so the engines' pointers stay valid while we grow
+    SimTime lookahead;
+
+    // Filled before start(), then only read - each entry is changed by the airport holding its flight
+    std::unordered_map<const Aircraft*, Itinerary> itineraries;
+
+    std::atomic<unsigned long long> windows;
+    std::atomic<unsigned long long> handoffs;
+    std::atomic<unsigned long long> overflows;
+
+    // Any other airport, drawn from the aircraft's own stream
+    int pickDestination(const Aircraft* aircraft, int origin, int legsLeft) const;
+
+    // Called by an airport's engine when a flight there completes or times out
+    void flightFinished(int airport, Aircraft* aircraft, bool timedOut);
+
+    // Hand a flight in cruise to its destination (any airport's thread)
+    void handOff(int destination, const HandoffRing::Handoff& handoff);
+
+    // Queue every flight that reached this airport's ring as an arrival, 'now' being the window start
+    void deliver(Airport& airport, SimTime now);
+};
+
+#endif // AIRCONTROLX_AIRPORTNETWORK_H
@@ -0,0 +1,152 @@
+#ifndef AIRCONTROLX_ARRIVALPLANNER_H
+#define AIRCONTROLX_ARRIVALPLANNER_H
+
+#include <vector>
+#include "Common.h"
+#include "SimClock.h"
+#include "AircraftTable.h"
+#include "ServiceTimeModel.h"
+
+class Aircraft;
+
+/**
+ * ArrivalPlanner gives the queued arrivals future runway slots over a
+ * rolling horizon (the first getHorizon() flights in queue order).
+ *
+ * Each new flight is allocated to the runway whose planned sequence ends
+ * first and keeps that runway while it waits. Every runway's flights are
+ * then sequenced with constrained position shifting: a flight may land at
+ * most maxShift places before or after its queue position, and never
+ * ahead of a waiting flight with a higher static priority (emergency
+ * level and type), so nobody overtakes an emergency. Within those limits
+ * a dynamic program over (position, which flights of the window have
+ * landed) finds the order with the least total delay. The window has
+ * 2 * maxShift flights, so a runway costs O(n * C(2k, k) * k^2).
+ *
+ * Re-planning is incremental: the program only recomputes the positions
+ * that can see a flight that joined, left or changed place. Taking the
+ * first planned flight of a runway keeps the rest of its plan as is.
+ *
+ * Not thread safe - the scheduler guards it with its arrival mutex.
+ */
+class ArrivalPlanner
+{
+public:
+    static const int maxShiftLimit = 4;     // Window of 8 flights, 70 states per position
+
+    // One queued arrival, handed to plan() in queue order
+    struct Flight
+    {
+        AircraftHandle handle;
+        Aircraft* aircraft;
+        long long key;          // Queue key (priorityKey())
+        int priority;           // Static part of the key - who may not be overtaken
+        AirCraftType type;
+    };
+
+    // A planned runway slot
+    struct Slot
+    {
+        AircraftHandle handle;
+        Aircraft* aircraft;
+        int runway;             // RunwayManager index
+        SimTime start;          // When the flight gets the runway
+        SimTime service;        // How long it holds it (measured when it joined the plan)
+        int shift;              // Planned position minus queue position on its runway
+    };
+
+    explicit ArrivalPlanner(int maxShift = 3, size_t horizon = 500);
+
+    // Runways the plan may use (RunwayManager indices) - resets the plan
+    void setRunways(const std::vector<int>& runwayIndices);
+    const std::vector<int>& getRunways() const;
+
+    size_t getHorizon() const;
+    int getMaxShift() const;
+
+    /**
+     * Re-plan for the given arrivals (the head of the queue, in queue order).
+     * runwayFree holds when each runway of setRunways() is next free.
+     */
+    void plan(const std::vector<Flight>& queued, const std::vector<SimTime>& runwayFree,
+              const ServiceTimeModel& serviceModel);
+
+    // First planned flight of a runway (nullptr if it has none)
+    const Slot* next(int runwayIndex) const;
+
+    // Move the next flight of the busiest other runway to this one (nullptr if none has any)
+    const Slot* steal(int runwayIndex);
+
+    // The flight left the queue - taking the runway's next flight leaves the rest of its plan valid
+    void release(AircraftHandle handle);
+
+    // Planned slot of a flight - false if it is not in the plan
+    bool findSlot(AircraftHandle handle, Slot& slot) const;
+
+    // Every planned slot, runway by runway in landing order
+    std::vector<Slot> getSlots() const;
+
+    // Positions computed and reused by the incremental re-planning so far
+    unsigned long long getLayersComputed() const;
+    unsigned long long getLayersReused() const;
+
+private:
+    // A flight allocated to a runway, with the service time it was planned with
+    struct Member
+    {
+        Flight flight;
+        SimTime service;
+    };
+
+    // Best way to reach one state of a position
+    struct Cell
+    {
+        long long cost;         // Sum of start times so far, relative to the runway being free
+        unsigned char parent;   // State at the previous position
+        signed char choice;     // Window slot landed to get here (-1 = unreachable)
+    };
+
+    // Everything planned for one runway
+    struct Lane
+    {
+        int runway;
+        SimTime freeAt;
+        std::vector<Member> members;        // Queue order
+        std::vector<SimTime> prefix;        // prefix[i] = service of members [0, i)
+        std::vector<Cell> cells;            // (members + 1) positions x stateCount
+        size_t validLayers;                 // Positions [0, validLayers) are up to date
+        bool stale;                         // Plan no longer optimal - rebuild on next plan()
+        std::vector<Slot> sequence;         // Landing order
+        size_t head;                        // sequence[head] lands next
+    };
+
+    int shiftLimit;
+    size_t horizonSize;
+    std::vector<int> runways;
+    std::vector<Lane> lanes;
+
+    // States: masks of 2 * shiftLimit bits with shiftLimit bits set, one per position
+    std::vector<unsigned int> stateMasks;
+    std::vector<int> stateOf;           // State index by mask, -1 = not a state
+
+    std::vector<int> laneOf;            // Lane of each handle, -1 = not planned
+    std::vector<SimTime> serviceOf;     // Service time each planned handle was allocated with
+    std::vector<unsigned int> seenIn;   // Last plan() round that saw the handle
+    unsigned int round;
+
+    unsigned long long layersComputed;
+    unsigned long long layersReused;
+
+    int laneIndex(int runwayIndex) const;
+    void track(AircraftHandle handle);  // Grow the per-handle arrays to cover the handle
+
+    // Recompute the lane's positions from validLayers on and read the best sequence back
+    void solve(Lane& lane);
+    void extend(Lane& lane, size_t position);
+    void backtrack(Lane& lane);
+
+    // Start times of the lane's remaining sequence from its free time
+    void retime(Lane& lane);
+};
+
+#endif // AIRCONTROLX_ARRIVALPLANNER_H
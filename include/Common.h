@@ -12,6 +12,22 @@ enum class FlightState {Holding, Approach, Landing, Taxi, AtGate, TakeoffRoll, C
 // Enumeration for different runway types
 enum class RunwayType {Arrival, Departure, Flexible};
 
+// What a runway can handle - bits of RunwayClass::capabilities, and of what a flight needs
+enum RunwayCapability : unsigned
+{
+    RunwayArrivals    = 1u << 0,
+    RunwayDepartures  = 1u << 1,
+    RunwayCargo       = 1u << 2,
+    RunwayEmergencies = 1u << 3,
+    RunwayNorthSouth  = 1u << 4,
+    RunwayEastWest    = 1u << 5
+};
+static const int runwayCapabilityCount = 6;
+
+// A runway lease: (lease sequence << 32) | owning AircraftHandle - see RunwayClass::acquire()
+typedef unsigned long long RunwayLease;
+static const RunwayLease noRunwayLease = 0;
+
 // Enumeration for flight directions
 enum class Direction {North, South, East, West};
 
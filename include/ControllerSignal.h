@@ -0,0 +1,64 @@
+#ifndef AIRCONTROLX_CONTROLLERSIGNAL_H
+#define AIRCONTROLX_CONTROLLERSIGNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+/**
+ * ControllerSignal tells the ATC there is something to decide: a flight
+ * joined a queue, a runway was freed or an emergency was declared.
+ *
+ * The pending reasons are one atomic bitmask, so notify() from a flight is
+ * a fetch_or. Only the signal that finds nothing pending starts a batch:
+ * it stamps the batch start, calls the wake handler (the engine queues a
+ * controller event there) and wakes a thread blocked in wait(). Signals
+ * that come in before the controller calls take() join the same batch,
+ * and the controller handles them all with one assignment round.
+ *
+ * Any number of threads may notify; one controller takes.
+ */
+class ControllerSignal
+{
+public:
+    enum Reason : unsigned
+    {
+        QueueInsert = 1u << 0,
+        RunwayFreed = 1u << 1,
+        Emergency   = 1u << 2
+    };
+
+    ControllerSignal();
+
+    // Something for the controller to do (any thread)
+    void notify(Reason reason);
+
+    // Called by the notify() that starts a batch, on the notifying thread - set before use
+    void setWakeHandler(const std::function<void()>& handler);
+
+    // Take every pending reason (0 if none) and how long ago the batch started (wall ns)
+    unsigned take(long long& waitedNs);
+
+    // Block until something is pending or the timeout passes - true if something is
+    bool wait(std::chrono::microseconds timeout);
+
+    unsigned long long getSignalCount() const;
+    unsigned long long getBatchCount() const;
+
+private:
+    std::atomic<unsigned> pending;
+    std::atomic<long long> batchStartNs;        // Set by the notify() that found nothing pending
+    std::atomic<long long> lastTakeNs;
+    std::atomic<int> waiters;                   // Threads inside wait()
+    std::atomic<unsigned long long> signals;
+    std::atomic<unsigned long long> batches;
+    std::function<void()> wakeHandler;
+    std::mutex waitMutex;
+    std::condition_variable wakeUp;
+
+    static long long nowNs();
+};
+
+#endif // AIRCONTROLX_CONTROLLERSIGNAL_H
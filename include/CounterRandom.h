@@ -0,0 +1,44 @@
+#ifndef AIRCONTROLX_COUNTERRANDOM_H
+#define AIRCONTROLX_COUNTERRANDOM_H
+
+#include <string>
+#include <atomic>
+
+/**
+ * CounterRandom is the simulation's random number service.
+ * Instead of a shared generator state (like rand()), every number is a pure
+ * function of (seed, key, counter): the key names a stream (one per
+ * aircraft, or per subsystem) and the counter picks a position in it,
+ * usually derived from the simulated time.
+ *
+ * Nothing is shared except the seed, so threads never contend, and the same
+ * seed gives the same numbers no matter how many workers run or in which
+ * order they get there.
+ */
+class CounterRandom
+{
+private:
+    static std::atomic<unsigned long long> globalSeed;
+
+    // 64-bit finalizer (SplitMix64) - every input bit affects every output bit
+    static unsigned long long mix(unsigned long long value);
+
+public:
+    // Seed for the whole simulation (set before it starts)
+    static void setSeed(unsigned long long seed);
+    static unsigned long long getSeed();
+
+    // Stable stream key for a named entity, e.g. ("PIA", 12) for aircraft PIA-12
+    static unsigned long long keyFor(const std::string& name, long long index);
+
+    // Uniform 64-bit value at position 'counter' of stream 'key'
+    static unsigned long long at(unsigned long long key, unsigned long long counter);
+
+    // Uniform integer in [minValue, maxValue]
+    static int range(unsigned long long key, unsigned long long counter, int minValue, int maxValue);
+
+    // Uniform double in [0, 1)
+    static double unit(unsigned long long key, unsigned long long counter);
+};
+
+#endif // AIRCONTROLX_COUNTERRANDOM_H
@@ -0,0 +1,135 @@
+#ifndef AIRCONTROLX_FAIRQUEUE_H
+#define AIRCONTROLX_FAIRQUEUE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include "SimClock.h"
+#include "AircraftTable.h"
+#include "IndexedHeap.h"
+
+class Aircraft;
+
+/**
+ * AirlineRegistry numbers the airlines the scheduler has seen and holds
+ * their fair-share weight, their quota of flights on a runway at once and
+ * how many they have there right now. The counts are atomics, so both
+ * scheduler queues can check and change them under their own locks.
+ * An airline seen for the first time gets weight 1 and no quota.
+ */
+class AirlineRegistry
+{
+public:
+    static const int maxAirlines = 256;     // Airlines past this share the last entry
+
+    AirlineRegistry();
+
+    // Id of an airline, registering it if it is new
+    int idOf(const std::string& name);
+
+    // Weight (share of the runways) and quota (0 = none) of an airline
+    void setPolicy(const std::string& name, double weight, int maxConcurrent);
+
+    double getWeight(int id) const;
+    double getTotalWeight() const;
+    int getQuota(int id) const;
+    int getInService(int id) const;
+    bool atQuota(int id) const;
+    std::string getName(int id) const;
+    int size() const;
+
+    // A flight of the airline got a runway / gave it back
+    void startService(int id);
+    void endService(int id);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        std::atomic<double> weight;
+        std::atomic<int> maxConcurrent;
+        std::atomic<int> inService;
+    };
+
+    std::unique_ptr<Entry[]> entries;       // maxAirlines, allocated once so readers never see it move
+    std::atomic<int> count;
+    std::atomic<double> totalWeight;
+    std::unordered_map<std::string, int> ids;
+    mutable std::mutex registryMutex;       // Guards ids, names and policy changes
+};
+
+/**
+ * FairQueue is the weighted-fair-queueing layer of one scheduler queue.
+ *
+ * Every flight gets a virtual finish time when it is queued, VirtualClock
+ * style: its airline's clock moves to max(queue entry time, clock) plus
+ * the airline's spacing, the flow's runway time per flight times
+ * totalWeight / weight. An airline within its share finishes close to its
+ * entry times; one that floods the queue runs ahead of the clock and
+ * waits behind the others. The queue key becomes
+ * staticPriority() * 1000 - finish time, so emergencies and types still
+ * rank as before. Emergencies keep their entry time and are not metered.
+ *
+ * The queue's flights are mirrored into one IndexedHeap per airline, and
+ * a heap of airline heads picks the best airline in O(log airlines). An
+ * airline at its quota is parked out of that heap until one of its flights
+ * finishes, so top() never has to skip past its flights.
+ *
+ * Not thread safe - it lives next to a queue under the same mutex.
+ */
+class FairQueue
+{
+public:
+    explicit FairQueue(AirlineRegistry& airlineRegistry);
+
+    // Give a flight joining the queue its finish time (a flight queued again keeps it) and return its key
+    // spacingMs = runway time per flight of the whole flow
+    long long admit(const Aircraft* aircraft, SimTime spacingMs);
+
+    // Key of an admitted flight, e.g. after it declared an emergency
+    long long keyOf(const Aircraft* aircraft) const;
+
+    // Mirror the queue's push, remove and re-key
+    void push(Aircraft* aircraft, long long key);
+    void remove(AircraftHandle handle);
+    void update(AircraftHandle handle, long long key);
+
+    // Best queued flight of an airline under its quota (nullptr if there is none)
+    Aircraft* top();
+
+    // Whether the flight's airline has used up its quota
+    bool atQuota(AircraftHandle handle) const;
+
+    // The flight got a runway - it counts against its airline's quota until finished()
+    void served(AircraftHandle handle);
+
+    // The flight finished or gave up - frees its quota and forgets its finish time
+    void finished(AircraftHandle handle);
+
+private:
+    struct Entry
+    {
+        int airline;
+        SimTime finish;     // Virtual finish time
+        bool admitted;
+        bool inService;
+    };
+
+    AirlineRegistry& registry;
+    std::vector<Entry> entries;                             // By handle
+    std::vector<std::unique_ptr<IndexedHeap>> airlineQueues; // By airline id
+    std::vector<SimTime> virtualClock;                      // Finish time of each airline's latest flight
+    std::vector<char> parked;                               // Airline left out of 'heads' at its quota
+    std::vector<int> parkedAirlines;
+    IndexedHeap heads;      // One entry per airline with queued flights, handle = airline id
+
+    void grow(AircraftHandle handle, int airline);
+
+    // Put the airline's best flight back into 'heads' (or take it out)
+    void refresh(int airline);
+};
+
+#endif // AIRCONTROLX_FAIRQUEUE_H
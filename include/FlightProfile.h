@@ -0,0 +1,89 @@
+#ifndef AIRCONTROLX_FLIGHTPROFILE_H
+#define AIRCONTROLX_FLIGHTPROFILE_H
+
+#include <climits>
+#include "Common.h"
+
+// Speed rules of one flight phase (km/h)
+struct PhaseProfile
+{
+    int minAllowed;     // Speed envelope, reported with violations
+    int maxAllowed;
+    int lowerLimit;     // Violation below this (INT_MIN = only the upper limit is checked)
+    int upperLimit;     // Violation above this
+    int drawMin;        // UpdateSpeed picks a speed in [drawMin, drawMax]...
+    int drawMax;
+    int rampStep;       // ...unless this is non-zero: then it adds rampStep per update
+    int rampMin;        // and clamps the result to [rampMin, rampMax]
+    int rampMax;
+};
+
+// Phase whose speed is drawn from a range, checked against the envelope.
+// oneSided = only going over the envelope is a violation.
+constexpr PhaseProfile drawnPhase(int minAllowed, int maxAllowed, bool oneSided, int drawMin, int drawMax)
+{
+    return PhaseProfile{minAllowed, maxAllowed, oneSided ? INT_MIN : minAllowed, maxAllowed,
+                        drawMin, drawMax, 0, 0, 0};
+}
+
+// Phase whose speed ramps by step per update until it reaches rampMin / rampMax
+constexpr PhaseProfile rampedPhase(int minAllowed, int maxAllowed, bool oneSided, int step, int rampMin, int rampMax)
+{
+    return PhaseProfile{minAllowed, maxAllowed, oneSided ? INT_MIN : minAllowed, maxAllowed,
+                        0, 0, step, rampMin, rampMax};
+}
+
+/**
+ * FlightProfile holds the speed rules of every (AirCraftType, FlightState)
+ * pair in one compile-time table. Aircraft::UpdateSpeed, Aircraft::checkForViolation
+ * and the Radar all read it, so the envelope a plane flies and the one it is
+ * checked against can't drift apart. The kernels below are plain arithmetic
+ * on the table row (no switch on the phase), and a type-specific envelope is
+ * just a different row.
+ */
+struct FlightProfile
+{
+    static const int typeCount = 5;     // AirCraftType values
+    static const int phaseCount = 8;    // FlightState values
+
+    // Standard envelopes, in FlightState order
+    static constexpr PhaseProfile holding     = drawnPhase(400, 600, true, 400, 600);
+    static constexpr PhaseProfile approach    = drawnPhase(240, 290, false, 240, 290);
+    static constexpr PhaseProfile landing     = rampedPhase(30, 240, false, -20, 30, INT_MAX); // Decelerate to 30
+    static constexpr PhaseProfile taxi        = drawnPhase(15, 30, true, 15, 30);
+    static constexpr PhaseProfile atGate      = drawnPhase(0, 10, true, 0, 5);  // Drifts at 0-5, tolerated up to 10
+    static constexpr PhaseProfile takeoffRoll = rampedPhase(0, 290, true, 15, 0, 290);     // Accelerate to 290
+    static constexpr PhaseProfile climb       = drawnPhase(250, 463, true, 250, 463);
+    static constexpr PhaseProfile cruise      = drawnPhase(800, 900, false, 800, 900);
+
+    // [AirCraftType][FlightState] - every type flies the standard envelopes for now
+    static constexpr PhaseProfile table[typeCount][phaseCount] = {
+        {holding, approach, landing, taxi, atGate, takeoffRoll, climb, cruise},   // Commercial
+        {holding, approach, landing, taxi, atGate, takeoffRoll, climb, cruise},   // Cargo
+        {holding, approach, landing, taxi, atGate, takeoffRoll, climb, cruise},   // Emergency
+        {holding, approach, landing, taxi, atGate, takeoffRoll, climb, cruise},   // Military
+        {holding, approach, landing, taxi, atGate, takeoffRoll, climb, cruise}    // Medical
+    };
+
+    static const PhaseProfile& get(AirCraftType type, FlightState state)
+    {
+        return table[static_cast<int>(type)][static_cast<int>(state)];
+    }
+
+    // Speed after one update: the drawn value, or the current speed ramped and clamped
+    static int nextSpeed(const PhaseProfile& phase, int currentSpeed, int drawnSpeed)
+    {
+        long long ramped = static_cast<long long>(currentSpeed) + phase.rampStep;
+        ramped = ramped < phase.rampMin ? phase.rampMin : ramped;
+        ramped = ramped > phase.rampMax ? phase.rampMax : ramped;
+        int isRamp = (phase.rampStep != 0);
+        return static_cast<int>(isRamp * ramped + (1 - isRamp) * drawnSpeed);
+    }
+
+    static bool violates(const PhaseProfile& phase, int speed)
+    {
+        return (speed < phase.lowerLimit) | (speed > phase.upperLimit);
+    }
+};
+
+#endif // AIRCONTROLX_FLIGHTPROFILE_H
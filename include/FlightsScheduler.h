@@ -3,7 +3,20 @@
 
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <functional>
 #include "Aircraft.h"
+#include "AircraftTable.h"
+#include "IndexedHeap.h"
+#include "IntakeRing.h"
+#include "ServiceTimeModel.h"
+#include "ArrivalPlanner.h"
+#include "QueueTelemetry.h"
+#include "FairQueue.h"
+#include "SchedulerState.h"
+#include "Runway.h"
+
+class Airline;
 
 /**
  * FlightsScheduler class for managing flight schedules.
@@ -12,14 +25,7 @@
 class FlightsScheduler 
 {
 public:
-    // Using vectors instead of queues for more flexible management
-    std::vector<Aircraft*> arrivalQueue;    // Queue for arriving aircraft
-    std::vector<Aircraft*> departureQueue;  // Queue for departing aircraft
-    
-    // Mutexes to protect our queues during concurrent access
-    // These prevent data corruption when multiple threads try to modify the queues
-    std::mutex arrivalMutex;
-    std::mutex departureMutex;
+    static const int emergencyLevels = 3;   // Emergency buckets per queue (index = EmergencyNo - 1)
     
     // Constructor initializes empty queues
     FlightsScheduler();
@@ -28,31 +34,139 @@ public:
     void addArrival(Aircraft* aircraft);
     void addDeparture(Aircraft* aircraft);
     
+    // Variants that stay off the queue locks - the aircraft gets its table row, then waits in a
+    // lock-free intake ring until the next drainIntake() (addArrival/addDeparture if the ring is full)
+    void submitArrival(Aircraft* aircraft);
+    void submitDeparture(Aircraft* aircraft);
+    
+    // Move everything submitted so far into the queues, one lock per queue - returns how many
+    size_t drainIntake();
+    
+    // Submissions that found their ring full and took the locked path instead
+    unsigned long long getIntakeOverflows() const;
+    
     // Get next flights to be scheduled (highest priority first)
     Aircraft* getNextArrival();
     Aircraft* getNextDeparture();
     Aircraft* getNextEmergency() const; // Const version - just peeks at emergencies without removing
     Aircraft* removeNextEmergency();    // Non-const version - finds and removes highest priority emergency
     
-    // Sort queues by priority score
-    void sortQueues();
+    // The highest priority emergency (arrivals first) as its queue entry, for claimEmergency() -
+    // false if there is none
+    bool peekEmergency(IndexedHeap::Entry& out) const;
+    
+    // Take a queued flight out of its queue without untracking it - false if it wasn't queued
+    bool takeFromQueue(Aircraft* aircraft);
+    
+    // ======== Peek and claim ========
+    
+    // Which flights the caller could place right now - called with the queue mutex held,
+    // so it must not call back into the scheduler
+    typedef std::function<bool(const Aircraft&)> CandidateFilter;
+    
+    // The flights among the first 'window' of a queue, in the order they would come out, that
+    // 'accept' takes (airlines at their quota left out), at most 'limit' of them - returns how
+    // many. Nothing is taken or re-keyed, so the flights passed over keep their place and entry time.
+    size_t peekArrivals(size_t window, const CandidateFilter& accept, std::vector<IndexedHeap::Entry>& out,
+                        size_t limit = static_cast<size_t>(-1));
+    size_t peekDepartures(size_t window, const CandidateFilter& accept, std::vector<IndexedHeap::Entry>& out,
+                          size_t limit = static_cast<size_t>(-1));
+    
+    // Take one peeked flight out of its queue, leaving the rest as they are - false if it
+    // left its queue or was re-keyed since the peek
+    bool claim(const IndexedHeap::Entry& candidate);
+    
+    // Same for a peeked emergency, which doesn't wait for its airline's quota
+    bool claimEmergency(const IndexedHeap::Entry& candidate);
+    
+    // The top of each queue, left queued (nullptr if it is empty) - read under the queue's lock
+    Aircraft* peekTopArrival() const;
+    Aircraft* peekTopDeparture() const;
     
-    // Calculate estimated wait time for aircraft in queue
+    // Append every queued flight that 'accept' takes (all without a filter), arrivals
+    // first, each queue read under its lock
+    void collectQueued(const CandidateFilter& accept, std::vector<Aircraft*>& out) const;
+    
+    // The queues themselves, read-only and unlocked - for benchmarks and checks that know
+    // nothing is queuing or assigning meanwhile
+    const IndexedHeap& getArrivalQueue() const;
+    const IndexedHeap& getDepartureQueue() const;
+    
+    // Remove a flight from the queues and the active list (finished or timed out)
+    void removeFlight(Aircraft* aircraft);
+    
+    // Re-key a queued aircraft after its priority changed (e.g. it declared an emergency)
+    void updatePriority(const Aircraft* aircraft);
+    
+    // Calculate estimated wait time for aircraft in queue (minutes, -1 if not queued)
     int estimateWaitTime(Aircraft* aircraft);
     
-    // Schedule flights based on priority and timing
+    // Same in simulated milliseconds
+    SimTime estimateWaitMs(Aircraft* aircraft);
+    
+    // Runway service times behind the estimates (the engine records every released runway)
+    ServiceTimeModel& getServiceModel();
+    
+    // Counters and histograms of every enqueue and dequeue - readable any time, no lock needed
+    const QueueTelemetry& getTelemetry() const;
+    
+    // Re-plan the arrival runway slots for the head of the arrival queue (no-op without runways)
     void scheduleFlight();
     
+    // Runways the arrival plan sequences flights onto
+    void setArrivalRunways(const std::vector<RunwayClass*>& runways);
+    
+    // The next arrival planned for this runway, left in the queue for claim() - another runway's
+    // next flight if its own plan is empty, the first of the queue if the runway isn't planned
+    // at all. Only flights the filter accepts are picked: a planned flight it turns down leaves
+    // the plan but keeps its queue place, and without a plan the first accepted flight of the
+    // first 'window' in the queue is picked. False if there is none.
+    bool peekPlannedArrival(int runwayIndex, const CandidateFilter& accept, size_t window, IndexedHeap::Entry& out);
+    
+    // Slots from the last scheduleFlight() (arrival mutex held while planning)
+    ArrivalPlanner& getArrivalPlanner();
+    
+    // ======== Airline fairness ========
+    
+    // Order each queue by weighted-fair finish times and hold back airlines at their quota
+    // (see FairQueue) - off by default, switch it before flights are queued
+    void setFairScheduling(bool enabled);
+    bool isFairScheduling() const;
+    
+    // Share of the runways and flights-on-a-runway quota (0 = none) of one airline, or of
+    // every airline from its weight and maxFlights
+    void setAirlinePolicy(const std::string& airline, double weight, int maxConcurrent);
+    void setAirlinePolicies(const std::vector<Airline*>& airlines);
+    
+    // Weights, quotas and flights in service per airline
+    const AirlineRegistry& getAirlineRegistry() const;
+    
+    // ======== What-if evaluation ========
+    
+    // Keep persistent copies of both queues next to the heaps, so fork() doesn't copy them
+    void setPersistentQueues(bool enabled);
+    
+    // The queues and these runways as they are now, for trying out assignments without touching
+    // the scheduler - O(runways) with persistent queues, otherwise the queues are copied
+    SchedulerState fork(const std::vector<RunwayClass*>& runways);
+    
     // Get all currently active flights (both arrival and departure)
     const std::vector<Aircraft*>& getActiveFlights() const;
     
+    // Column store of the active flights - scans should use this instead of getActiveFlights()
+    AircraftTable& getAircraftTable();
+    const AircraftTable& getAircraftTable() const;
+    
+    // Refresh the aircraft's row after its fields changed - true if its emergency level changed
+    bool syncAircraft(const Aircraft* aircraft);
+    
     // ======== SFML Visualization Abstraction Functions ========
     
     /**
      * Get queue statistics for visualization
-     * Returns array with [total active, arrivals, departures, emergency]
+     * Fills stats with [total active, arrivals, departures, emergency]
      */
-    int* getQueueStatistics() const;
+    void getQueueStatistics(int stats[4]) const;
     
     /**
      * Get all active emergency aircraft
@@ -91,8 +205,79 @@ public:
     std::string getStatusSummary() const;
     
 private:
-    // Vector to track all active flights
+    // Indexed heaps keyed by table handle - O(log n) push, pop, remove and re-prioritize
+    IndexedHeap arrivalQueue;    // Queue for arriving aircraft
+    IndexedHeap departureQueue;  // Queue for departing aircraft
+    
+    // The emergencies of each queue again, one heap per level (index = EmergencyNo - 1),
+    // so the next emergency is the best of three heap tops instead of a queue scan
+    IndexedHeap arrivalEmergencies[emergencyLevels];
+    IndexedHeap departureEmergencies[emergencyLevels];
+    
+    // Mutexes to protect our queues during concurrent access (arrivals first when both are
+    // taken) - mutable so the const peeks can lock them
+    mutable std::mutex arrivalMutex;
+    mutable std::mutex departureMutex;
+    
+    // Vector to track all active flights (unordered - removal swaps the last one in)
     std::vector<Aircraft*> activeFlights;
+    
+    // Index of each flight in activeFlights by table handle (-1 = not tracked)
+    std::vector<int> activeSlots;
+    
+    // Hot fields of the same flights, one row each
+    AircraftTable aircraftTable;
+    
+    // Measured runway service times for the wait estimates
+    ServiceTimeModel serviceModel;
+    
+    // Queue counters and histograms, updated by enqueue() and dequeue()
+    QueueTelemetry telemetry;
+    
+    // Runway slots for the queued arrivals (guarded by arrivalMutex)
+    ArrivalPlanner arrivalPlanner;
+    std::vector<RunwayClass*> plannedRunways;
+    std::vector<IndexedHeap::Entry> planEntries;        // Reused buffers for scheduleFlight()
+    std::vector<ArrivalPlanner::Flight> planFlights;
+    std::vector<SimTime> planRunwayFree;
+    
+    // Airline shares and quotas, and the fair order of each queue (each guarded by its queue's mutex)
+    AirlineRegistry airlineRegistry;
+    FairQueue arrivalFairness;
+    FairQueue departureFairness;
+    bool fairScheduling;
+    
+    // Guards activeFlights and the table rows (arrivals and departures add concurrently)
+    std::mutex activeMutex;
+    
+    // Submitted but not yet queued flights; intakeMutex makes drainIntake() the single consumer
+    IntakeRing arrivalIntake;
+    IntakeRing departureIntake;
+    std::mutex intakeMutex;
+    std::vector<Aircraft*> intakeBatch;     // Reused drain buffer (intakeMutex held)
+    std::atomic<unsigned long long> intakeOverflows;
+    
+    // Add the aircraft to activeFlights and the table unless it is already there
+    void trackFlight(Aircraft* aircraft);
+    
+    // Keep a queue and its emergency buckets in step (caller holds the queue's mutex)
+    static int emergencyBucket(int emergencyLevel);
+    void enqueue(IndexedHeap& queue, IndexedHeap* buckets, Aircraft* aircraft);
+    bool dequeue(IndexedHeap& queue, IndexedHeap* buckets, AircraftHandle handle, bool served = true);
+    bool requeue(IndexedHeap& queue, IndexedHeap* buckets, const Aircraft* aircraft);
+    static Aircraft* topEmergency(const IndexedHeap* buckets);
+    static bool peekEmergencyOf(const IndexedHeap& queue, const IndexedHeap* buckets, IndexedHeap::Entry& out);
+    
+    // The fair layer of a queue, nullptr while fair scheduling is off
+    FairQueue* fairnessOf(const IndexedHeap& queue);
+    
+    // Best flight of a queue - its top, or the fair layer's pick (nullptr if none)
+    Aircraft* nextOf(IndexedHeap& queue);
+    
+    // Peek and claim on one queue (caller holds the queue's mutex)
+    size_t peek(IndexedHeap& queue, size_t window, const CandidateFilter& accept, std::vector<IndexedHeap::Entry>& out,
+                size_t limit);
+    bool claimFrom(IndexedHeap& queue, IndexedHeap* buckets, const IndexedHeap::Entry& candidate, bool keepQuota = true);
 };
 
 #endif // AIRCONTROLX_FLIGHTSSCHEDULER_H
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef AIRCONTROLX_HANDOFFRING_H
+#define AIRCONTROLX_HANDOFFRING_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include "SimClock.h"
+
+class Aircraft;
+
+/**
+ * HandoffRing carries flights from the airports of an AirportNetwork to one
+ * destination airport: a departure that reached cruise at one shard is
+ * pushed here by that shard's thread, and the network drains it into the
+ * destination's engine between two time windows.
+ *
+ * Bounded lock-free multi-producer / single-consumer, with the same
+ * per-slot sequence numbers as IntakeRing: a producer claims a slot with
+ * one compare-and-swap on the tail, the consumer hands it back one lap
+ * later. A full ring makes push() return false.
+ *
+ * Only one thread may call drain() at a time.
+ */
+class HandoffRing
+{
+public:
+    // A flight on its way to another airport
+    struct Handoff
+    {
+        Aircraft* aircraft;
+        int origin;             // Airport it left
+        SimTime arrivalTime;    // Simulated time it reaches the destination
+    };
+
+    // Capacity is rounded up to a power of two
+    explicit HandoffRing(size_t capacity = 1024);
+
+    // Producer side (any thread) - false if the ring is full
+    bool push(const Handoff& handoff);
+
+    // Consumer side - append everything pushed so far to 'out' in push order, return how many
+    size_t drain(std::vector<Handoff>& out);
+
+    size_t capacity() const;
+    size_t sizeApprox() const;  // Exact only when nobody is pushing or draining
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;   // == position: free for a producer, == position + 1: filled
+        Handoff handoff;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    // Producers and consumer write different cache lines
+    alignas(64) std::atomic<size_t> tail;   // Next position a producer claims
+    alignas(64) std::atomic<size_t> head;   // Next position the consumer reads (consumer only writes)
+};
+
+#endif // AIRCONTROLX_HANDOFFRING_H
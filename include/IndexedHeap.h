@@ -0,0 +1,116 @@
+#ifndef AIRCONTROLX_INDEXEDHEAP_H
+#define AIRCONTROLX_INDEXEDHEAP_H
+
+#include <functional>
+#include <vector>
+#include "AircraftTable.h"
+#include "RankIndex.h"
+#include "PersistentQueue.h"
+
+class Aircraft;
+
+/**
+ * IndexedHeap is a 4-ary max-heap of queued aircraft keyed by their
+ * AircraftTable handle. Next to the heap array it keeps each handle's
+ * position, so besides push and pop it can remove any aircraft or change
+ * its priority in O(log n) instead of searching and re-sorting a vector.
+ *
+ * Higher keys come out first; equal keys come out in push order.
+ * With rank tracking on, a RankIndex mirrors the entries so rankOf() is
+ * O(log n) too (at the cost of a treap update per change). With
+ * persistence on, a PersistentQueue mirrors them as well, so snapshot()
+ * is a pointer copy instead of a copy of the queue.
+ * Not thread safe - the scheduler guards each queue with its own mutex.
+ */
+class IndexedHeap
+{
+public:
+    static const size_t arity = 4;  // Children per node - shallow tree, children share cache lines
+
+    // One queued aircraft
+    struct Entry
+    {
+        long long key;                  // Priority (higher first)
+        unsigned long long sequence;    // Push order, breaks ties
+        AircraftHandle handle;
+        Aircraft* aircraft;
+    };
+
+    explicit IndexedHeap(bool trackRanks = false);
+
+    // Add an aircraft - false if its handle is invalid or already queued
+    bool push(Aircraft* aircraft, AircraftHandle handle, long long key);
+
+    // Same with the tie-breaking sequence given - for a heap that keeps another heap's order
+    bool push(Aircraft* aircraft, AircraftHandle handle, long long key, unsigned long long sequence);
+
+    // Highest priority aircraft (nullptr if empty)
+    Aircraft* top() const;
+    long long topKey() const;
+    AircraftHandle topHandle() const;   // invalidAircraftHandle if empty
+
+    // Remove and return the highest priority aircraft (nullptr if empty)
+    Aircraft* pop();
+
+    // Remove an aircraft wherever it is - false if it was not queued
+    bool remove(AircraftHandle handle);
+
+    // Give a queued aircraft a new key, moving it up or down - false if not queued
+    bool update(AircraftHandle handle, long long key);
+
+    bool contains(AircraftHandle handle) const;
+
+    // The queued entry of an aircraft (nullptr if not queued) - valid until the next change
+    const Entry* find(AircraftHandle handle) const;
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    // How many aircraft come out before this one (-1 if not queued) -
+    // O(log n) with rank tracking, otherwise a scan
+    int rankOf(AircraftHandle handle) const;
+
+    // The entries in heap order (not sorted) for scans
+    const std::vector<Entry>& entries() const;
+
+    // The first 'count' entries in pop order, without popping them -
+    // a best-first walk of the heap, O(count log count) whatever the size
+    void topEntries(size_t count, std::vector<Entry>& out) const;
+
+    // The same walk, handing each entry to 'visit' until it returns false - how many it saw
+    size_t walkTop(size_t count, const std::function<bool(const Entry&)>& visit) const;
+
+    // Keep a PersistentQueue in step with the heap (O(log n) node copies per change)
+    void setPersistent(bool enabled);
+    bool isPersistent() const;
+
+    // The queue as it is now, unaffected by later changes - O(1) with persistence on,
+    // otherwise built from the entries in O(n log n)
+    PersistentQueue snapshot() const;
+
+private:
+    std::vector<Entry> heap;
+    std::vector<int> positions;         // Heap index by handle, -1 = not queued
+    unsigned long long nextSequence;
+    bool ranked;                        // Keep 'ranks' in step with the heap
+    RankIndex ranks;
+    bool persistent;                    // Keep 'mirror' in step with the heap
+    PersistentQueue mirror;
+    mutable std::vector<size_t> frontier;  // walkTop() scratch (callers serialize access)
+
+    static PersistentQueue::Entry mirrorEntry(const Entry& entry);
+
+    // True if a comes out before b
+    static bool before(const Entry& a, const Entry& b)
+    {
+        if (a.key != b.key) return a.key > b.key;
+        return a.sequence < b.sequence;
+    }
+
+    void place(size_t index, const Entry& entry);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void removeAt(size_t index);
+};
+
+#endif // AIRCONTROLX_INDEXEDHEAP_H
@@ -0,0 +1,53 @@
+#ifndef AIRCONTROLX_INTAKERING_H
+#define AIRCONTROLX_INTAKERING_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+
+class Aircraft;
+
+/**
+ * IntakeRing is a bounded lock-free multi-producer / single-consumer queue
+ * of aircraft waiting to enter a scheduler queue.
+ *
+ * Every slot carries a sequence number that says whose turn it is: a
+ * producer claims a slot with one compare-and-swap on the tail, writes the
+ * aircraft and hands the slot to the consumer by bumping its sequence; the
+ * consumer takes it and hands it back to the producers one lap later.
+ * Producers never wait for each other or for the consumer - a full ring
+ * just makes push() return false.
+ *
+ * Only one thread may call drain() at a time.
+ */
+class IntakeRing
+{
+public:
+    // Capacity is rounded up to a power of two
+    explicit IntakeRing(size_t capacity = 4096);
+
+    // Producer side (any thread) - false if the ring is full
+    bool push(Aircraft* aircraft);
+
+    // Consumer side - move up to maxCount aircraft into 'out' in push order, return how many
+    size_t drain(std::vector<Aircraft*>& out, size_t maxCount = static_cast<size_t>(-1));
+
+    size_t capacity() const;
+    size_t sizeApprox() const;  // Exact only when nobody is pushing or draining
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;   // == position: free for a producer, == position + 1: filled
+        Aircraft* aircraft;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    // Producers and consumer write different cache lines
+    alignas(64) std::atomic<size_t> tail;   // Next position a producer claims
+    alignas(64) std::atomic<size_t> head;   // Next position the consumer reads (consumer only writes)
+};
+
+#endif // AIRCONTROLX_INTAKERING_H
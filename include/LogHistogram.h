@@ -0,0 +1,63 @@
+#ifndef AIRCONTROLX_LOGHISTOGRAM_H
+#define AIRCONTROLX_LOGHISTOGRAM_H
+
+#include <atomic>
+#include <vector>
+
+/**
+ * LogHistogram counts non-negative values in HDR-style log-linear buckets:
+ * every power of two is split into 16 equal sub-buckets, so any value
+ * from 0 to 2^63 lands in a bucket at most 1/16 (6.25%) wider than
+ * itself, in a fixed array of 976 counters.
+ *
+ * record() is one relaxed atomic increment of its bucket, plus the
+ * running sum and, when it grows, the max. Any number of threads can
+ * record while others read. A reader copies the counters into a
+ * Snapshot and works out percentiles from that; it may see a record
+ * half applied, never a torn counter.
+ */
+class LogHistogram
+{
+public:
+    static const int subBucketBits = 4;
+    static const int subBucketCount = 1 << subBucketBits;
+    static const int bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    // Counters copied out at one moment
+    struct Snapshot
+    {
+        std::vector<unsigned long long> counts;     // Per bucket
+        unsigned long long count;
+        unsigned long long sum;
+        unsigned long long max;
+
+        Snapshot();
+
+        // Add another histogram's counts (e.g. to combine aircraft types)
+        void merge(const Snapshot& other);
+
+        double mean() const;
+
+        // Smallest bucket value with at least p (0..1) of the values at or below it
+        unsigned long long percentile(double p) const;
+    };
+
+    LogHistogram();
+
+    // Count one value (negative values count as 0)
+    void record(long long value);
+
+    Snapshot snapshot() const;
+    void reset();
+
+    // Bucket of a value, and the middle of a bucket's value range
+    static int bucketOf(unsigned long long value);
+    static unsigned long long bucketValue(int bucket);
+
+private:
+    std::atomic<unsigned long long> counts[bucketCount];
+    std::atomic<unsigned long long> sum;
+    std::atomic<unsigned long long> max;
+};
+
+#endif // AIRCONTROLX_LOGHISTOGRAM_H
@@ -0,0 +1,96 @@
+#ifndef AIRCONTROLX_PERSISTENTQUEUE_H
+#define AIRCONTROLX_PERSISTENTQUEUE_H
+
+#include <vector>
+#include <memory>
+#include "Common.h"
+#include "SimClock.h"
+#include "AircraftTable.h"
+
+class Aircraft;
+
+/**
+ * PersistentQueue is a queue of aircraft entries in IndexedHeap order
+ * (higher key first, then lower sequence) whose nodes are never changed
+ * once built. An insert or erase copies only the O(log n) nodes on its
+ * path and shares the rest, so copying a PersistentQueue is one pointer
+ * copy and every copy keeps seeing the queue as it was when it was made.
+ *
+ * It is a treap (priorities from CounterRandom, like RankIndex) with
+ * reference-counted nodes. One copy must not be changed from two threads
+ * at once, but different copies can be used on different threads.
+ */
+class PersistentQueue
+{
+public:
+    // One queued aircraft, with what a what-if evaluation needs of it
+    struct Entry
+    {
+        long long key;                  // Priority (higher first)
+        unsigned long long sequence;    // Push order, breaks ties
+        AircraftHandle handle;
+        Aircraft* aircraft;             // Only for identification - may be gone by the time a copy is read
+        SimTime entryTime;              // queueEntryTime when it was queued
+        AirCraftType type;
+    };
+
+    PersistentQueue();
+
+    // Add an entry - O(log n) new nodes
+    void insert(const Entry& entry);
+
+    // Remove the entry with this key, sequence and handle - false if it isn't here
+    bool erase(const Entry& entry);
+
+    // First entry in queue order (nullptr if empty), and removing it
+    const Entry* top() const;
+    bool pop();
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    // Entries ordered before this one (-1 if it isn't here)
+    int rankOf(const Entry& entry) const;
+
+    // The first 'count' entries in queue order - O(log n + count), nothing is copied
+    void topEntries(size_t count, std::vector<Entry>& out) const;
+
+private:
+    struct Node;
+    typedef std::shared_ptr<const Node> NodePtr;
+
+    struct Node
+    {
+        Entry entry;
+        unsigned long long priority;    // Heap order of the treap (random)
+        size_t size;                    // Nodes in this subtree
+        NodePtr left, right;
+    };
+
+    NodePtr root;
+    unsigned long long priorityKey;     // CounterRandom stream for node priorities
+
+    // True if a comes out before b (same order as IndexedHeap)
+    static bool before(const Entry& a, const Entry& b)
+    {
+        if (a.key != b.key) return a.key > b.key;
+        return a.sequence < b.sequence;
+    }
+
+    static size_t sizeOf(const NodePtr& node) { return node ? node->size : 0; }
+
+    // A copy of node with new children
+    static NodePtr rebuild(const Node& node, const NodePtr& left, const NodePtr& right);
+
+    static NodePtr insertInto(const NodePtr& tree, const NodePtr& fresh);
+    static NodePtr eraseFrom(const NodePtr& tree, const Entry& entry, bool& found);
+
+    // Split tree into the nodes before 'pivot' and the rest
+    static void split(const NodePtr& tree, const Entry& pivot, NodePtr& beforePart, NodePtr& restPart);
+
+    // Join two trees where every node of a comes before every node of b
+    static NodePtr merge(const NodePtr& a, const NodePtr& b);
+};
+
+#endif // AIRCONTROLX_PERSISTENTQUEUE_H
@@ -0,0 +1,80 @@
+#ifndef AIRCONTROLX_QUEUETELEMETRY_H
+#define AIRCONTROLX_QUEUETELEMETRY_H
+
+#include <atomic>
+#include <string>
+#include "Common.h"
+#include "SimClock.h"
+#include "LogHistogram.h"
+
+/**
+ * QueueTelemetry counts what goes through the scheduler queues, split by
+ * flow (arrivals, departures) and aircraft type: flights queued, served
+ * (taken for a runway) and removed (finished or timed out while queued),
+ * the current depth, a histogram of the queue depth seen at every change
+ * and a histogram of how long flights waited in the queue.
+ *
+ * Every counter is an atomic and every histogram a LogHistogram, so the
+ * scheduler records on each enqueue and dequeue without another lock and
+ * readers never stop it. The counters are read one by one, so a reader
+ * may see a change that is only half counted.
+ */
+class QueueTelemetry
+{
+public:
+    enum Flow {Arrivals, Departures};
+    static const int flowCount = 2;
+    static const int typeCount = 5;     // AirCraftType values
+
+    // One flow and type (or a whole flow) at the moment it was read
+    struct Stats
+    {
+        unsigned long long enqueued;
+        unsigned long long served;
+        unsigned long long removed;
+        long long depth;                    // Queued right now
+        LogHistogram::Snapshot waitMs;      // Time in queue of the served flights
+    };
+
+    QueueTelemetry();
+
+    // A flight of this type joined the flow's queue
+    void recordEnqueue(Flow flow, AirCraftType type);
+
+    // A flight left the queue after waitedMs - served = taken for a runway, else removed
+    void recordDequeue(Flow flow, AirCraftType type, SimTime waitedMs, bool served);
+
+    // Counters and wait histogram of one type, or of every type of the flow
+    Stats getStats(Flow flow, AirCraftType type) const;
+    Stats getStats(Flow flow) const;
+
+    // Queue depth right now, and the depths seen after every change
+    long long getDepth(Flow flow) const;
+    LogHistogram::Snapshot getDepthHistogram(Flow flow) const;
+
+    // Summary per flow and type (counts, depth and wait percentiles)
+    std::string getReport() const;
+
+    void reset();
+
+private:
+    struct TypeCounters
+    {
+        std::atomic<unsigned long long> enqueued;
+        std::atomic<unsigned long long> served;
+        std::atomic<unsigned long long> removed;
+        std::atomic<long long> depth;
+        LogHistogram waitMs;
+    };
+
+    struct FlowCounters
+    {
+        TypeCounters types[typeCount];
+        std::atomic<long long> depth;
+        LogHistogram depthSeen;
+    };
+
+    FlowCounters flows[flowCount];
+};
+
+#endif // AIRCONTROLX_QUEUETELEMETRY_H
@@ -2,6 +2,7 @@
 #define AIRCONTROLX_RADAR_H
 
 #include "Aircraft.h"
+#include "AircraftTable.h"
 #include <vector>
 #include <string>
 
@@ -36,16 +37,21 @@ public:
     // Returns vector of aircraft pointers that have violations with their allowed speed ranges
     std::vector<ViolationInfo> detectViolations(const std::vector<Aircraft*>& aircraft);
     
+    // Same check as a sweep over the table's flag, state and speed columns
+    std::vector<ViolationInfo> detectViolations(const AircraftTable& table);
+    
     // Handle violations by sending them to the AVN Generator
     void handleViolations(const std::vector<Aircraft*>& activeFlights);
+    void handleViolations(AircraftTable& table);
     
     // Get speed limits for a given flight state
     // Returns min and max allowed speed as a pair
     std::pair<int, int> getSpeedLimits(FlightState state);
+    std::pair<int, int> getSpeedLimits(AirCraftType type, FlightState state);
     
-    // Check if aircraft speed violates limits
+    // Check if aircraft speed violates the limits of its type and state (see FlightProfile)
     // Returns true if violation detected, false otherwise
-    bool checkSpeedViolation(const Aircraft& aircraft, int minAllowed, int maxAllowed);
+    bool checkSpeedViolation(const Aircraft& aircraft);
     
     // Simulate a violation for testing purposes
     void simulateViolation(const std::string& flightNumber, const std::string& airline, 
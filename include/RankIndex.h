@@ -0,0 +1,70 @@
+#ifndef AIRCONTROLX_RANKINDEX_H
+#define AIRCONTROLX_RANKINDEX_H
+
+#include <vector>
+#include "AircraftTable.h"
+
+/**
+ * RankIndex is an order-statistic treap over the entries of a queue,
+ * ordered like IndexedHeap (higher key first, then lower sequence).
+ * Every node knows the size of its subtree, so the rank of an aircraft
+ * (how many entries come out before it) is one walk from the root:
+ * O(log n) instead of scanning the queue.
+ *
+ * Nodes are addressed by aircraft handle and kept in one array; tree
+ * priorities come from CounterRandom, so the shape is the same every run.
+ * Not thread safe - it lives inside a queue guarded by the scheduler.
+ */
+class RankIndex
+{
+public:
+    RankIndex();
+
+    // Add an entry - false if the handle is invalid or already present
+    bool insert(AircraftHandle handle, long long key, unsigned long long sequence);
+
+    // Remove an entry - false if it was not present
+    bool erase(AircraftHandle handle);
+
+    // Entries ordered before this one (-1 if not present)
+    int rank(AircraftHandle handle) const;
+
+    bool contains(AircraftHandle handle) const;
+    size_t size() const;
+    void clear();
+
+private:
+    struct Node
+    {
+        long long key;
+        unsigned long long sequence;
+        unsigned long long priority;    // Heap order of the treap (random)
+        int left, right;                // Node indices, -1 = none
+        int size;                       // Nodes in this subtree
+        AircraftHandle handle;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    std::vector<int> nodeOf;            // Node index by handle, -1 = not present
+    int root;
+    unsigned long long priorityKey;     // CounterRandom stream for node priorities
+
+    // True if node a comes out before node b (same order as IndexedHeap)
+    bool before(int a, int b) const
+    {
+        if (nodes[a].key != nodes[b].key) return nodes[a].key > nodes[b].key;
+        return nodes[a].sequence < nodes[b].sequence;
+    }
+
+    int sizeOf(int node) const { return node < 0 ? 0 : nodes[node].size; }
+    void resize(int node);
+
+    // Split tree into the nodes before 'pivot' and the rest
+    void split(int tree, int pivot, int& beforePart, int& restPart);
+
+    // Join two trees where every node of a comes before every node of b
+    int merge(int a, int b);
+};
+
+#endif // AIRCONTROLX_RANKINDEX_H
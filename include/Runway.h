@@ -2,19 +2,30 @@
 #define AIRCONTROLX_RUNWAY_H
 
 #include <string>
+#include <atomic>
 #include "Common.h"
+#include "SimClock.h"
 #include "Aircraft.h"
 
 /**
  * RunwayClass handles runway operations at the airport.
  * Manages runway availability, assignment to aircraft, and tracking usage.
+ *
+ * A runway is held through a lease: one atomic word with the owning
+ * aircraft's handle and a per-runway sequence number, taken with a CAS
+ * and given back only by whoever holds that exact lease. A flight that
+ * lost its runway (its lease ran out and the runway went to someone else)
+ * can't free the new holder's runway, and a flight that never comes back
+ * pins the runway only until its lease expires.
  */
 class RunwayClass {
 public:
+    static const SimTime defaultLeaseMs = 60000;    // Longest hold before the runway can be taken back
+
     std::string id;        // Runway identifier (e.g., RWY-A)
     RunwayType type;       // Type of runway (Arrival, Departure, Flexible)
-    bool isOccupied;       // Flag for runway occupancy status
-    int turn;              // Variable for synchronization between aircraft
+    int index;             // Position in the RunwayManager (-1 if not managed)
+    unsigned capabilities; // RunwayCapability bits - the type's defaults unless changed
 
     // Constructor
     RunwayClass();
@@ -22,12 +33,41 @@ public:
     //Constructor with Arguments
     RunwayClass(std::string run, RunwayType Inputtype, bool occupied);
 
-    // Try to assign runway to aircraft
-    bool tryAssign(Aircraft &plane);
-    
-    // Release the runway after use
-    void release();
+    // Copies the current lease - for setting up runway lists, not for runways in use
+    RunwayClass(const RunwayClass& other);
+    RunwayClass& operator=(const RunwayClass& other);
 
+    // Try to assign runway to aircraft: takes a lease for it (plane.runwayLease) and
+    // records this runway's index in plane.assignedRunway
+    bool tryAssign(Aircraft &plane, SimTime leaseMs = defaultLeaseMs);
+    
+    // Lease the runway to 'owner' until now + leaseMs - noRunwayLease if someone else holds
+    // a lease that hasn't expired. An expired lease is taken over.
+    RunwayLease acquire(AircraftHandle owner, SimTime now, SimTime leaseMs);
+    
+    // Give the runway back - false (and nothing changes) if 'lease' isn't the current one
+    bool release(RunwayLease lease);
+    
+    // Whether a lease that hasn't expired holds the runway (at 'now', or on the SimClock)
+    bool isOccupied() const;
+    bool isOccupied(SimTime now) const;
+    
+    // The current lease (noRunwayLease if free) and whose it is
+    RunwayLease getLease() const;
+    SimTime getLeaseExpiry() const;
+    static AircraftHandle ownerOf(RunwayLease lease);
+    
+    // Whether the runway has every capability the aircraft needs
+    bool canServe(const Aircraft& plane) const;
+    
+    // Capabilities of a runway of this type: its flow and direction (both for flexible
+    // runways) and emergencies - cargo only for flexible runways
+    static unsigned defaultCapabilities(RunwayType type);
+    
+    // What an aircraft needs: N/S flights arrive and E/W flights depart, plus emergencies,
+    // or cargo for cargo flights that aren't emergencies
+    static unsigned requirementsOf(const Aircraft& plane);
+    
     // ======== SFML Visualization Abstraction Functions ========
     
     /**
@@ -59,6 +99,11 @@ public:
      * Returns a human-readable version of the runway type
      */
     std::string getTypeString() const;
+
+private:
+    std::atomic<RunwayLease> lease;        // Current lease, noRunwayLease when free
+    std::atomic<SimTime> leaseExpiry;      // When the current lease stops counting
+    std::atomic<unsigned> leaseSequence;   // Last lease sequence handed out
 };
 
 #endif // AIRCONTROLX_RUNWAY_H
\ No newline at end of file
@@ -21,7 +21,8 @@ public:
     ~RunwayManager();
     
     // Initialize runways with their configurations
-    void initialize();
+    // The first three are always RWY-A/B/C; extra runways cycle through the same types
+    void initialize(int runwayCount = 3);
     
     // Get a runway by index (0-based)
     RunwayClass* getRunwayByIndex(int index);
@@ -0,0 +1,56 @@
+#ifndef AIRCONTROLX_RUNWAYMATCHER_H
+#define AIRCONTROLX_RUNWAYMATCHER_H
+
+#include <vector>
+#include "Common.h"
+#include "Runway.h"
+
+/**
+ * RunwayMatcher hands free runways to flights by capability for one
+ * assignment round of the ATC.
+ *
+ * Free runways are kept in one bucket per capability mask (64 masks for
+ * the 6 RunwayCapability bits). For every possible requirement the masks
+ * that cover it are listed once, fewest extra capabilities first, so a
+ * claim looks at no more than 64 buckets however many runways there are,
+ * and a flight gets the most specialised runway that fits - flexible
+ * runways stay free for the flights only they can take.
+ *
+ * Not thread safe - the ATC uses it under its controller mutex.
+ */
+class RunwayMatcher
+{
+public:
+    static const int maskCount = 1 << runwayCapabilityCount;
+
+    RunwayMatcher();
+
+    // The runways to match against (kept until the next call)
+    void setRunways(const std::vector<RunwayClass*>& runways);
+
+    // Re-read which runways are free - call at the start of a round
+    void refresh();
+
+    // Best-fitting free runway with every capability in 'requirements' (the preferred
+    // runway if it is free and fits), taken out of the free set - nullptr if none fits
+    RunwayClass* claim(unsigned requirements, int preferredIndex = -1);
+
+    // The runway claim() would hand out, left free (nullptr if none fits)
+    RunwayClass* peek(unsigned requirements) const;
+
+    size_t getFreeCount() const;
+    const std::vector<RunwayClass*>& getRunways() const;
+
+private:
+    std::vector<RunwayClass*> runways;
+    std::vector<int> positionOf;                // Slot in its bucket by runway position, -1 = not free
+    std::vector<int> runwayOf;                  // Runway position by RunwayClass::index
+    std::vector<std::vector<int>> freeByMask;   // Free runway positions by capability mask
+    std::vector<std::vector<unsigned>> fitting; // Masks covering each requirement, best fit first
+    size_t freeCount;
+
+    int find(unsigned requirements) const;     // Runway position, -1 if none fits
+    void take(int position);
+};
+
+#endif // AIRCONTROLX_RUNWAYMATCHER_H
@@ -0,0 +1,95 @@
+#ifndef AIRCONTROLX_SCHEDULERSTATE_H
+#define AIRCONTROLX_SCHEDULERSTATE_H
+
+#include <vector>
+#include <memory>
+#include "Common.h"
+#include "SimClock.h"
+#include "PersistentQueue.h"
+
+/**
+ * SchedulerState is a forked copy of the scheduler queues and runways for
+ * trying out assignments ("what if RWY-C takes the cargo departure now?")
+ * without touching the live scheduler.
+ *
+ * The queues are PersistentQueues, so forking a state - from
+ * FlightsScheduler::fork() or from another state - copies two pointers
+ * and the few runways, and every branch shares the queue nodes it hasn't
+ * changed. An assignment takes the flight out of its queue (O(log n) new
+ * nodes) and puts it on the runway at the earliest time the runway is
+ * free, one measured service time after the flight before it.
+ *
+ * score() is the delay (runway start - queue entry) of the assignments
+ * made so far plus a greedy projection of the flights still queued, so two
+ * branches can be compared by the total delay they lead to.
+ */
+class SchedulerState
+{
+public:
+    // A runway as the fork saw it
+    struct Runway
+    {
+        int index;                  // RunwayClass::index
+        RunwayType type;            // Arrival, Departure or Flexible (both flows)
+        SimTime freeAt;             // When it can take its next flight
+        SimTime serviceMs[5];       // Measured service time by AirCraftType
+    };
+
+    // One hypothetical assignment
+    struct Assignment
+    {
+        PersistentQueue::Entry flight;
+        int runway;                 // RunwayClass::index
+        bool arrival;
+        SimTime start;
+    };
+
+    SchedulerState();
+    SchedulerState(const PersistentQueue& arrivals, const PersistentQueue& departures,
+                   const std::vector<Runway>& runways, SimTime now);
+
+    // Another branch from here - O(runways), the queues are shared
+    SchedulerState fork() const;
+
+    // Put a queued flight on a runway - false if it isn't queued here or the runway doesn't take its flow
+    bool assign(const PersistentQueue::Entry& flight, int runwayIndex);
+
+    // Put the best flight the runway takes on it - false if there is none
+    bool assignNext(int runwayIndex);
+
+    // Delay of the assignments made so far, plus the queued flights' delay if the first
+    // 'horizon' of them went in queue order to whichever runway frees up first
+    SimTime getAssignedDelay() const;
+    SimTime score(size_t horizon = 100) const;
+
+    // Assignments in the order they were made
+    std::vector<Assignment> getAssignments() const;
+
+    const PersistentQueue& getArrivals() const;
+    const PersistentQueue& getDepartures() const;
+    const std::vector<Runway>& getRunways() const;
+    SimTime getTime() const;
+
+private:
+    // Assignments as a shared list, newest first, so forks don't copy them
+    struct AssignmentNode
+    {
+        Assignment assignment;
+        std::shared_ptr<const AssignmentNode> previous;
+    };
+
+    PersistentQueue arrivals;
+    PersistentQueue departures;
+    std::vector<Runway> runways;
+    SimTime now;
+    SimTime assignedDelay;
+    std::shared_ptr<const AssignmentNode> lastAssignment;
+
+    Runway* findRunway(int runwayIndex);
+    static bool takes(const Runway& runway, bool arrival);
+
+    // Book the flight on the runway and count its delay
+    void book(Runway& runway, const PersistentQueue::Entry& flight, bool arrival);
+};
+
+#endif // AIRCONTROLX_SCHEDULERSTATE_H
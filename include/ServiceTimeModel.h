@@ -0,0 +1,61 @@
+#ifndef AIRCONTROLX_SERVICETIMEMODEL_H
+#define AIRCONTROLX_SERVICETIMEMODEL_H
+
+#include <vector>
+#include <mutex>
+#include "Common.h"
+#include "SimClock.h"
+
+/**
+ * ServiceTimeModel learns how long each runway stays busy per flight -
+ * from runway assignment until the runway is released - as an
+ * exponentially weighted moving average per runway and per aircraft type.
+ *
+ * Wait estimates treat the runways that have served a flow (arrivals or
+ * departures) as parallel servers: an aircraft with n flights ahead of it
+ * waits about n / (sum of 1 / service time) for its runway. Until the
+ * first sample arrives every flight counts as the default service time.
+ */
+class ServiceTimeModel
+{
+public:
+    static const int typeCount = 5;     // AirCraftType values
+
+    explicit ServiceTimeModel(SimTime defaultServiceMs = 120000, double smoothing = 0.2);
+
+    // A flight of this type held the runway for serviceMs (called when it is released)
+    void record(int runwayIndex, AirCraftType type, bool arrival, SimTime serviceMs);
+
+    // Smoothed service time: runway + type, else the runway's average, else the default
+    SimTime getServiceTime(int runwayIndex, AirCraftType type) const;
+
+    // Smoothed service time of the runway over every type, else the default
+    SimTime getServiceTime(int runwayIndex) const;
+
+    // Expected milliseconds until 'ahead' flights of the flow have been served
+    SimTime estimateWait(int ahead, bool arrival) const;
+
+    unsigned long long getSampleCount() const;
+
+private:
+    struct RunwayStats
+    {
+        double byType[typeCount];                   // EWMA per aircraft type (ms)
+        unsigned long long typeSamples[typeCount];
+        double overall;                             // EWMA over every flight (ms)
+        unsigned long long samples;
+        bool servesArrivals;                        // Flows seen on this runway
+        bool servesDepartures;
+    };
+
+    std::vector<RunwayStats> runways;   // By runway index, grown on first sample
+    SimTime defaultService;
+    double alpha;                       // Weight of the newest sample
+    unsigned long long totalSamples;
+    mutable std::mutex modelMutex;
+
+    // Fold a sample into an average (the first sample is taken as is)
+    void smooth(double& average, unsigned long long count, double sample) const;
+};
+
+#endif // AIRCONTROLX_SERVICETIMEMODEL_H
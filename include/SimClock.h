@@ -0,0 +1,81 @@
+#ifndef AIRCONTROLX_SIMCLOCK_H
+#define AIRCONTROLX_SIMCLOCK_H
+
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Simulated time in milliseconds since the clock was (re)configured
+typedef long long SimTime;
+
+// How simulated time relates to wall-clock time
+enum class ClockMode {RealTime, Scaled, AsFastAsPossible};
+
+/**
+ * SimClock is the single source of time for the simulation.
+ * Timer, the scheduler's FCFS aging, the ATC loop and the flight lifecycle
+ * all read time from here instead of calling time(NULL) or sleep(), so a
+ * whole day of traffic can be compressed into seconds.
+ *
+ * - RealTime:          1 simulated second = 1 wall-clock second
+ * - Scaled:            1 simulated second = 1/scale wall-clock seconds
+ * - AsFastAsPossible:  time only moves when the engine advances it to the
+ *                      next pending event (pure discrete-event mode)
+ */
+class SimClock
+{
+private:
+    ClockMode mode;
+    double scale;                                   // Simulated seconds per real second
+    std::chrono::steady_clock::time_point epoch;    // Real time at which simulated time was 0
+    std::atomic<SimTime> virtualNow;                // Current time in AsFastAsPossible mode
+
+    // Used to wake threads sleeping on virtual time
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+
+    // Clock used by everything that doesn't get one injected
+    static SimClock* globalClock;
+
+    // Overrides globalClock for one thread (the threads of one airport in a network)
+    static thread_local SimClock* threadClock;
+
+public:
+    // Constructor (defaults to real time)
+    SimClock(ClockMode clockMode = ClockMode::RealTime, double timeScale = 1.0);
+
+    // Get the calling thread's clock - the process-wide one unless the thread is bound to another
+    static SimClock& instance();
+
+    // Replace the process-wide clock (nullptr restores the default one)
+    static void setInstance(SimClock* clock);
+
+    // Make instance() return this clock on the calling thread (nullptr = the process-wide one again)
+    static void bindThread(SimClock* clock);
+
+    // Change mode/scale - simulated time restarts at 0 (call before the simulation starts)
+    void configure(ClockMode clockMode, double timeScale = 1.0);
+
+    // Current simulated time
+    SimTime now() const;
+    long long nowSeconds() const;
+
+    // Block the calling thread until the simulated time has passed
+    void sleepFor(SimTime durationMs);
+    void sleepUntil(SimTime targetTime);
+
+    // How long to wait in real time until the simulated time is reached
+    std::chrono::microseconds realTimeUntil(SimTime targetTime) const;
+
+    // Move virtual time forward (only meaningful in AsFastAsPossible mode)
+    void advanceTo(SimTime targetTime);
+
+    // True when time is driven by events rather than by the wall clock
+    bool isVirtual() const;
+
+    ClockMode getMode() const;
+    double getScale() const;
+};
+
+#endif // AIRCONTROLX_SIMCLOCK_H
@@ -0,0 +1,262 @@
+#ifndef AIRCONTROLX_SIMULATIONENGINE_H
+#define AIRCONTROLX_SIMULATIONENGINE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include "SimClock.h"
+#include "TaskPool.h"
+#include "Aircraft.h"
+#include "ATCScontroller.h"
+#include "RunwayManager.h"
+#include "WorldSnapshot.h"
+
+/**
+ * SimulationEngine is the discrete-event core of the simulation.
+ * Instead of one thread per aircraft, every flight is a chain of timestamped
+ * events (enter queue, runway timeout, phase transition) kept in a single
+ * priority queue and processed by a small fixed pool of worker threads.
+ * Event times come from a SimClock, so the same engine runs in real time,
+ * scaled time, or as fast as possible (jumping straight to the next event).
+ *
+ * Continuous per-aircraft updates (speed, violation check, position) run
+ * once per step interval as small tasks on a work-stealing TaskPool. After
+ * each step the engine publishes a WorldSnapshot for lock-free readers.
+ *
+ * Several engines can run side by side, one per airport of an
+ * AirportNetwork: each gets its own clock (bound on its threads, so the
+ * core's SimClock::instance() reads it) and a horizon its virtual clock
+ * stops at until the network moves it.
+ */
+class SimulationEngine
+{
+public:
+    // Kinds of events a flight can go through
+    enum class EventType {Enter, WaitStatus, RunwayTimeout, PhaseChange, Periodic, Step, Controller};
+
+    // Per-flight bookkeeping that used to live on the flight thread's stack
+    struct FlightContext
+    {
+        Aircraft* aircraft;
+        bool isArrival;     // Arrival (N/S) or departure (E/W) flow
+        bool waitingForRunway; // In the ATC queue, not yet assigned or timed out
+        int phaseIndex;     // Position in the arrival/departure phase sequence
+        SimTime enterTime;  // When the flight joined the ATC queue
+        SimTime runwayTime; // When the flight noticed its runway assignment
+        bool inProgress;    // Between Enter and finish - gets per-step updates
+        int stepSlot;       // Index in steppingFlights (-1 when not in progress)
+        std::atomic<unsigned int> generation; // Bumped when the context is reused
+        std::mutex stateMutex; // Held while an event or step touches the aircraft
+    };
+
+    // Repeating task such as the ATC controller loop
+    struct PeriodicTask
+    {
+        std::function<bool()> callback; // Return false to stop repeating
+        SimTime interval;               // Simulated milliseconds between runs
+    };
+
+    // One entry of the event queue
+    struct Event
+    {
+        SimTime dueTime;             // Simulated time the event fires
+        unsigned long long sequence; // Tie-breaker so equal times stay FIFO
+        EventType type;
+        FlightContext* flight;       // Set for flight events
+        unsigned int generation;     // Flight generation the event was scheduled for
+        PeriodicTask* task;          // Set for periodic events
+    };
+
+    // Constructor and destructor (nullptr clock = process-wide SimClock)
+    SimulationEngine(ATCScontroller* atc, RunwayManager* rwm, SimClock* simClock = nullptr);
+    ~SimulationEngine();
+
+    // Route per-flight log lines somewhere (nothing is printed if unset)
+    void setLogger(const std::function<void(const std::string&)>& logFunction);
+
+    // Start the worker threads (0 = one per hardware thread).
+    // With an as-fast-as-possible clock, queue the initial flights first.
+    bool start(int workerCount = 0);
+
+    // Simulated milliseconds between per-aircraft steps (0 = off) and the
+    // step pool size (0 = one per hardware thread) - call before start()
+    void setStepInterval(SimTime intervalMs, int workerCount = 0);
+
+    // Add a flight to the simulation, entering after delayMs simulated milliseconds
+    // (even aircraftIndex = arrival, odd = departure)
+    void addFlight(Aircraft* aircraft, SimTime delayMs = 0);
+
+    // Same with the flow given - for flights that arrive from or leave for another airport
+    void addFlight(Aircraft* aircraft, SimTime delayMs, bool isArrival);
+
+    // Called once per flight when it completes or times out (set before start()).
+    // The aircraft is out of the ATC queues by then and may be reused.
+    void setFlightFinishedListener(const std::function<void(Aircraft*, bool)>& listener);
+
+    // Run an ATC round as soon as the controller is signalled (a flight queued, a runway
+    // freed, an emergency) instead of from a periodic task - call before start()
+    void setControllerEvents(bool enabled);
+
+    // Pin the event workers to one CPU (-1 = no pinning, the default; Linux only) - call before start()
+    void setCpuAffinity(int cpu);
+
+    // A virtual clock is not moved past the horizon (default: no limit) - events due later wait
+    // until it is raised. Real-time and scaled clocks ignore it.
+    void setHorizon(SimTime horizonTime);
+
+    // Block until nothing is running and nothing is due up to the horizon, then move the
+    // virtual clock to the horizon
+    void waitForHorizon();
+
+    // Run callback every intervalMs of simulated time until it returns false
+    void addPeriodicTask(SimTime intervalMs, const std::function<bool()>& callback, SimTime delayMs = 0);
+
+    // Block until every flight has completed or timed out and all periodic tasks stopped
+    void waitForCompletion();
+
+    // Stop the worker threads (pending events are dropped)
+    void stop();
+
+    // Statistics
+    int getWorkerCount() const;
+    int getActiveFlightCount() const;
+    int getCompletedFlightCount() const;
+    int getTimedOutFlightCount() const;
+    size_t getPendingEventCount();
+    unsigned long long getProcessedEventCount() const;
+    SimTime getCompletionTime() const;  // When the last flight or task finished (the clock may run on a little)
+    SimClock* getClock() const;
+    const TaskPool& getStepPool() const;
+
+    // Snapshots published after every step (readers: acquire())
+    const WorldSnapshotBuffer& getWorldSnapshots() const;
+
+    // Latency samples of completed flights (simulated milliseconds)
+    std::vector<SimTime> getRunwayWaitTimes();  // Queue entry -> runway assigned
+    std::vector<SimTime> getFlightTimes();      // Queue entry -> gate / cruise
+
+private:
+    // Order events so the earliest due time sits on top of the heap
+    struct EventLater
+    {
+        bool operator()(const Event& a, const Event& b) const
+        {
+            if (a.dueTime != b.dueTime) return a.dueTime > b.dueTime;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    ATCScontroller* atcController;
+    RunwayManager* runwayManager;
+    SimClock* clock;
+    std::function<void(const std::string&)> logger;
+    std::function<void(Aircraft*, bool)> finishedListener;
+
+    // Event queue (binary heap) and its synchronization
+    std::vector<Event> eventQueue;
+    unsigned long long nextSequence;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    SimTime horizon;                            // Virtual time stops here (guarded by queueMutex)
+    std::condition_variable horizonCondition;   // Workers went idle below the horizon
+
+    // Flight contexts - deque so pointers stay valid while we grow;
+    // finished contexts are reused so long runs don't keep growing it
+    std::deque<FlightContext> flights;
+    std::vector<FlightContext*> freeFlights;
+    std::vector<FlightContext*> steppingFlights;   // Flights in progress (guarded by flightsMutex)
+    std::mutex flightsMutex;
+
+    // Worker threads
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+    int busyWorkers;    // Workers currently running an event (guarded by queueMutex)
+    int cpuAffinity;    // CPU the workers are pinned to (-1 = none)
+
+    // Periodic tasks - deque for pointer stability like the flights
+    std::deque<PeriodicTask> tasks;
+    std::mutex tasksMutex;
+    std::atomic<int> activeTasks;
+
+    // Per-aircraft step tasks
+    TaskPool stepPool;
+    SimTime stepInterval;
+    int stepWorkers;
+    std::atomic<bool> stepArmed;    // A Step event is queued
+
+    // Signal-driven ATC rounds
+    bool controllerEvents;
+    std::atomic<bool> controllerArmed;  // A Controller event is queued
+
+    // World snapshots for the visualizer and status queries
+    WorldSnapshotBuffer worldSnapshots;
+
+    // Flight counters
+    std::atomic<int> activeFlights;
+    std::atomic<int> completedFlights;
+    std::atomic<int> timedOutFlights;
+    std::atomic<unsigned long long> processedEvents;
+    std::atomic<SimTime> completionTime;
+    std::mutex completionMutex;
+    std::condition_variable completionCondition;
+
+    // Latency samples collected when flights finish
+    std::vector<SimTime> runwayWaitTimes;
+    std::vector<SimTime> flightTimes;
+    std::mutex statsMutex;
+
+    // Push a new flight event onto the queue
+    void schedule(FlightContext* flight, EventType type, SimTime delayMs);
+
+    // Push any event onto the queue at an absolute time
+    void pushEvent(Event& event);
+
+    // Worker thread main loop
+    void workerLoop();
+
+    // True when no worker is busy and nothing is due up to the horizon (queueMutex held)
+    bool reachedHorizon() const;
+
+    // Event handlers
+    void processEvent(const Event& event);
+    void handleEnter(FlightContext* flight);
+    void handleWaitStatus(FlightContext* flight);
+    void handleRunwayTimeout(FlightContext* flight);
+
+    // Called from Aircraft::AssignRunaway() on the ATC thread
+    void handleRunwayAssigned(FlightContext* flight, unsigned int generation);
+    void handlePhaseChange(FlightContext* flight);
+    void handlePeriodic(const Event& event);
+    void handleStep(const Event& event);
+
+    // Queue the next Step event unless one is already pending
+    void armStep(SimTime dueTime);
+
+    // Queue a Controller event for now unless one is already pending (the signal's wake handler)
+    void armController();
+    void handleController();
+
+    // Advance one aircraft by one step, and copy it into view (if not nullptr)
+    void stepFlight(FlightContext* flight, AircraftView* view);
+
+    // Complete and publish a snapshot the step filled
+    void publishSnapshot(WorldSnapshot* snapshot, SimTime now);
+
+    // Release the runway and retire the flight (unlocks the flight's stateMutex)
+    void finishFlight(FlightContext* flight, bool timedOut, std::unique_lock<std::mutex>& lock);
+
+    // Give back the aircraft's runway lease - false if it held none or had lost it
+    bool releaseRunway(Aircraft* plane);
+
+    // Wake waitForCompletion() if nothing is left to run
+    void notifyIfIdle();
+
+    void log(const std::string& message);
+};
+
+#endif // AIRCONTROLX_SIMULATIONENGINE_H
@@ -9,22 +9,18 @@
 #include "Airline.h"
 #include "ATCScontroller.h"
 #include "RunwayManager.h"
+#include "SimulationEngine.h"
 #include "VisualSimulator.h"
 
 /**
  * The SimulationManager class handles thread creation and management for the simulation.
- * It manages the lifecycle of aircraft threads and the ATC controller thread.
+ * Flights and the ATC controller loop run as events on the SimulationEngine;
+ * this class owns the engine and manages the visualization thread.
  */
 class SimulationManager 
 {
 private:
-    // Forward declarations of thread argument structures
-    struct ThreadArgs;
-    struct ATCArgs;
-    
     // Thread storage
-    std::vector<pthread_t> aircraftThreads;
-    pthread_t atcControllerThread;
     pthread_t visualizerThread;
     
     // Thread synchronization
@@ -36,15 +32,12 @@ private:
     RunwayManager* runwayManager;
     VisualSimulator* visualizer;
     
+    // Discrete-event engine that drives all flights
+    SimulationEngine* engine;
+    
     // Flag to control visualization thread
     bool visualizationActive;
     
-    // Thread function for aircraft simulation
-    static void* flightThreadFunction(void* arg);
-    
-    // Thread function for ATC controller
-    static void* atcControllerThreadFunction(void* arg);
-    
     // Thread function for visualization
     static void* visualizerThreadFunction(void* arg);
 
@@ -53,16 +46,19 @@ public:
     SimulationManager(ATCScontroller* atc, RunwayManager* rwm);
     ~SimulationManager();
     
-    // Launch aircraft threads for an airline
-    bool launchAirlineThreads(Airline* airline);
+    // Add all aircraft of an airline to the simulation engine
+    bool launchAirlineFlights(Airline* airline);
+    
+    // Launch the ATC controller loop on the engine
+    bool launchATCController();
     
-    // Launch ATC controller thread
-    bool launchATCControllerThread();
+    // Start running the queued flights and ATC loop
+    bool startSimulation();
     
     // Create random emergency situation
     void createRandomEmergency(const std::vector<Airline*>& airlines);
     
-    // Wait for all threads to complete
+    // Wait for all flights and threads to complete
     void waitForCompletion();
     
     // Thread-safe console logging
@@ -0,0 +1,92 @@
+#ifndef AIRCONTROLX_TASKPOOL_H
+#define AIRCONTROLX_TASKPOOL_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <functional>
+
+/**
+ * TaskPool is a work-stealing thread pool for short, independent tasks
+ * such as the per-aircraft state update.
+ * Every worker owns a deque: it pushes and pops its own work at the back
+ * (LIFO, cache friendly) and, when empty, steals from the front of another
+ * worker's deque (FIFO, oldest work first). Workers with nothing to steal
+ * sleep on a condition variable instead of spinning.
+ */
+class TaskPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // Per-worker counters used to check how well the pool scales
+    struct WorkerStats
+    {
+        unsigned long long executed;  // Tasks run by this worker
+        unsigned long long stolen;    // How many of those were stolen from another worker
+        double utilization;           // Fraction of wall time spent running tasks (0..1)
+    };
+
+    TaskPool();
+    ~TaskPool();
+
+    // Start the workers (0 = one per hardware thread)
+    bool start(int workerCount = 0);
+
+    // Finish the queued tasks and join the workers
+    void stop();
+
+    // Queue a task - goes to the caller's own deque when called from a worker
+    void submit(const Task& task);
+
+    // Run body(i) for i in [0, count) in chunks of grainSize and wait for all of them
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t)>& body);
+
+    // Statistics
+    int getWorkerCount() const;
+    std::vector<WorkerStats> getWorkerStats() const;
+    std::string getStatsReport() const;
+
+private:
+    // A worker's deque and its counters
+    struct Worker
+    {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::thread thread;
+        std::atomic<unsigned long long> executed;
+        std::atomic<unsigned long long> stolen;
+        std::atomic<long long> busyMicros;
+
+        Worker() : executed(0), stolen(0), busyMicros(0) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running;
+    std::atomic<unsigned int> nextWorker;   // Round-robin target for outside submissions
+    std::chrono::steady_clock::time_point startTime;
+
+    // Sleeping workers wait here for new tasks
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<unsigned long long> wakeCount;  // Tasks submitted so far (bumped under wakeMutex)
+
+    // Which pool/worker the current thread belongs to (nullptr/-1 outside the pool)
+    static thread_local TaskPool* currentPool;
+    static thread_local int currentWorker;
+
+    // Take a task from our own deque (back) or steal from another one (front)
+    bool popLocal(int index, Task& task);
+    bool steal(int thief, Task& task);
+
+    // Worker thread main loop
+    void workerLoop(int index);
+};
+
+#endif // AIRCONTROLX_TASKPOOL_H
@@ -1,15 +1,17 @@
 #ifndef AIRCONTROLX_TIMER_H
 #define AIRCONTROLX_TIMER_H
 
-#include <ctime>
+#include "SimClock.h"
 
 /**
  * Timer class for managing time-related operations in the AirControlX system.
  * Used for tracking elapsed time, checking timeouts, and scheduling events.
+ * Time comes from a SimClock, so timers follow compressed simulation time.
  */
 class Timer {
 private:
-    time_t startTime;     // Time when the timer started
+    SimClock* clock;      // Clock the timer reads (process-wide clock by default)
+    SimTime startTime;    // Simulated time when the timer started
     int durationSeconds;  // Duration of the timer in seconds
     bool running;         // Flag to track if timer is currently running
 
@@ -17,6 +19,9 @@ public:
     // Constructor
     Timer();
     
+    // Use a specific clock instead of the process-wide one
+    void setClock(SimClock* simClock);
+    
     // Start the timer
     void start();
     
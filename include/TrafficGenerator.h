@@ -0,0 +1,117 @@
+#ifndef AIRCONTROLX_TRAFFICGENERATOR_H
+#define AIRCONTROLX_TRAFFICGENERATOR_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include "Common.h"
+#include "SimClock.h"
+#include "Aircraft.h"
+#include "SimulationEngine.h"
+
+// Number of AirCraftType values (Commercial, Cargo, Emergency, Military, Medical)
+static const int aircraftTypeCount = 5;
+
+// Traffic of one airline
+struct AirlineTraffic
+{
+    std::string name;                    // Used for flight numbers (e.g. PIA-1234)
+    double arrivalsPerHour;              // Mean rate over the day
+    double departuresPerHour;
+    double typeMix[aircraftTypeCount];   // Relative weight of each AirCraftType
+};
+
+// Everything the generator needs to produce a day (or any span) of traffic
+struct TrafficConfig
+{
+    std::vector<AirlineTraffic> airlines;
+    bool useDailyProfile;        // false = constant-rate Poisson, true = time-of-day profile
+    double hourlyProfile[24];    // Rate multiplier per hour of the simulated day
+    double emergencyRate;        // Fraction of flights that declare an emergency (0..1)
+    SimTime duration;            // Stop generating after this much simulated time
+    unsigned int seed;           // Same seed, same traffic
+};
+
+/**
+ * TrafficGenerator produces synthetic flights for load testing.
+ * Every airline has an arrival and a departure stream. Stream events are
+ * Poisson with the configured mean rate, optionally shaped by a 24-hour
+ * profile (non-homogeneous Poisson via thinning). Each flight draws its
+ * AirCraftType from the airline's mix and may declare an emergency.
+ *
+ * Flights are produced lazily: a periodic engine task generates one
+ * simulated second at a time and hands the flights to the engine. Aircraft
+ * objects come from a pool and go back to it when the engine reports the
+ * flight finished, so memory follows the number of flights in the air, not
+ * the number generated.
+ */
+class TrafficGenerator
+{
+public:
+    TrafficGenerator(SimulationEngine* simulationEngine);
+
+    // The six standard airlines sharing flightsPerDay (half arrivals, half departures)
+    static TrafficConfig defaultConfig(double flightsPerDay, SimTime duration, unsigned int seed);
+
+    // Use a different configuration (call before start())
+    void configure(const TrafficConfig& trafficConfig);
+
+    // Register the generator with the engine - call before engine->start()
+    void start();
+
+    // Statistics
+    long long getGeneratedCount() const;
+    long long getEmergencyCount() const;
+    size_t getPoolSize();           // Aircraft objects ever allocated
+    size_t getAircraftInUse();      // Aircraft currently flying
+
+private:
+    // One arrival or departure stream of one airline
+    struct Stream
+    {
+        int airline;            // Index into config.airlines
+        bool isArrival;
+        double peakRatePerMs;   // Rate at the busiest hour - the thinning envelope
+        double baseRatePerMs;   // Mean rate before the hourly multiplier
+        SimTime nextTime;       // Time of the next candidate flight
+        long long sequence;     // Flights produced by this stream
+        unsigned long long randomKey;     // CounterRandom stream (airline, direction, seed)
+        unsigned long long randomCounter; // Draws taken from it so far
+    };
+
+    SimulationEngine* engine;
+    TrafficConfig config;
+    std::vector<Stream> streams;
+    SimTime generatedUntil;     // Everything before this time has been generated
+
+    // Aircraft pool - deque so pointers stay valid while it grows
+    std::deque<Aircraft> aircraftPool;
+    std::vector<Aircraft*> freeAircraft;
+    std::mutex poolMutex;
+
+    std::atomic<long long> generatedCount;
+    std::atomic<long long> emergencyCount;
+
+    // Generate every flight due in [generatedUntil, until)
+    void generateUntil(SimTime until);
+
+    // Draw the next candidate time of a stream
+    void advanceStream(Stream& stream);
+
+    // Time-of-day multiplier at a simulated time
+    double rateMultiplier(SimTime time) const;
+
+    // Next uniform [0, 1) number of a stream
+    double nextUnit(Stream& stream);
+
+    // Pick an AirCraftType from the airline's mix
+    AirCraftType pickType(Stream& stream, const AirlineTraffic& airline);
+
+    // Pool management
+    Aircraft* acquireAircraft(int index, const std::string& airlineName, AirCraftType type);
+    void releaseAircraft(Aircraft* aircraft);
+};
+
+#endif // AIRCONTROLX_TRAFFICGENERATOR_H
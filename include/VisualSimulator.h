@@ -8,6 +8,7 @@
 #include <vector>
 #include "Aircraft.h"
 #include "RunwayManager.h"
+#include "WorldSnapshot.h"
 
 /**
  * VisualSimulator class for graphical representation of the simulation.
@@ -72,6 +73,9 @@ private:
     // Reference to runway manager for runway visualization
     RunwayManager* runwayMgr;
     
+    // Snapshots published by the engine (preferred over aircraftList when set)
+    const WorldSnapshotBuffer* worldSnapshots;
+    
     // Screen dimensions
     int screenWidth;
     int screenHeight;
@@ -82,6 +86,10 @@ private:
     void renderAircraft();
     void renderUI();
     void renderStatusPanel();
+    
+    // Texture for an aircraft type and tint for emergencies / violations
+    const sf::Texture& aircraftTexture(AirCraftType type) const;
+    sf::Color aircraftTint(int emergencyLevel, bool violation) const;
 
 public:
     // Constructor and destructor
@@ -114,6 +122,12 @@ public:
      */
     void setRunwayManager(RunwayManager* manager);
     
+    /**
+     * Set the snapshot buffer to draw aircraft from
+     * Rendering then never touches the live aircraft
+     */
+    void setWorldSnapshots(const WorldSnapshotBuffer* snapshots);
+    
     /**
      * Create aircraft sprite based on aircraft type
      * Returns sprite object configured with proper texture and position
@@ -126,6 +140,10 @@ public:
      */
     void updateAircraftSprite(sf::Sprite& sprite, const Aircraft* aircraft);
     
+    // Same as above for an aircraft copied into a world snapshot
+    sf::Sprite createAircraftSprite(const AircraftView& aircraft);
+    void updateAircraftSprite(sf::Sprite& sprite, const AircraftView& aircraft);
+    
     /**
      * Create runway sprite based on runway type
      * Returns sprite object configured with proper texture and position
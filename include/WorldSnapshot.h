@@ -0,0 +1,136 @@
+#ifndef AIRCONTROLX_WORLDSNAPSHOT_H
+#define AIRCONTROLX_WORLDSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include "Common.h"
+#include "SimClock.h"
+#include "AircraftTable.h"
+
+class RunwayManager;
+class Aircraft;
+
+// Copy of one aircraft as it was when the snapshot was taken
+struct AircraftView
+{
+    AircraftRef ref;            // Row in the scheduler's AircraftTable - resolve() it for the live Aircraft
+    std::string flightNumber;
+    AirCraftType type;
+    FlightState state;
+    Direction direction;
+    int speed;
+    int x, y;
+    int emergencyLevel;
+    unsigned char flags;        // AircraftTable::Flags bits
+    SimTime queueEntryTime;
+
+    // Copy the aircraft's fields (the caller holds whatever keeps it from changing meanwhile)
+    void copyFrom(const Aircraft& aircraft, const AircraftRef& rowRef);
+
+    bool hasViolation() const;  // HasViolation or hasActiveViolation
+    bool isActive() const;
+
+    // Same text / angle / color the Aircraft helpers give, for rendering
+    std::string getDisplayName() const;
+    float getRotationAngle() const;
+    void getStatusColor(int rgb[3]) const;
+};
+
+// Copy of one runway
+struct RunwayView
+{
+    std::string id;
+    RunwayType type;
+    bool occupied;
+};
+
+/**
+ * Immutable picture of the world at one simulated time. Readers get it from
+ * a WorldSnapshotBuffer and may keep it as long as they like; the simulation
+ * never writes to a published snapshot.
+ */
+struct WorldSnapshot
+{
+    unsigned long long sequence;    // 1 for the first published snapshot, then +1
+    SimTime time;                   // Simulated time it was taken
+    std::vector<AircraftView> aircraft;
+    std::vector<RunwayView> runways;
+    int stateCounts[8];             // Indexed by FlightState
+    int typeCounts[5];              // Indexed by AirCraftType
+    int emergencyCount;
+    int activeViolationCount;
+
+    WorldSnapshot();
+
+    // Fill from the aircraft table's columns and the runways (overwrites everything but sequence)
+    void capture(const AircraftTable& table, RunwayManager* runwayManager, SimTime now);
+
+    // Complete a snapshot whose views were copied in already (see AircraftView::copyFrom): drop
+    // the views with an invalid handle, count the rest and copy the runways
+    void finish(RunwayManager* runwayManager, SimTime now);
+};
+
+/**
+ * WorldSnapshotBuffer publishes snapshots from one writer (the engine, once
+ * per step) to any number of readers without locks.
+ *
+ * It has a few slots. The writer fills a slot that is neither published nor
+ * in use by a reader and publishes it with one atomic store. A reader pins
+ * the published slot with one atomic increment, checks it is still the
+ * published one and reads it for as long as it holds the Ref. Readers never
+ * block the writer: if every other slot is still pinned the writer skips the
+ * tick and readers keep seeing the previous snapshot.
+ */
+class WorldSnapshotBuffer
+{
+public:
+    static const int slotCount = 4;
+
+    // Pinned snapshot - released when the Ref goes away
+    class Ref
+    {
+    public:
+        Ref();
+        Ref(Ref&& other);
+        Ref& operator=(Ref&& other);
+        ~Ref();
+
+        explicit operator bool() const { return snapshot != nullptr; }
+        const WorldSnapshot* operator->() const { return snapshot; }
+        const WorldSnapshot& operator*() const { return *snapshot; }
+        const WorldSnapshot* get() const { return snapshot; }
+
+    private:
+        friend class WorldSnapshotBuffer;
+        Ref(const WorldSnapshot* pinnedSnapshot, std::atomic<int>* pinCount);
+        Ref(const Ref&) = delete;
+        Ref& operator=(const Ref&) = delete;
+        void release();
+
+        const WorldSnapshot* snapshot;
+        std::atomic<int>* pin;
+    };
+
+    WorldSnapshotBuffer();
+
+    // Writer side: get a free slot (nullptr if none), fill it, publish it
+    WorldSnapshot* beginWrite();
+    void publish(WorldSnapshot* snapshot);
+
+    // Reader side: the latest published snapshot (empty Ref before the first one)
+    Ref acquire() const;
+
+    unsigned long long getPublishedCount() const;
+    unsigned long long getSkippedCount() const;    // Ticks with no free slot
+
+private:
+    WorldSnapshot slots[slotCount];
+    mutable std::atomic<int> pins[slotCount];   // Readers holding each slot
+    std::atomic<int> published;                 // Published slot (-1 = none yet)
+    unsigned long long nextSequence;            // Writer only
+    std::atomic<unsigned long long> publishedCount;
+    std::atomic<unsigned long long> skippedCount;
+};
+
+#endif // AIRCONTROLX_WORLDSNAPSHOT_H
@@ -6,19 +6,56 @@
 #include <string.h>
 #include <sstream>
 #include <algorithm>
+#include <iomanip>
 using namespace std;
 
+const size_t ATCScontroller::candidateWindow;
+
 ATCScontroller::ATCScontroller()
 {
     schedulingInterval = 1;  // Schedule every 1 second
-    lastScheduleTime = time(NULL);
+    lastScheduleTime = SimClock::instance().now();
     runwayManager = nullptr; // Initialize to nullptr, must be set later with setRunwayManager
+    verbose = true;          // Print every runway assignment by default
+    runwayLeaseMs = RunwayClass::defaultLeaseMs;
+    worldSnapshots = nullptr;
+    cargoDeparturesFirst = false;
+}
+
+// Turn per-assignment console output on or off (headless runs turn it off)
+void ATCScontroller::setVerbose(bool enabled)
+{
+    verbose = enabled;
+}
+
+void ATCScontroller::setRunwayLeaseMs(SimTime leaseMs)
+{
+    std::lock_guard<std::mutex> lock(controllerMutex);
+    runwayLeaseMs = leaseMs;
+}
+
+// Status queries read the engine's snapshots from now on
+void ATCScontroller::setWorldSnapshots(const WorldSnapshotBuffer* snapshots)
+{
+    worldSnapshots = snapshots;
 }
 
 // Set the runway manager reference
 void ATCScontroller::setRunwayManager(RunwayManager* rwManager)
 {
     runwayManager = rwManager;
+    
+    // Every runway takes part in the matching; the ones that take arrivals are the ones the arrival plan fills
+    std::vector<RunwayClass*> runways;
+    std::vector<RunwayClass*> arrivalRunways;
+    for (int i = 0; runwayManager && i < runwayManager->getRunwayCount(); i++)
+    {
+        RunwayClass* runway = runwayManager->getRunwayByIndex(i);
+        runways.push_back(runway);
+        if (runway->capabilities & RunwayArrivals) arrivalRunways.push_back(runway);
+    }
+    runwayMatcher.setRunways(runways);
+    scheduler.setArrivalRunways(arrivalRunways);
 }
 
 // Set the pipe for communication with AVN Generator
@@ -34,57 +71,60 @@ void ATCScontroller::setAVNPipe(int pipeWriteEnd)
 // Get count of active violations for the UI
 int ATCScontroller::getActiveViolationsCount() const
 {
-    // Access our active flights from the scheduler
-    const vector<Aircraft*>& activeFlights = scheduler.getActiveFlights();
-    
-    // Count violations
-    int count = 0;
-    for (const Aircraft* aircraft : activeFlights)
+    // Latest snapshot if the engine publishes them - no need to touch the live flights
+    if (worldSnapshots)
     {
-        if (aircraft->hasActiveViolation)
-        {
-            count++;
-        }
+        WorldSnapshotBuffer::Ref snapshot = worldSnapshots->acquire();
+        if (snapshot) return snapshot->activeViolationCount;
     }
     
-    return count;
+    // Count violations over the flags column
+    return scheduler.getAircraftTable().countWithFlags(AircraftTable::FlagActiveViolation);
 }
 
 // Get list of aircraft with violations for the UI
 vector<Aircraft*> ATCScontroller::getAircraftWithViolations() const
 {
-    // Access our active flights from the scheduler
-    const vector<Aircraft*>& activeFlights = scheduler.getActiveFlights();
-    
     // Filter to only those with violations
-    vector<Aircraft*> violatingAircraft;
-    for (Aircraft* aircraft : activeFlights)
-    {
-        if (aircraft->hasActiveViolation)
-        {
-            violatingAircraft.push_back(aircraft);
-        }
-    }
-    
-    return violatingAircraft;
+    return scheduler.getAircraftTable().collectWithFlags(AircraftTable::FlagActiveViolation);
 }
 
 // Monitor flights in the airspace - called periodically from main
 void ATCScontroller::monitorFlight()
 {
     // Check if it's time to schedule flights
-    time_t currentTime = time(NULL);
-    if (currentTime - lastScheduleTime >= schedulingInterval)
+    SimTime currentTime = SimClock::instance().now();
+    SimTime intervalMs = schedulingInterval * 1000LL;
+    if (currentTime - lastScheduleTime >= intervalMs)
     {
         // It's time to schedule flights
         assignRunway();
-        lastScheduleTime = currentTime;
+        
+        // Stay on the interval grid so small wake-up jitter doesn't skip a round
+        lastScheduleTime += ((currentTime - lastScheduleTime) / intervalMs) * intervalMs;
     }
 }
 
+// Hand back a lease taken for a flight we then couldn't claim (controllerMutex held)
+void ATCScontroller::dropLease(RunwayClass* runway, Aircraft* aircraft)
+{
+    runway->release(aircraft->runwayLease);
+    aircraft->assignedRunway = -1;
+    aircraft->runwayLease = noRunwayLease;
+    runwayMatcher.refresh();
+}
+
 // Assign runways to aircraft based on priority and availability
+// One matching pass: emergencies, then cargo, arrivals and departures each take the best-fitting
+// free runway (see RunwayMatcher) until a queue is empty or its head fits no free runway
 void ATCScontroller::assignRunway()
 {
+    // Held for the whole round so removeFlight() can't retire an aircraft we just picked
+    std::lock_guard<std::mutex> lock(controllerMutex);
+    
+    // Everything requested since the last round joins the queues in one batch
+    scheduler.drainIntake();
+    
     // Make sure we have a valid runway manager
     if (!runwayManager)
     {
@@ -93,205 +133,223 @@ void ATCScontroller::assignRunway()
         return;
     }
     
-    // Check runway availability first
-    RunwayClass* rwyA = runwayManager->getRunwayByIndex(0); // RWY-A
-    RunwayClass* rwyB = runwayManager->getRunwayByIndex(1); // RWY-B
-    RunwayClass* rwyC = runwayManager->getRunwayByIndex(2); // RWY-C
-    
-    // Safety check - if any runway pointer is null, something's very wrong
-    if (!rwyA || !rwyB || !rwyC)
+    // Which runways are free this round - if none, nothing to do
+    runwayMatcher.refresh();
+    if (runwayMatcher.getFreeCount() == 0)
     {
-        cout << "ATCScontroller: Missing runway in manager! Can't assign runways." << endl;
         return;
     }
     
-    bool rwyA_available = !rwyA->isOccupied;
-    bool rwyB_available = !rwyB->isOccupied;
-    bool rwyC_available = !rwyC->isOccupied;
+    // Bring the arrival runway slots up to date with this round's queue
+    scheduler.scheduleFlight();
     
-    // If no runways are available, nothing to do
-    if (!rwyA_available && !rwyB_available && !rwyC_available)
+    // Step 1: First priority is ALWAYS emergency flights, on any free runway their direction allows
+    IndexedHeap::Entry peeked;
+    while (scheduler.peekEmergency(peeked))
     {
-        return;
+        Aircraft* emergency = peeked.aircraft;
+        RunwayClass* runway = runwayMatcher.claim(RunwayClass::requirementsOf(*emergency));
+        if (runway == nullptr || !runway->tryAssign(*emergency, runwayLeaseMs))
+        {
+            break;  // Nothing free fits - it stays first in line for the next round
+        }
+        if (!scheduler.claimEmergency(peeked))
+        {
+            dropLease(runway, emergency);   // Timed out or re-keyed since the peek - look again
+            continue;
+        }
+        
+        if (verbose) cout << "Emergency " << emergency->FlightNumber << " assigned to " << runway->id << " (emergency)" << endl;
+        emergency->AssignRunaway();
     }
     
-    // Step 1: First priority is ALWAYS emergency flights
-    Aircraft* emergency = scheduler.getNextEmergency();
-    if (emergency != nullptr)
+    // Flights are only taken out of a queue once a free runway fits them - the ones passed
+    // over (cargo with no cargo runway free, say) keep their place and entry time
+    RunwayMatcher& matcher = runwayMatcher;
+    FlightsScheduler::CandidateFilter fitsFreeRunway = [&matcher](const Aircraft& aircraft) {
+        return matcher.peek(RunwayClass::requirementsOf(aircraft)) != nullptr;
+    };
+    
+    // Step 2: Cargo gets the cargo runway (RWY-C) before anyone else, so other flights only use
+    // it once no cargo near a queue's head is waiting - the two flows take turns going first
+    FlightsScheduler::CandidateFilter cargoFitsFreeRunway = [&matcher](const Aircraft& aircraft) {
+        return aircraft.type == AirCraftType::Cargo && matcher.peek(RunwayClass::requirementsOf(aircraft)) != nullptr;
+    };
+    while (runwayMatcher.peek(RunwayCargo) != nullptr)
     {
-        // Try to assign emergency to appropriate runway based on direction
-        if ((emergency->direction == Direction::North || emergency->direction == Direction::South) && rwyA_available)
+        bool found = cargoDeparturesFirst
+            ? (scheduler.peekDepartures(candidateWindow, cargoFitsFreeRunway, candidates, 1) > 0 ||
+               scheduler.peekArrivals(candidateWindow, cargoFitsFreeRunway, candidates, 1) > 0)
+            : (scheduler.peekArrivals(candidateWindow, cargoFitsFreeRunway, candidates, 1) > 0 ||
+               scheduler.peekDepartures(candidateWindow, cargoFitsFreeRunway, candidates, 1) > 0);
+        if (!found)
         {
-            // Emergency arrival - assign to RWY-A
-            cout << "Emergency " << emergency->FlightNumber  << " assigned to RWY-A (emergency arrival)" <<  endl;
-            rwyA->tryAssign(*emergency);
-            emergency->hasRunwayAssigned = true;
-            return;
+            break;
         }
-        else if ((emergency->direction == Direction::East || emergency->direction == Direction::West) && rwyB_available)
+        
+        const IndexedHeap::Entry& candidate = candidates.front();
+        Aircraft* cargo = candidate.aircraft;
+        RunwayClass* runway = runwayMatcher.claim(RunwayClass::requirementsOf(*cargo));
+        if (runway == nullptr || !runway->tryAssign(*cargo, runwayLeaseMs))
         {
-            // Emergency departure - assign to RWY-B
-             cout << "Emergency " << emergency->FlightNumber  << " assigned to RWY-B (emergency departure)" <<  endl;
-            rwyB->tryAssign(*emergency);
-            emergency->hasRunwayAssigned = true;
-            return;
+            break;
         }
-        else if (rwyC_available)
+        if (!scheduler.claim(candidate))
         {
-            // Use flexible runway for emergency
-             cout << "Emergency " << emergency->FlightNumber << " assigned to RWY-C (flexible emergency)" <<  endl;
-            rwyC->tryAssign(*emergency);
-            emergency->hasRunwayAssigned = true;
-            return;
+            dropLease(runway, cargo);   // Left the queue meanwhile - runway stays free
+            continue;
         }
-        // If we get here, all runways are occupied but appropriate for emergency
-        // In a real system, we might consider clearing a runway for the emergency
+        
+        if (verbose) cout << "Cargo " << cargo->FlightNumber << " assigned to " << runway->id << endl;
+        cargo->AssignRunaway();
+        cargoDeparturesFirst = !cargoDeparturesFirst;
     }
     
-    //Special handling for cargo flights they primarily use RWY-C
-    if (rwyC_available)
+    // Step 3: Arrivals in the order the arrival plan sequenced them - each asks for the runway
+    // the plan would use next, and is claimed once that (or another fitting) runway is leased
+    RunwayClass* planned;
+    while ((planned = runwayMatcher.peek(RunwayArrivals | RunwayNorthSouth)) != nullptr)
     {
-        // Check both queues for cargo flights
-        bool cargoAssigned = false;
-        
-        // First check arrivals
-        Aircraft* arrival = nullptr;
-        while ((arrival = scheduler.getNextArrival()) != nullptr)
+        if (!scheduler.peekPlannedArrival(planned->index, fitsFreeRunway, candidateWindow, peeked))
         {
-            if (arrival->type == AirCraftType::Cargo)
-            {
-                 cout << "Cargo arrival " << arrival->FlightNumber << " assigned to RWY-C (cargo priority)" <<  endl;
-                rwyC->tryAssign(*arrival);
-                arrival->hasRunwayAssigned = true;
-                cargoAssigned = true;
-                break;
-            }
-            else
-            {
-                // Put it back in the queue if it's not cargo
-                scheduler.addArrival(arrival);
-                break;  // Only check the first one to maintain priority order
-            }
+            break;  // Nothing near the head of the queue fits what is free
         }
         
-        // If no cargo arrivals, check departures
-        if (!cargoAssigned)
+        // The filter found it a runway, so this only misses if a lease was taken behind our back -
+        // the flight is still queued, so it just waits for the next round
+        Aircraft* arrival = peeked.aircraft;
+        RunwayClass* runway = runwayMatcher.claim(RunwayClass::requirementsOf(*arrival), planned->index);
+        if (runway == nullptr || !runway->tryAssign(*arrival, runwayLeaseMs))
         {
-            Aircraft* departure = nullptr;
-            while ((departure = scheduler.getNextDeparture()) != nullptr)
-            {
-                if (departure->type == AirCraftType::Cargo)
-                {
-                     cout << "Cargo departure " << departure->FlightNumber << " assigned to RWY-C (cargo priority)" <<  endl;
-                    rwyC->tryAssign(*departure);
-                    departure->hasRunwayAssigned = true;
-                    cargoAssigned = true;
-                    break;
-                }
-                else
-                {
-                    // Put it back in the queue if it's not cargo
-                    scheduler.addDeparture(departure);
-                    break;  // Only check the first one to maintain priority order
-                }
-            }
+            break;
         }
-        
-        // If we assigned a cargo flight, we're done for this scheduling cycle
-        if (cargoAssigned)
+        if (!scheduler.claim(peeked))
         {
-            return;
+            dropLease(runway, arrival);     // Left the queue meanwhile - runway stays free
+            continue;
         }
+        
+        if (verbose) cout << "Arrival " << arrival->FlightNumber << " assigned to " << runway->id << endl;
+        arrival->AssignRunaway();
     }
     
-    // Step 3: Handle regular arrivals and departures based on direction
-    
-    // Process arrivals for RWY-A (North/South)
-    if (rwyA_available)
+    // Step 4: Departures onto whatever is left (departure runways first, flexible ones after) -
+    // the best one some free runway fits is claimed once its runway is leased
+    while (runwayMatcher.peek(RunwayDepartures | RunwayEastWest) != nullptr)
     {
-        Aircraft* arrival = scheduler.getNextArrival();
-        if (arrival != nullptr)
+        if (scheduler.peekDepartures(candidateWindow, fitsFreeRunway, candidates, 1) == 0)
         {
-            if (arrival->direction == Direction::North || arrival->direction == Direction::South)
-            {
-                 cout << "Arrival " << arrival->FlightNumber << " assigned to RWY-A (direction N/S)" <<  endl;
-                rwyA->tryAssign(*arrival);
-                arrival->hasRunwayAssigned = true;
-            }
-            else
-            {
-                // This shouldn't happen based on your simulation setup,
-                // but just in case, put it back in the queue
-                scheduler.addArrival(arrival);
-            }
+            break;
         }
-    }
-    
-    // Process departures for RWY-B (East/West)
-    if (rwyB_available)
-    {
-        Aircraft* departure = scheduler.getNextDeparture();
-        if (departure != nullptr)
+        
+        const IndexedHeap::Entry& candidate = candidates.front();
+        Aircraft* departure = candidate.aircraft;
+        RunwayClass* runway = runwayMatcher.claim(RunwayClass::requirementsOf(*departure));
+        if (runway == nullptr || !runway->tryAssign(*departure, runwayLeaseMs))
+        {
+            break;
+        }
+        if (!scheduler.claim(candidate))
         {
-            if (departure->direction == Direction::East || departure->direction == Direction::West)
-            {
-                 cout << "Departure " << departure->FlightNumber 
-                          << " assigned to RWY-B (direction E/W)" <<  endl;
-                rwyB->tryAssign(*departure);
-                departure->hasRunwayAssigned = true;
-            }
-            else
-            {
-                // This shouldn't happen based on your simulation setup,
-                // but just in case, put it back in the queue
-                scheduler.addDeparture(departure);
-            }
+            dropLease(runway, departure);   // Left the queue meanwhile - runway stays free
+            continue;
         }
+        
+        if (verbose) cout << "Departure " << departure->FlightNumber << " assigned to " << runway->id << endl;
+        departure->AssignRunaway();
+    }
+}
+
+// Whatever piled up since the last round is handled by one round
+unsigned ATCScontroller::handleSignals()
+{
+    long long waitedNs;
+    unsigned reasons = signal.take(waitedNs);
+    if (reasons == 0)
+    {
+        return 0;
     }
     
-    // Step 4: Use RWY-C for overflow if it's still available (FR2.3)
-    if (rwyC_available)
+    reactionNs.record(waitedNs);
+    assignRunway();
+    return reasons;
+}
+
+void ATCScontroller::runEventLoop(const std::atomic<bool>& running)
+{
+    // The timeout only bounds how long a stop takes to notice
+    while (running.load())
     {
-        // Check for any waiting arrivals first
-        Aircraft* arrival = scheduler.getNextArrival();
-        if (arrival != nullptr)
+        if (signal.wait(std::chrono::milliseconds(100)))
         {
-             cout << "Overflow arrival " << arrival->FlightNumber  << " assigned to RWY-C (overflow)" <<  endl;
-            rwyC->tryAssign(*arrival);
-            arrival->hasRunwayAssigned = true;
-        }
-        else
-        {
-            // If no arrivals, check for departures
-            Aircraft* departure = scheduler.getNextDeparture();
-            if (departure != nullptr)
-            {
-                 cout << "Overflow departure " << departure->FlightNumber << " assigned to RWY-C (overflow)" <<  endl;
-                rwyC->tryAssign(*departure);
-                departure->hasRunwayAssigned = true;
-            }
+            handleSignals();
         }
     }
 }
 
+void ATCScontroller::notifyRunwayFreed()
+{
+    signal.notify(ControllerSignal::RunwayFreed);
+}
+
+void ATCScontroller::syncAircraft(const Aircraft* aircraft)
+{
+    if (scheduler.syncAircraft(aircraft))
+    {
+        signal.notify(ControllerSignal::Emergency);
+    }
+}
+
+ControllerSignal& ATCScontroller::getSignal()
+{
+    return signal;
+}
+
+LogHistogram::Snapshot ATCScontroller::getReactionTimes() const
+{
+    return reactionNs.snapshot();
+}
+
+std::string ATCScontroller::getReactionReport() const
+{
+    LogHistogram::Snapshot times = reactionNs.snapshot();
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1) << times.count << " rounds for " << signal.getSignalCount() << " signals";
+    if (times.count > 0)
+    {
+        report << ", reaction p50 " << times.percentile(0.5) / 1000.0 << "  p90 " << times.percentile(0.9) / 1000.0
+               << "  p99 " << times.percentile(0.99) / 1000.0 << "  max " << times.max / 1000.0 << " (us)";
+    }
+    return report.str();
+}
+
 // Handle violations detected by radar monitoring
 void ATCScontroller::handleViolations()
 {
     // Delegate to the radar system to handle violations
-    const std::vector<Aircraft*>& activeFlights = scheduler.getActiveFlights();
-    radar.handleViolations(activeFlights);
+    radar.handleViolations(scheduler.getAircraftTable());
 }
 
 // Add an arrival flight to be scheduled
 void ATCScontroller::scheduleArrival(Aircraft* aircraft)
 {
-    scheduler.addArrival(aircraft);
+    scheduler.submitArrival(aircraft);  // Queued at the start of the next assignRunway()
+    signal.notify(ControllerSignal::QueueInsert);
 }
 
 // Add a departure flight to be scheduled
 void ATCScontroller::scheduleDeparture(Aircraft* aircraft)
 {
-    scheduler.addDeparture(aircraft);
+    scheduler.submitDeparture(aircraft);
+    signal.notify(ControllerSignal::QueueInsert);
+}
+
+// Drop a finished or timed-out flight from the scheduler
+void ATCScontroller::removeFlight(Aircraft* aircraft)
+{
+    // Waits for an assignment round in progress to finish
+    std::lock_guard<std::mutex> lock(controllerMutex);
+    scheduler.removeFlight(aircraft);
 }
 
 FlightsScheduler* ATCScontroller::getScheduler()
@@ -335,49 +393,45 @@ std::vector<Aircraft*> ATCScontroller::getAllActiveFlights() const
  */
 std::string ATCScontroller::getStatusText() const
 {
-    // Lock for thread safety
-    std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
-    
     std::stringstream statusText;
-    
-    // Count aircraft in different states
-    int totalActive = scheduler.getActiveFlights().size();
-    int holding = 0;
-    int landing = 0;
-    int takeoff = 0;
-    int taxiing = 0;
-    
-    // Iterate through all active flights to count states
-    for (Aircraft* aircraft : scheduler.getActiveFlights())
+    int totalActive = 0;
+    int stateCounts[8];
+    int violations = 0;
+    
+    // Counts come with the latest snapshot - no lock needed
+    WorldSnapshotBuffer::Ref snapshot;
+    if (worldSnapshots) snapshot = worldSnapshots->acquire();
+    if (snapshot)
     {
-        switch (aircraft->state)
-        {
-            case FlightState::Holding:
-                holding++;
-                break;
-            case FlightState::Approach:
-            case FlightState::Landing:
-                landing++;
-                break;
-            case FlightState::TakeoffRoll:
-            case FlightState::Climb:
-                takeoff++;
-                break;
-            case FlightState::Taxi:
-                taxiing++;
-                break;
-            default:
-                break;
-        }
+        totalActive = static_cast<int>(snapshot->aircraft.size());
+        for (int i = 0; i < 8; i++) stateCounts[i] = snapshot->stateCounts[i];
+        violations = snapshot->activeViolationCount;
+    }
+    else
+    {
+        // Lock for thread safety
+        std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
+        
+        // Count aircraft in different states (one pass over the state column)
+        const AircraftTable& table = scheduler.getAircraftTable();
+        totalActive = static_cast<int>(table.size());
+        table.countByState(stateCounts);
+        violations = table.countWithFlags(AircraftTable::FlagActiveViolation);
     }
     
+    int holding = stateCounts[static_cast<int>(FlightState::Holding)];
+    int landing = stateCounts[static_cast<int>(FlightState::Approach)] +
+                  stateCounts[static_cast<int>(FlightState::Landing)];
+    int takeoff = stateCounts[static_cast<int>(FlightState::TakeoffRoll)] +
+                  stateCounts[static_cast<int>(FlightState::Climb)];
+    int taxiing = stateCounts[static_cast<int>(FlightState::Taxi)];
+    
     // Format status text
     statusText << "ATC Status: " << totalActive << " flights active" << std::endl;
     statusText << "Holding: " << holding << " | Landing: " << landing << std::endl;
     statusText << "Takeoff: " << takeoff << " | Taxiing: " << taxiing << std::endl;
     
     // Add violation count
-    int violations = getActiveViolationsCount();
     if (violations > 0)
     {
         statusText << "VIOLATIONS: " << violations << std::endl;
@@ -402,40 +456,15 @@ Aircraft* ATCScontroller::getHighestPriorityFlight() const
         return emergencyFlight;
     }
     
-    // Check arrival queue - don't actually remove from queue, just peek
-    if (!scheduler.arrivalQueue.empty())
+    // Check arrival queue - the heap top is the highest priority arrival, just peek
+    Aircraft* arrival = scheduler.peekTopArrival();
+    if (arrival)
     {
-        // Use a copy of the queue to avoid messing with the real one
-        std::vector<Aircraft*> arrivalCopy = scheduler.arrivalQueue;
-        
-        // Sort by priority
-        std::sort(arrivalCopy.begin(), arrivalCopy.end(), 
-            [](Aircraft* a, Aircraft* b) {
-                return a->calculatePriorityScore() > b->calculatePriorityScore();
-            });
-        
-        // Return highest priority arrival
-        return arrivalCopy.front();
+        return arrival;
     }
     
-    // Check departure queue - don't actually remove from queue, just peek
-    if (!scheduler.departureQueue.empty())
-    {
-        // Use a copy of the queue to avoid messing with the real one
-        std::vector<Aircraft*> departureCopy = scheduler.departureQueue;
-        
-        // Sort by priority
-        std::sort(departureCopy.begin(), departureCopy.end(), 
-            [](Aircraft* a, Aircraft* b) {
-                return a->calculatePriorityScore() > b->calculatePriorityScore();
-            });
-        
-        // Return highest priority departure
-        return departureCopy.front();
-    }
-    
-    // No flights in queue
-    return nullptr;
+    // Check departure queue - same for departures (nullptr if no flights in queue)
+    return scheduler.peekTopDeparture();
 }
 
 /**
@@ -447,18 +476,8 @@ std::vector<Aircraft*> ATCScontroller::getFlightsByState(FlightState state) cons
     // Lock for thread safety
     std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
     
-    std::vector<Aircraft*> matchingFlights;
-    
-    // Iterate through all active flights to find matching state
-    for (Aircraft* aircraft : scheduler.getActiveFlights())
-    {
-        if (aircraft->state == state)
-        {
-            matchingFlights.push_back(aircraft);
-        }
-    }
-    
-    return matchingFlights;
+    // Only the state column is read
+    return scheduler.getAircraftTable().collectByState(state);
 }
 
 /**
@@ -470,18 +489,8 @@ std::vector<Aircraft*> ATCScontroller::getFlightsByEmergencyLevel(int emergencyL
     // Lock for thread safety
     std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
     
-    std::vector<Aircraft*> matchingFlights;
-    
-    // Iterate through all active flights to find matching emergency level
-    for (Aircraft* aircraft : scheduler.getActiveFlights())
-    {
-        if (aircraft->EmergencyNo == emergencyLevel)
-        {
-            matchingFlights.push_back(aircraft);
-        }
-    }
-    
-    return matchingFlights;
+    // Only the emergency column is read
+    return scheduler.getAircraftTable().collectByEmergencyLevel(emergencyLevel);
 }
 
 /**
@@ -493,26 +502,9 @@ std::vector<Aircraft*> ATCScontroller::getFlightsWaitingForRunway() const
     // Lock for thread safety
     std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
     
+    // Check the arrival and departure queues
     std::vector<Aircraft*> waitingFlights;
-    
-    // Check arrivals queue
-    for (Aircraft* aircraft : scheduler.arrivalQueue)
-    {
-        if (!aircraft->hasRunwayAssigned)
-        {
-            waitingFlights.push_back(aircraft);
-        }
-    }
-    
-    // Check departures queue
-    for (Aircraft* aircraft : scheduler.departureQueue)
-    {
-        if (!aircraft->hasRunwayAssigned)
-        {
-            waitingFlights.push_back(aircraft);
-        }
-    }
-    
+    scheduler.collectQueued([](const Aircraft& aircraft) { return !aircraft.hasRunwayAssigned; }, waitingFlights);
     return waitingFlights;
 }
 
@@ -522,40 +514,28 @@ std::vector<Aircraft*> ATCScontroller::getFlightsWaitingForRunway() const
  */
 int* ATCScontroller::getFlightCountsByType() const
 {
-    // Lock for thread safety
-    std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
-    
     // Static array to avoid memory leaks when returning pointer
     static int counts[5] = {0, 0, 0, 0, 0};
     
-    // Reset counts
-    for (int i = 0; i < 5; i++)
+    // Count aircraft types (indexed by AirCraftType) - from the latest snapshot if there is one
+    int byType[5];
+    WorldSnapshotBuffer::Ref snapshot;
+    if (worldSnapshots) snapshot = worldSnapshots->acquire();
+    if (snapshot)
     {
-        counts[i] = 0;
+        for (int i = 0; i < 5; i++) byType[i] = snapshot->typeCounts[i];
     }
-    
-    // Count aircraft types
-    for (Aircraft* aircraft : scheduler.getActiveFlights())
+    else
     {
-        switch (aircraft->type)
-        {
-            case AirCraftType::Commercial:
-                counts[0]++;
-                break;
-            case AirCraftType::Cargo:
-                counts[1]++;
-                break;
-            case AirCraftType::Military:
-                counts[2]++;
-                break;
-            case AirCraftType::Emergency:
-                counts[3]++;
-                break;
-            case AirCraftType::Medical:
-                counts[4]++;
-                break;
-        }
+        // Lock for thread safety
+        std::lock_guard<std::mutex> lock(const_cast<ATCScontroller*>(this)->controllerMutex);
+        scheduler.getAircraftTable().countByType(byType);
     }
+    counts[0] = byType[static_cast<int>(AirCraftType::Commercial)];
+    counts[1] = byType[static_cast<int>(AirCraftType::Cargo)];
+    counts[2] = byType[static_cast<int>(AirCraftType::Military)];
+    counts[3] = byType[static_cast<int>(AirCraftType::Emergency)];
+    counts[4] = byType[static_cast<int>(AirCraftType::Medical)];
     
     return counts;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "../include/Aircraft.h"
-#include <cstdlib>
+#include "../include/CounterRandom.h"
+#include "../include/FlightProfile.h"
 #include <algorithm>
-#include <ctime>
 using namespace std;
 
 Aircraft::Aircraft(int index, const std::string& airlineName, AirCraftType aircraftType) {
@@ -18,12 +18,17 @@ Aircraft::Aircraft(int index, const std::string& airlineName, AirCraftType aircr
     speed = 0;
     EmergencyNo = 0;
     HasViolation = false;
+    hasActiveViolation = false;
     isFaulty = false;
     isActive = false;
     x_position = -1;
     y_position = -1;
-    queueEntryTime = 0;
+    queueEntryTime = -1;
     hasRunwayAssigned = false;
+    assignedRunway = -1;
+    runwayLease = noRunwayLease;
+    randomKey = CounterRandom::keyFor(airlineName, index);
+    tableHandle = invalidAircraftHandle;
 }
 
 // Destructor for aircraft class
@@ -38,91 +43,47 @@ void Aircraft::SimulateStep() {
     checkForEmergency();
 }
 
-// Update aircraft speed based on its current state
+// Update aircraft speed based on its current state (rules come from the FlightProfile table)
 void Aircraft::UpdateSpeed() {
-    // Speed update logic based on flight state
-    switch(state) {
-        case FlightState::Holding:
-            speed = 400 + rand() % 201; // 400-600 km/h
-            break;
-        case FlightState::Approach:
-            speed = 240 + rand() % 51;  // 240-290 km/h
-            break;
-        case FlightState::Landing:
-            speed = max(30, speed - 20); // Gradually decelerate to 30 km/h
-            break;
-        case FlightState::Taxi:
-            speed = 15 + rand() % 16;    // 15-30 km/h
-            break;
-        case FlightState::AtGate:
-            speed = rand() % 6;          // 0-5 km/h
-            break;
-        case FlightState::TakeoffRoll:
-            speed = min(290, speed + 15); // Accelerate up to 290 km/h
-            break;
-        case FlightState::Climb:
-            speed = 250 + rand() % 214;   // 250-463 km/h
-            break;
-        case FlightState::Cruise:
-            speed = 800 + rand() % 101;   // 800-900 km/h
-            break;
-    }
+    const PhaseProfile& phase = FlightProfile::get(type, state);
+    speed = FlightProfile::nextSpeed(phase, speed, randomRange(0, phase.drawMin, phase.drawMax));
 }
 
-// Check if aircraft is violating speed limits based on its current state
+// Check if aircraft is violating the speed envelope of its current state
 void Aircraft::checkForViolation() {
-    HasViolation = false;
-    
-    switch(state) {
-        case FlightState::Holding:
-            if (speed > 600) HasViolation = true;
-            break;
-        case FlightState::Approach:
-            if (speed < 240 || speed > 290) HasViolation = true;
-            break;
-        case FlightState::Landing:
-            if (speed > 240 || (speed < 30 && state == FlightState::Landing)) HasViolation = true;
-            break;
-        case FlightState::Taxi:
-            if (speed > 30) HasViolation = true;
-            break;
-        case FlightState::AtGate:
-            if (speed > 10) HasViolation = true;
-            break;
-        case FlightState::TakeoffRoll:
-            if (speed > 290) HasViolation = true;
-            break;
-        case FlightState::Climb:
-            if (speed > 463) HasViolation = true;
-            break;
-        case FlightState::Cruise:
-            if (speed < 800 || speed > 900) HasViolation = true;
-            break;
-    }
+    HasViolation = FlightProfile::violates(FlightProfile::get(type, state), speed);
 }
 
 // Randomly generate emergency based on flight direction
 void Aircraft::checkForEmergency() {
-    int chance = rand() % 100;
-    
     if (EmergencyNo > 0) return; // Already in emergency
     
+    int chance = randomRange(1, 0, 99);
+    int level = randomRange(2, 1, 3); // Random emergency 1-3
+    
     switch(direction) {
         case Direction::North: // International Arrivals - 10%
-            if (chance < 10) EmergencyNo = 1 + rand() % 3; // Random emergency 1-3
+            if (chance < 10) EmergencyNo = level;
             break;
         case Direction::South: // Domestic Arrivals - 5%
-            if (chance < 5) EmergencyNo = 1 + rand() % 3;
+            if (chance < 5) EmergencyNo = level;
             break;
         case Direction::East: // International Departures - 15%
-            if (chance < 15) EmergencyNo = 1 + rand() % 3;
+            if (chance < 15) EmergencyNo = level;
             break;
         case Direction::West: // Domestic Departures - 20%
-            if (chance < 20) EmergencyNo = 1 + rand() % 3;
+            if (chance < 20) EmergencyNo = level;
             break;
     }
 }
 
+// Draw from this aircraft's random stream - keyed by the simulated millisecond,
+// so the result doesn't depend on which thread gets here first
+int Aircraft::randomRange(int slot, int minValue, int maxValue) const {
+    unsigned long long tick = static_cast<unsigned long long>(SimClock::instance().now());
+    return CounterRandom::range(randomKey, (tick << 4) | static_cast<unsigned long long>(slot), minValue, maxValue);
+}
+
 // Check if aircraft is in an airborne state
 bool Aircraft::isinAir() const {
     return (state == FlightState::Holding || state == FlightState::Approach || 
@@ -148,13 +109,34 @@ void Aircraft::RequestRunawayAssignment() {
 
 }
 
-// Assign a runway to this aircraft
+// Assign a runway to this aircraft and wake up whoever is waiting on it.
+// A waiter marks the assignment itself, under the lock its readers take.
 void Aircraft::AssignRunaway() {
+    if (onRunwayAssigned) {
+        onRunwayAssigned(this);
+    } else {
+        hasRunwayAssigned = true;
+    }
 }
 
 // Calculate priority score for flight scheduling
 // Higher score = higher priority (easier to understand this way)
 int Aircraft::calculatePriorityScore() const {
+    int score = staticPriority();
+    
+    // 3. Wait time factor - The longer you wait, the angrier you get
+    // This implements FCFS within same priority class (FR5.1)
+    if (queueEntryTime >= 0) {
+        SimTime currentTime = SimClock::instance().now();
+        int waitTime = static_cast<int>((currentTime - queueEntryTime) / 1000);
+        score += waitTime;  // 1 point per second of waiting
+    }
+    
+    return score;
+}
+
+// The part of the score that doesn't depend on how long we've waited
+int Aircraft::staticPriority() const {
     int score = 0;
     
     // ================ PRIORITY FACTORS ================
@@ -188,17 +170,21 @@ int Aircraft::calculatePriorityScore() const {
             break;
     }
     
-    // 3. Wait time factor - The longer you wait, the angrier you get
-    // This implements FCFS within same priority class (FR5.1)
-    if (queueEntryTime > 0) {
-        time_t currentTime = time(NULL);
-        int waitTime = static_cast<int>(currentTime - queueEntryTime);
-        score += waitTime;  // 1 point per second of waiting
-    }
-    
     return score;
 }
 
+// Aging without the clock: every queued aircraft gains 1 point per second at
+// the same rate, so comparing static * 1000 + (now - entry) between two
+// aircraft is the same as comparing static * 1000 - entry. The key never
+// changes while waiting and is exact to the millisecond (no rounding ties).
+long long Aircraft::priorityKey() const {
+    long long key = static_cast<long long>(staticPriority()) * 1000;
+    if (queueEntryTime >= 0) {
+        key -= queueEntryTime;
+    }
+    return key;
+}
+
 //Have to determine the appropiate spot to call this function
 void Aircraft::updatePosition() {
     // Update the position of the aircraft based on its speed and direction
@@ -216,6 +202,10 @@ void Aircraft::updatePosition() {
 
 // Get current state name as string (for UI display)
 std::string Aircraft::getStateName() const {
+    return stateName(state);
+}
+
+std::string Aircraft::stateName(FlightState state) {
     switch (state) {
         case FlightState::Holding: return "Holding";
         case FlightState::Approach: return "Approaching";
@@ -236,22 +226,27 @@ std::string Aircraft::getStateName() const {
  * Returns a formatted string with flight number and current state
  */
 std::string Aircraft::getDisplayName() const 
+{
+    return displayName(FlightNumber, state, EmergencyNo, HasViolation || hasActiveViolation);
+}
+
+std::string Aircraft::displayName(const std::string& flightNumber, FlightState state, int emergencyLevel, bool violation)
 {
     // Format: "PIA-1: Taxiing" or "PIA-1 [EMERG]: Landing"
-    std::string displayName = FlightNumber;
+    std::string displayName = flightNumber;
     
     // Add emergency indicator if applicable
-    if (EmergencyNo > 0) {
+    if (emergencyLevel > 0) {
         displayName += " [EMERG]";
     }
     
     // Add violation indicator if applicable
-    if (HasViolation || hasActiveViolation) {
+    if (violation) {
         displayName += " [VIOL]";
     }
     
     // Add state
-    displayName += ": " + getStateName();
+    displayName += ": " + stateName(state);
     
     return displayName;
 }
@@ -278,6 +273,11 @@ std::string Aircraft::getStatusText() const
  * Maps the aircraft direction to degrees for SFML sprite rotation
  */
 float Aircraft::getRotationAngle() const 
+{
+    return rotationAngle(direction);
+}
+
+float Aircraft::rotationAngle(Direction direction)
 {
     // Map direction to rotation angle
     // Note: SFML uses counterclockwise rotation with 0 pointing right
@@ -317,21 +317,26 @@ int* Aircraft::getStatusColor() const
 {
     // Allocate a static array to avoid memory leaks
     static int color[3];
-    
+    statusColor(state, EmergencyNo, HasViolation || hasActiveViolation, color);
+    return color;
+}
+
+void Aircraft::statusColor(FlightState state, int emergencyLevel, bool violation, int color[3])
+{
     // Emergency aircraft are always red
-    if (EmergencyNo > 0) {
+    if (emergencyLevel > 0) {
         color[0] = 255; // R
         color[1] = 0;   // G
         color[2] = 0;   // B
-        return color;
+        return;
     }
     
     // Violation aircraft are yellow
-    if (HasViolation || hasActiveViolation) {
+    if (violation) {
         color[0] = 255; // R
         color[1] = 255; // G
         color[2] = 0;   // B
-        return color;
+        return;
     }
     
     // State-specific colors
@@ -364,8 +369,6 @@ int* Aircraft::getStatusColor() const
             color[1] = 255; // G
             color[2] = 255; // B
     }
-    
-    return color;
 }
 
 /**
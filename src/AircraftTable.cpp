@@ -0,0 +1,248 @@
+#include "../include/AircraftTable.h"
+#include "../include/Aircraft.h"
+
+const int AircraftTable::blockBits;
+const size_t AircraftTable::blockSize;
+const size_t AircraftTable::maxBlocks;
+
+AircraftTable::AircraftTable()
+    : rowCount(0), liveCount(0)
+{
+    blocks.reserve(maxBlocks);
+}
+
+/**
+ * Reuse a freed row if there is one, otherwise take the next row
+ * (allocating a new block when the last one is full)
+ */
+AircraftHandle AircraftTable::insert(Aircraft* aircraft)
+{
+    std::lock_guard<std::mutex> lock(structureMutex);
+
+    AircraftHandle handle;
+    if (!freeRows.empty())
+    {
+        handle = freeRows.back();
+        freeRows.pop_back();
+    }
+    else
+    {
+        size_t row = rowCount.load();
+        if (row >= maxBlocks * blockSize)
+        {
+            return invalidAircraftHandle;
+        }
+        if (row / blockSize >= blocks.size())
+        {
+            blocks.emplace_back(new Block());
+        }
+
+        // Row is filled in below, before anyone can read FlagLive
+        Block& block = *blocks[row / blockSize];
+        block.flags[row % blockSize] = 0;
+        handle = static_cast<AircraftHandle>(row);
+        rowCount.store(row + 1, std::memory_order_release);
+    }
+
+    // Filled in under the lock so forEachBlockLocked() never sees a half-made row
+    aircraft->tableHandle = handle;
+    blocks[handle >> blockBits]->aircraft[handle & (blockSize - 1)] = aircraft;
+    update(*aircraft);
+    liveCount++;
+    return handle;
+}
+
+void AircraftTable::remove(Aircraft* aircraft)
+{
+    AircraftHandle handle = aircraft->tableHandle;
+    if (handle == invalidAircraftHandle) return;
+
+    std::lock_guard<std::mutex> lock(structureMutex);
+    Block& block = *blocks[handle >> blockBits];
+    size_t row = handle & (blockSize - 1);
+    block.flags[row] = 0;
+    block.aircraft[row] = nullptr;
+    block.generation[row]++;            // Outstanding AircraftRefs go stale
+    aircraft->tableHandle = invalidAircraftHandle;
+    freeRows.push_back(handle);
+    liveCount--;
+}
+
+void AircraftTable::update(const Aircraft& aircraft)
+{
+    AircraftHandle handle = aircraft.tableHandle;
+    if (handle == invalidAircraftHandle) return;
+
+    Block& block = *blocks[handle >> blockBits];
+    size_t row = handle & (blockSize - 1);
+
+    block.state[row] = static_cast<unsigned char>(aircraft.state);
+    block.type[row] = static_cast<unsigned char>(aircraft.type);
+    block.direction[row] = static_cast<unsigned char>(aircraft.direction);
+    block.emergency[row] = static_cast<unsigned char>(aircraft.EmergencyNo);
+    block.speed[row] = aircraft.speed;
+    block.x[row] = aircraft.x_position;
+    block.y[row] = aircraft.y_position;
+    block.queueEntry[row] = aircraft.queueEntryTime;
+    block.flags[row] = flagsOf(aircraft);
+}
+
+unsigned char AircraftTable::flagsOf(const Aircraft& aircraft)
+{
+    unsigned char flags = FlagLive;
+    if (aircraft.HasViolation) flags |= FlagViolation;
+    if (aircraft.hasActiveViolation) flags |= FlagActiveViolation;
+    if (aircraft.isFaulty) flags |= FlagFaulty;
+    if (aircraft.isActive) flags |= FlagActive;
+    if (aircraft.hasRunwayAssigned) flags |= FlagRunwayAssigned;
+    return flags;
+}
+
+void AircraftTable::setFlags(AircraftHandle handle, unsigned char bits, bool on)
+{
+    if (handle == invalidAircraftHandle) return;
+
+    unsigned char& flags = blocks[handle >> blockBits]->flags[handle & (blockSize - 1)];
+    flags = on ? (flags | bits) : (flags & ~bits);
+}
+
+Aircraft* AircraftTable::get(AircraftHandle handle) const
+{
+    if (handle == invalidAircraftHandle || handle >= rowCount.load()) return nullptr;
+    return blocks[handle >> blockBits]->aircraft[handle & (blockSize - 1)];
+}
+
+AircraftRef AircraftTable::refOf(const Aircraft* aircraft) const
+{
+    AircraftRef ref;
+    ref.handle = aircraft->tableHandle;
+    ref.generation = 0;
+    if (ref.handle != invalidAircraftHandle)
+    {
+        std::lock_guard<std::mutex> lock(structureMutex);
+        ref.generation = blocks[ref.handle >> blockBits]->generation[ref.handle & (blockSize - 1)];
+    }
+    return ref;
+}
+
+Aircraft* AircraftTable::resolve(const AircraftRef& ref) const
+{
+    if (ref.handle == invalidAircraftHandle || ref.handle >= rowCount.load()) return nullptr;
+
+    // Under the lock so the row can't be freed between the two reads
+    std::lock_guard<std::mutex> lock(structureMutex);
+    const Block& block = *blocks[ref.handle >> blockBits];
+    size_t row = ref.handle & (blockSize - 1);
+    if (block.generation[row] != ref.generation || !(block.flags[row] & FlagLive)) return nullptr;
+    return block.aircraft[row];
+}
+
+int AircraftTable::getEmergencyLevel(AircraftHandle handle) const
+{
+    if (handle == invalidAircraftHandle || handle >= rowCount.load()) return 0;
+    return blocks[handle >> blockBits]->emergency[handle & (blockSize - 1)];
+}
+
+size_t AircraftTable::size() const
+{
+    return liveCount.load();
+}
+
+size_t AircraftTable::capacity() const
+{
+    return rowCount.load();
+}
+
+std::vector<Aircraft*> AircraftTable::collectByState(FlightState state) const
+{
+    unsigned char wanted = static_cast<unsigned char>(state);
+    return collect([wanted](const Block& block, size_t r) { return block.state[r] == wanted; });
+}
+
+std::vector<Aircraft*> AircraftTable::collectByType(AirCraftType type) const
+{
+    unsigned char wanted = static_cast<unsigned char>(type);
+    return collect([wanted](const Block& block, size_t r) { return block.type[r] == wanted; });
+}
+
+std::vector<Aircraft*> AircraftTable::collectByEmergencyLevel(int level) const
+{
+    return collect([level](const Block& block, size_t r) { return block.emergency[r] == level; });
+}
+
+std::vector<Aircraft*> AircraftTable::collectEmergencies() const
+{
+    return collect([](const Block& block, size_t r) { return block.emergency[r] > 0; });
+}
+
+std::vector<Aircraft*> AircraftTable::collectWithFlags(unsigned char bits) const
+{
+    return collect([bits](const Block& block, size_t r) { return (block.flags[r] & bits) != 0; });
+}
+
+int AircraftTable::countWithFlags(unsigned char bits) const
+{
+    int count = 0;
+    forEachBlock([&](const Block& block, size_t rows) {
+        for (size_t r = 0; r < rows; r++)
+        {
+            if ((block.flags[r] & FlagLive) && (block.flags[r] & bits)) count++;
+        }
+    });
+    return count;
+}
+
+int AircraftTable::countEmergencies() const
+{
+    int count = 0;
+    forEachBlock([&](const Block& block, size_t rows) {
+        for (size_t r = 0; r < rows; r++)
+        {
+            if ((block.flags[r] & FlagLive) && block.emergency[r] > 0) count++;
+        }
+    });
+    return count;
+}
+
+void AircraftTable::countByState(int counts[8]) const
+{
+    for (int i = 0; i < 8; i++) counts[i] = 0;
+    forEachBlock([&](const Block& block, size_t rows) {
+        for (size_t r = 0; r < rows; r++)
+        {
+            if (block.flags[r] & FlagLive) counts[block.state[r]]++;
+        }
+    });
+}
+
+void AircraftTable::countByType(int counts[5]) const
+{
+    for (int i = 0; i < 5; i++) counts[i] = 0;
+    forEachBlock([&](const Block& block, size_t rows) {
+        for (size_t r = 0; r < rows; r++)
+        {
+            if (block.flags[r] & FlagLive) counts[block.type[r]]++;
+        }
+    });
+}
+
+/**
+ * First live aircraft within radius of (x, y) - only the position columns are read
+ */
+Aircraft* AircraftTable::findAt(int x, int y, int radius) const
+{
+    Aircraft* found = nullptr;
+    int radiusSquared = radius * radius;
+    forEachBlock([&](const Block& block, size_t rows) {
+        for (size_t r = 0; r < rows && !found; r++)
+        {
+            int dx = block.x[r] - x;
+            int dy = block.y[r] - y;
+            if ((block.flags[r] & FlagLive) && dx * dx + dy * dy <= radiusSquared)
+            {
+                found = block.aircraft[r];
+            }
+        }
+    });
+    return found;
+}
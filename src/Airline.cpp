@@ -7,6 +7,7 @@ Airline::Airline() {
     type = AirCraftType::Commercial;
     activeFlights = 0;
     maxFlights = 0;
+    weight = 1.0;
 }
 
 // Check if airline can schedule more flights
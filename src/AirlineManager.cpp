@@ -1,11 +1,11 @@
 #include "../include/AirlineManager.h"
-#include <cstdlib>  // For rand()
-#include <ctime>    // For time()
+#include "../include/CounterRandom.h"
 
 /**
  * Constructor initializes empty airlines collection
  */
 AirlineManager::AirlineManager() 
+    : randomCounter(0)
 {
     // Nothing to initialize here - airlines will be created in initialize()
 }
@@ -26,7 +26,7 @@ AirlineManager::~AirlineManager()
  * Initialize all airlines with predefined configurations
  * Creates the six standard airlines with their aircraft
  */
-void AirlineManager::initialize() 
+void AirlineManager::initialize(int totalAircraft) 
 {
     // Clear any existing airlines
     for (auto airline : airlines) {
@@ -79,10 +79,41 @@ void AirlineManager::initialize()
     // Add all airlines to collection
     airlines = {pia, airBlue, fedEx, pakAirforce, blueDart, aghaKhanAir};
     
+    // Standard fleet sizes - the reserve() calls above add up to 20 aircraft
+    const int standardFleet[] = {6, 4, 3, 2, 2, 3};
+    const int standardTotal = 20;
+    
+    // Fair scheduling shares the runways in the same proportion as the standard fleets
+    for (size_t i = 0; i < airlines.size(); ++i) 
+    {
+        airlines[i]->weight = standardFleet[i];
+    }
+    
+    // Scale the fleets when a different total is requested (headless engine runs)
+    std::vector<int> fleetSizes(airlines.size());
+    int assigned = 0;
+    for (size_t i = 0; i < airlines.size(); ++i) 
+    {
+        fleetSizes[i] = static_cast<int>(static_cast<long long>(totalAircraft) * standardFleet[i] / standardTotal);
+        assigned += fleetSizes[i];
+    }
+    
+    // Hand out whatever rounding left over, one aircraft per airline
+    for (size_t i = 0; assigned < totalAircraft; i = (i + 1) % airlines.size()) 
+    {
+        fleetSizes[i]++;
+        assigned++;
+    }
+    
     // Initialize each aircraft in each airline
-    for (auto airline : airlines) 
+    for (size_t a = 0; a < airlines.size(); ++a) 
     {
-        for (int i = 0; i < static_cast<int>(airline->aircrafts.capacity()); ++i) 
+        Airline* airline = airlines[a];
+        
+        // The vector must not reallocate later - flights hold pointers to its aircraft
+        airline->aircrafts.reserve(fleetSizes[a]);
+        
+        for (int i = 0; i < fleetSizes[a]; ++i) 
         {
             // Create an aircraft with the airline's info
             airline->aircrafts.emplace_back(i, airline->name, airline->type);
@@ -120,6 +151,7 @@ Airline* AirlineManager::getRandomAirline()
         return nullptr;
     }
     
-    int randomIndex = rand() % airlines.size();
+    static const unsigned long long key = CounterRandom::keyFor("AirlineManager::getRandomAirline", 0);
+    int randomIndex = CounterRandom::range(key, randomCounter++, 0, static_cast<int>(airlines.size()) - 1);
     return airlines[randomIndex];
 }
\ No newline at end of file
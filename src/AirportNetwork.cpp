@@ -0,0 +1,284 @@
+#include "../include/AirportNetwork.h"
+#include "../include/CounterRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <thread>
+
+static const double cruiseSpeedKmh = 800.0;         // Ground speed between airports
+static const SimTime climbAndDescentMs = 20 * 60000; // Added to every flight on top of the cruise
+static const SimTime turnaroundMs = 45 * 60000;     // At the gate before the next leg
+
+AirportNetwork::Airport::Airport()
+    : x(0.0), y(0.0), cpu(-1), clock(ClockMode::AsFastAsPossible), departures(0), arrivals(0), timeouts(0)
+{
+}
+
+AirportNetwork::AirportNetwork()
+    : lookahead(0), windows(0), handoffs(0), overflows(0)
+{
+}
+
+AirportNetwork::~AirportNetwork()
+{
+    stop();
+}
+
+/**
+ * Lay the airports out on a square grid and give each its own components.
+ * Setup runs on this thread, so bind it to each airport's clock while that
+ * airport's parts read the time.
+ */
+void AirportNetwork::initialize(int airportCount, int runwaysPerAirport, double spacingKm, bool pinCores)
+{
+    int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(airportCount)))));
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+
+    for (int i = 0; i < airportCount; i++)
+    {
+        airports.emplace_back();
+        Airport& airport = airports.back();
+
+        char code[16];
+        std::snprintf(code, sizeof(code), "AP%02d", i);
+        airport.code = code;
+        airport.x = (i % columns) * spacingKm;
+        airport.y = (i / columns) * spacingKm;
+        airport.cpu = (pinCores && cores > 0) ? i % cores : -1;
+
+        SimClock::bindThread(&airport.clock);
+        airport.runways.initialize(runwaysPerAirport);
+        airport.controller.setRunwayManager(&airport.runways);
+        airport.controller.setVerbose(false);
+
+        airport.engine.reset(new SimulationEngine(&airport.controller, &airport.runways, &airport.clock));
+        airport.engine->setStepInterval(0);     // Flights move by phase events only - no step pool per airport
+        airport.engine->setControllerEvents(true);
+        airport.engine->setCpuAffinity(airport.cpu);
+        airport.engine->setHorizon(0);          // Nothing runs until run() opens the first window
+        airport.engine->setFlightFinishedListener([this, i](Aircraft* aircraft, bool timedOut) {
+            flightFinished(i, aircraft, timedOut);
+        });
+    }
+    SimClock::bindThread(nullptr);
+
+    // Neighbours on the grid are the closest pair
+    lookahead = std::numeric_limits<SimTime>::max();
+    for (int from = 0; from < airportCount; from++)
+    {
+        for (int to = from + 1; to < airportCount; to++)
+        {
+            lookahead = std::min(lookahead, flightTime(from, to));
+        }
+    }
+    if (airportCount < 2) lookahead = climbAndDescentMs;
+}
+
+void AirportNetwork::addFlight(Aircraft* aircraft, int homeAirport, SimTime delayMs, int legs)
+{
+    itineraries[aircraft] = Itinerary{pickDestination(aircraft, homeAirport, legs), legs};
+    airports[homeAirport].engine->addFlight(aircraft, delayMs, false);
+}
+
+bool AirportNetwork::start()
+{
+    bool started = true;
+    for (auto& airport : airports)
+    {
+        started = airport.engine->start(1) && started;
+    }
+    return started;
+}
+
+/**
+ * One window at a time: deliver the flights that arrive from now on, let
+ * every airport run to the end of the window on its own thread, wait for
+ * all of them. A flight handed off during the window departed at or after
+ * its start, so it arrives a lookahead later at the earliest - in a window
+ * that hasn't started yet.
+ */
+void AirportNetwork::run()
+{
+    SimTime windowStart = 0;
+    while (true)
+    {
+        bool active = false;
+        for (auto& airport : airports)
+        {
+            deliver(airport, windowStart);
+            active = active || airport.engine->getActiveFlightCount() > 0;
+        }
+        if (!active) break;
+
+        windowStart += lookahead;
+        for (auto& airport : airports)
+        {
+            airport.engine->setHorizon(windowStart);
+        }
+        for (auto& airport : airports)
+        {
+            airport.engine->waitForHorizon();
+        }
+        windows++;
+    }
+}
+
+void AirportNetwork::stop()
+{
+    for (auto& airport : airports)
+    {
+        airport.engine->stop();
+    }
+}
+
+SimTime AirportNetwork::flightTime(int from, int to) const
+{
+    double dx = airports[from].x - airports[to].x;
+    double dy = airports[from].y - airports[to].y;
+    double hours = std::sqrt(dx * dx + dy * dy) / cruiseSpeedKmh;
+    return climbAndDescentMs + static_cast<SimTime>(hours * 3600000.0);
+}
+
+SimTime AirportNetwork::getLookahead() const
+{
+    return lookahead;
+}
+
+int AirportNetwork::getAirportCount() const
+{
+    return static_cast<int>(airports.size());
+}
+
+AirportNetwork::Airport& AirportNetwork::getAirport(int index)
+{
+    return airports[index];
+}
+
+const AirportNetwork::Airport& AirportNetwork::getAirport(int index) const
+{
+    return airports[index];
+}
+
+unsigned long long AirportNetwork::getWindowCount() const
+{
+    return windows.load();
+}
+
+unsigned long long AirportNetwork::getHandoffCount() const
+{
+    return handoffs.load();
+}
+
+unsigned long long AirportNetwork::getOverflowCount() const
+{
+    return overflows.load();
+}
+
+int AirportNetwork::getCompletedFlightCount() const
+{
+    int completed = 0;
+    for (const auto& airport : airports) completed += airport.engine->getCompletedFlightCount();
+    return completed;
+}
+
+int AirportNetwork::getTimedOutFlightCount() const
+{
+    int timedOut = 0;
+    for (const auto& airport : airports) timedOut += airport.engine->getTimedOutFlightCount();
+    return timedOut;
+}
+
+unsigned long long AirportNetwork::getProcessedEventCount() const
+{
+    unsigned long long processed = 0;
+    for (const auto& airport : airports) processed += airport.engine->getProcessedEventCount();
+    return processed;
+}
+
+SimTime AirportNetwork::getSimulatedTime() const
+{
+    SimTime latest = 0;
+    for (const auto& airport : airports) latest = std::max(latest, airport.clock.now());
+    return latest;
+}
+
+int AirportNetwork::pickDestination(const Aircraft* aircraft, int origin, int legsLeft) const
+{
+    int count = static_cast<int>(airports.size());
+    if (count < 2) return origin;
+
+    int destination = CounterRandom::range(aircraft->randomKey, 0x4e00 + legsLeft, 0, count - 2);
+    return destination >= origin ? destination + 1 : destination;
+}
+
+/**
+ * Runs on the airport's own thread. A departure that reached cruise flies on
+ * to its destination; an arrival at the gate turns around for its next leg
+ * or is done. A flight that timed out waiting for a runway is done too.
+ */
+void AirportNetwork::flightFinished(int airport, Aircraft* aircraft, bool timedOut)
+{
+    Airport& here = airports[airport];
+    Itinerary& trip = itineraries.find(aircraft)->second;
+    if (timedOut)
+    {
+        here.timeouts++;
+        return;
+    }
+
+    if (aircraft->state == FlightState::Cruise)
+    {
+        here.departures++;
+        handOff(trip.destination, HandoffRing::Handoff{aircraft, airport,
+                                                       here.clock.now() + flightTime(airport, trip.destination)});
+        return;
+    }
+
+    here.arrivals++;
+    trip.legsLeft--;
+    if (trip.legsLeft > 0)
+    {
+        trip.destination = pickDestination(aircraft, airport, trip.legsLeft);
+        here.engine->addFlight(aircraft, turnaroundMs, false);
+    }
+}
+
+// A full ring is rare (it holds a window's worth of handoffs) - fall back to a lock
+void AirportNetwork::handOff(int destination, const HandoffRing::Handoff& handoff)
+{
+    Airport& there = airports[destination];
+    if (there.inbound.push(handoff)) return;
+
+    overflows++;
+    std::lock_guard<std::mutex> lock(there.overflowMutex);
+    there.overflow.push_back(handoff);
+}
+
+/**
+ * Every airport is idle at the window boundary, so nothing is pushing and
+ * its clock sits at 'now'. The flights are queued by arrival time and
+ * origin (each origin pushes in its own order), so the run doesn't depend
+ * on how the airports' threads interleaved.
+ */
+void AirportNetwork::deliver(Airport& airport, SimTime now)
+{
+    airport.delivering.clear();
+    airport.inbound.drain(airport.delivering);
+    {
+        std::lock_guard<std::mutex> lock(airport.overflowMutex);
+        airport.delivering.insert(airport.delivering.end(), airport.overflow.begin(), airport.overflow.end());
+        airport.overflow.clear();
+    }
+    std::stable_sort(airport.delivering.begin(), airport.delivering.end(),
+                     [](const HandoffRing::Handoff& a, const HandoffRing::Handoff& b) {
+                         if (a.arrivalTime != b.arrivalTime) return a.arrivalTime < b.arrivalTime;
+                         return a.origin < b.origin;
+                     });
+
+    for (const HandoffRing::Handoff& handoff : airport.delivering)
+    {
+        airport.engine->addFlight(handoff.aircraft, std::max<SimTime>(0, handoff.arrivalTime - now), true);
+    }
+    handoffs += airport.delivering.size();
+}
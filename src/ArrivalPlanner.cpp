@@ -0,0 +1,432 @@
+#include "../include/ArrivalPlanner.h"
+#include <algorithm>
+#include <climits>
+
+const int ArrivalPlanner::maxShiftLimit;
+
+static const long long unreachable = LLONG_MAX;
+
+static int bitCount(unsigned int mask)
+{
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) count++;
+    return count;
+}
+
+ArrivalPlanner::ArrivalPlanner(int maxShift, size_t horizon)
+    : shiftLimit(std::max(0, std::min(maxShift, maxShiftLimit))), horizonSize(horizon),
+      round(0), layersComputed(0), layersReused(0)
+{
+    // A state says which flights of the window [p - k, p + k) have landed after p landings -
+    // always k of them, since everything below the window has landed and nothing above it
+    unsigned int masks = 1u << (2 * shiftLimit);
+    stateOf.assign(masks, -1);
+    for (unsigned int mask = 0; mask < masks; mask++)
+    {
+        if (bitCount(mask) == shiftLimit)
+        {
+            stateOf[mask] = static_cast<int>(stateMasks.size());
+            stateMasks.push_back(mask);
+        }
+    }
+}
+
+void ArrivalPlanner::setRunways(const std::vector<int>& runwayIndices)
+{
+    runways = runwayIndices;
+    lanes.clear();
+    for (int runway : runways)
+    {
+        Lane lane;
+        lane.runway = runway;
+        lane.freeAt = 0;
+        lane.validLayers = 0;
+        lane.stale = false;
+        lane.head = 0;
+        lanes.push_back(lane);
+    }
+    std::fill(laneOf.begin(), laneOf.end(), -1);
+}
+
+const std::vector<int>& ArrivalPlanner::getRunways() const
+{
+    return runways;
+}
+
+size_t ArrivalPlanner::getHorizon() const
+{
+    return horizonSize;
+}
+
+int ArrivalPlanner::getMaxShift() const
+{
+    return shiftLimit;
+}
+
+void ArrivalPlanner::plan(const std::vector<Flight>& queued, const std::vector<SimTime>& runwayFree,
+                          const ServiceTimeModel& serviceModel)
+{
+    if (lanes.empty()) return;
+    round++;
+
+    size_t count = std::min(queued.size(), horizonSize);
+    for (size_t i = 0; i < count; i++)
+    {
+        track(queued[i].handle);
+        seenIn[queued[i].handle] = round;
+    }
+
+    // Flights that left the queue (or the horizon) give up their lane
+    std::vector<SimTime> finish(lanes.size());
+    for (size_t l = 0; l < lanes.size(); l++)
+    {
+        Lane& lane = lanes[l];
+        lane.freeAt = l < runwayFree.size() ? runwayFree[l] : SimClock::instance().now();
+        finish[l] = lane.freeAt;
+        for (const Member& member : lane.members)
+        {
+            if (seenIn[member.flight.handle] != round) laneOf[member.flight.handle] = -1;
+        }
+    }
+
+    // Each lane's flights in queue order - a newcomer joins the lane that would finish first
+    std::vector<std::vector<Member>> incoming(lanes.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        const Flight& flight = queued[i];
+        int l = laneOf[flight.handle];
+        if (l < 0)
+        {
+            l = static_cast<int>(std::min_element(finish.begin(), finish.end()) - finish.begin());
+            laneOf[flight.handle] = l;
+            serviceOf[flight.handle] = serviceModel.getServiceTime(lanes[l].runway, flight.type);
+        }
+
+        Member member;
+        member.flight = flight;
+        member.service = serviceOf[flight.handle];
+        incoming[l].push_back(member);
+        finish[l] += member.service;
+    }
+
+    for (size_t l = 0; l < lanes.size(); l++)
+    {
+        Lane& lane = lanes[l];
+        std::vector<Member>& members = incoming[l];
+
+        // First place where the lane's flights differ from the last plan
+        size_t same = 0;
+        while (same < members.size() && same < lane.members.size())
+        {
+            const Member& a = members[same];
+            const Member& b = lane.members[same];
+            if (a.flight.handle != b.flight.handle || a.flight.aircraft != b.flight.aircraft ||
+                a.flight.key != b.flight.key || a.flight.priority != b.flight.priority) break;
+            same++;
+        }
+        bool unchanged = same == members.size() && same == lane.members.size();
+        lane.members.swap(members);
+
+        if (unchanged && !lane.stale)
+        {
+            retime(lane);
+            continue;
+        }
+
+        // Position p has only looked at flights below p - 1 + k, so those up to same - k still hold
+        if (lane.stale)
+        {
+            lane.validLayers = 0;
+        }
+        else if (lane.validLayers > 0)
+        {
+            long long keep = static_cast<long long>(same) - shiftLimit + 1;
+            lane.validLayers = std::min(lane.validLayers, static_cast<size_t>(std::max(1LL, keep)));
+        }
+        solve(lane);
+    }
+}
+
+const ArrivalPlanner::Slot* ArrivalPlanner::next(int runwayIndex) const
+{
+    int l = laneIndex(runwayIndex);
+    if (l < 0) return nullptr;
+
+    const Lane& lane = lanes[l];
+    return lane.head < lane.sequence.size() ? &lane.sequence[lane.head] : nullptr;
+}
+
+// Like a TaskPool worker out of tasks: an idle runway takes the next flight of the runway
+// whose plan runs longest, instead of standing idle while its own plan is empty
+const ArrivalPlanner::Slot* ArrivalPlanner::steal(int runwayIndex)
+{
+    int thief = laneIndex(runwayIndex);
+    if (thief < 0) return nullptr;
+    if (lanes[thief].head < lanes[thief].sequence.size()) return &lanes[thief].sequence[lanes[thief].head];
+
+    int victim = -1;
+    SimTime latest = 0;
+    for (size_t l = 0; l < lanes.size(); l++)
+    {
+        const Lane& lane = lanes[l];
+        if (static_cast<int>(l) == thief || lane.head >= lane.sequence.size()) continue;
+
+        SimTime end = lane.sequence.back().start + lane.sequence.back().service;
+        if (victim < 0 || end > latest)
+        {
+            victim = static_cast<int>(l);
+            latest = end;
+        }
+    }
+    if (victim < 0) return nullptr;
+
+    Slot slot = lanes[victim].sequence[lanes[victim].head];
+    Member member;
+    for (const Member& candidate : lanes[victim].members)
+    {
+        if (candidate.flight.handle == slot.handle) member = candidate;
+    }
+    release(slot.handle);
+
+    // The thief's plan was used up, so its members are too - the stolen flight is its whole plan
+    Lane& lane = lanes[thief];
+    lane.members.assign(1, member);
+    lane.validLayers = 0;
+    lane.stale = false;
+    slot.runway = lane.runway;
+    slot.shift = 0;
+    lane.sequence.assign(1, slot);
+    lane.head = 0;
+    retime(lane);
+    laneOf[slot.handle] = thief;
+    return &lane.sequence[0];
+}
+
+void ArrivalPlanner::release(AircraftHandle handle)
+{
+    if (handle >= laneOf.size() || laneOf[handle] < 0) return;
+
+    Lane& lane = lanes[laneOf[handle]];
+    laneOf[handle] = -1;
+
+    for (size_t i = 0; i < lane.members.size(); i++)
+    {
+        if (lane.members[i].flight.handle == handle)
+        {
+            lane.members.erase(lane.members.begin() + i);
+            break;
+        }
+    }
+
+    // The positions are numbered from the old first flight, so they have to be rebuilt either way
+    lane.validLayers = 0;
+    if (lane.head < lane.sequence.size() && lane.sequence[lane.head].handle == handle)
+    {
+        // Landing the planned first flight leaves the best order of the rest unchanged
+        lane.head++;
+        return;
+    }
+
+    // Out of turn - keep the order for now and re-plan next time
+    for (size_t i = lane.head; i < lane.sequence.size(); i++)
+    {
+        if (lane.sequence[i].handle == handle)
+        {
+            lane.sequence.erase(lane.sequence.begin() + i);
+            break;
+        }
+    }
+    lane.stale = true;
+    retime(lane);
+}
+
+bool ArrivalPlanner::findSlot(AircraftHandle handle, Slot& slot) const
+{
+    if (handle >= laneOf.size() || laneOf[handle] < 0) return false;
+
+    const Lane& lane = lanes[laneOf[handle]];
+    for (size_t i = lane.head; i < lane.sequence.size(); i++)
+    {
+        if (lane.sequence[i].handle == handle)
+        {
+            slot = lane.sequence[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<ArrivalPlanner::Slot> ArrivalPlanner::getSlots() const
+{
+    std::vector<Slot> slots;
+    for (const Lane& lane : lanes)
+    {
+        slots.insert(slots.end(), lane.sequence.begin() + lane.head, lane.sequence.end());
+    }
+    return slots;
+}
+
+unsigned long long ArrivalPlanner::getLayersComputed() const
+{
+    return layersComputed;
+}
+
+unsigned long long ArrivalPlanner::getLayersReused() const
+{
+    return layersReused;
+}
+
+int ArrivalPlanner::laneIndex(int runwayIndex) const
+{
+    for (size_t l = 0; l < runways.size(); l++)
+    {
+        if (runways[l] == runwayIndex) return static_cast<int>(l);
+    }
+    return -1;
+}
+
+void ArrivalPlanner::track(AircraftHandle handle)
+{
+    if (handle >= laneOf.size())
+    {
+        laneOf.resize(handle + 1, -1);
+        serviceOf.resize(handle + 1, 0);
+        seenIn.resize(handle + 1, 0);
+    }
+}
+
+void ArrivalPlanner::solve(Lane& lane)
+{
+    size_t count = lane.members.size();
+    size_t states = stateMasks.size();
+
+    lane.prefix.resize(count + 1);
+    lane.prefix[0] = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        lane.prefix[i + 1] = lane.prefix[i] + lane.members[i].service;
+    }
+
+    lane.cells.resize((count + 1) * states);
+    if (lane.validLayers == 0)
+    {
+        // Nothing landed yet: the k window slots below flight 0 count as landed
+        for (size_t s = 0; s < states; s++)
+        {
+            lane.cells[s].cost = unreachable;
+            lane.cells[s].choice = -1;
+        }
+        lane.cells[stateOf[(1u << shiftLimit) - 1]].cost = 0;
+        lane.validLayers = 1;
+    }
+
+    layersReused += lane.validLayers - 1;
+    for (size_t position = lane.validLayers - 1; position < count; position++)
+    {
+        extend(lane, position);
+    }
+    layersComputed += count + 1 - lane.validLayers;
+    lane.validLayers = count + 1;
+    lane.stale = false;
+
+    backtrack(lane);
+}
+
+// Fill position + 1 from every reachable state of position
+void ArrivalPlanner::extend(Lane& lane, size_t position)
+{
+    size_t states = stateMasks.size();
+    const Cell* from = &lane.cells[position * states];
+    Cell* to = &lane.cells[(position + 1) * states];
+    for (size_t s = 0; s < states; s++)
+    {
+        to[s].cost = unreachable;
+        to[s].choice = -1;
+    }
+
+    long long count = static_cast<long long>(lane.members.size());
+    long long base = static_cast<long long>(position) - shiftLimit;    // Flight in window slot 0
+    int width = 2 * shiftLimit;
+
+    for (size_t s = 0; s < states; s++)
+    {
+        if (from[s].cost == unreachable) continue;
+        unsigned int mask = stateMasks[s];
+
+        // The next landing starts once everything already landed has had the runway
+        SimTime start = lane.prefix[std::max(0LL, std::min(base, count))];
+        for (int b = 0; b < width; b++)
+        {
+            long long i = base + b;
+            if ((mask >> b & 1u) && i >= 0 && i < count) start += lane.members[i].service;
+        }
+
+        // Try landing each waiting flight of the window (slot 2k is the flight k places back)
+        int bestWaiting = INT_MIN;      // Highest priority waiting ahead of the one tried
+        for (int b = 0; b <= width; b++)
+        {
+            long long i = base + b;
+            if (i >= count) break;
+            if (i < 0 || (mask >> b & 1u)) continue;
+
+            const Flight& flight = lane.members[i].flight;
+            if (flight.priority >= bestWaiting)
+            {
+                int next = stateOf[(mask | (1u << b)) >> 1];
+                long long cost = from[s].cost + start;
+                if (cost < to[next].cost)
+                {
+                    to[next].cost = cost;
+                    to[next].parent = static_cast<unsigned char>(s);
+                    to[next].choice = static_cast<signed char>(b);
+                }
+            }
+            bestWaiting = std::max(bestWaiting, flight.priority);
+
+            // Slot 0 is k places behind its queue position - it can't wait any longer
+            if (b == 0) break;
+        }
+    }
+}
+
+void ArrivalPlanner::backtrack(Lane& lane)
+{
+    size_t count = lane.members.size();
+    size_t states = stateMasks.size();
+
+    // Everything has landed: exactly the window's lower half is set
+    std::vector<size_t> order(count);
+    int state = stateOf[(1u << shiftLimit) - 1];
+    for (size_t position = count; position > 0; position--)
+    {
+        const Cell& cell = lane.cells[position * states + state];
+        order[position - 1] = position - 1 - shiftLimit + cell.choice;
+        state = cell.parent;
+    }
+
+    lane.sequence.clear();
+    lane.head = 0;
+    for (size_t position = 0; position < count; position++)
+    {
+        const Member& member = lane.members[order[position]];
+        Slot slot;
+        slot.handle = member.flight.handle;
+        slot.aircraft = member.flight.aircraft;
+        slot.runway = lane.runway;
+        slot.start = 0;
+        slot.service = member.service;
+        slot.shift = static_cast<int>(position) - static_cast<int>(order[position]);
+        lane.sequence.push_back(slot);
+    }
+    retime(lane);
+}
+
+void ArrivalPlanner::retime(Lane& lane)
+{
+    SimTime start = lane.freeAt;
+    for (size_t i = lane.head; i < lane.sequence.size(); i++)
+    {
+        lane.sequence[i].start = start;
+        start += lane.sequence[i].service;
+    }
+}
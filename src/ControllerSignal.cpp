@@ -0,0 +1,79 @@
+#include "../include/ControllerSignal.h"
+#include <algorithm>
+
+ControllerSignal::ControllerSignal()
+    : pending(0), batchStartNs(0), lastTakeNs(0), waiters(0), signals(0), batches(0)
+{
+}
+
+// The waiter count and the pending bits are both seq_cst: either we see the
+// waiter and wake it under the mutex, or it sees the bits before it sleeps
+void ControllerSignal::notify(Reason reason)
+{
+    signals.fetch_add(1, std::memory_order_relaxed);
+    long long now = nowNs();
+    if (pending.fetch_or(reason) != 0) return;  // Joins the batch already waiting
+
+    batchStartNs.store(now, std::memory_order_relaxed);
+    batches.fetch_add(1, std::memory_order_relaxed);
+    if (wakeHandler) wakeHandler();
+
+    if (waiters.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        wakeUp.notify_all();
+    }
+}
+
+void ControllerSignal::setWakeHandler(const std::function<void()>& handler)
+{
+    wakeHandler = handler;
+}
+
+// The batch start is stored just after the bits, so a take() in between reads the
+// previous batch's - never older than the last take, which is what we clamp to
+unsigned ControllerSignal::take(long long& waitedNs)
+{
+    unsigned reasons = pending.exchange(0);
+    long long now = nowNs();
+    if (reasons != 0)
+    {
+        long long start = std::max(batchStartNs.load(std::memory_order_relaxed), lastTakeNs.load(std::memory_order_relaxed));
+        waitedNs = std::max(0LL, now - start);
+    }
+    else
+    {
+        waitedNs = 0;
+    }
+    lastTakeNs.store(now, std::memory_order_relaxed);
+    return reasons;
+}
+
+bool ControllerSignal::wait(std::chrono::microseconds timeout)
+{
+    if (pending.load() != 0) return true;
+
+    waiters++;
+    {
+        std::unique_lock<std::mutex> lock(waitMutex);
+        wakeUp.wait_for(lock, timeout, [this]() { return pending.load() != 0; });
+    }
+    waiters--;
+    return pending.load() != 0;
+}
+
+unsigned long long ControllerSignal::getSignalCount() const
+{
+    return signals.load(std::memory_order_relaxed);
+}
+
+unsigned long long ControllerSignal::getBatchCount() const
+{
+    return batches.load(std::memory_order_relaxed);
+}
+
+long long ControllerSignal::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,60 @@
+#include "../include/CounterRandom.h"
+
+std::atomic<unsigned long long> CounterRandom::globalSeed(0);
+
+// Odd constants from SplitMix64 / the golden ratio
+static const unsigned long long golden = 0x9E3779B97F4A7C15ULL;
+
+unsigned long long CounterRandom::mix(unsigned long long value)
+{
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+void CounterRandom::setSeed(unsigned long long seed)
+{
+    globalSeed = seed;
+}
+
+unsigned long long CounterRandom::getSeed()
+{
+    return globalSeed.load();
+}
+
+/**
+ * FNV-1a over the name, then mixed with the index
+ */
+unsigned long long CounterRandom::keyFor(const std::string& name, long long index)
+{
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : name)
+    {
+        hash = (hash ^ c) * 0x100000001B3ULL;
+    }
+    return mix(hash + golden * static_cast<unsigned long long>(index));
+}
+
+/**
+ * Two mixing rounds: the first separates streams, the second positions in a stream
+ */
+unsigned long long CounterRandom::at(unsigned long long key, unsigned long long counter)
+{
+    unsigned long long stream = mix(globalSeed.load(std::memory_order_relaxed) ^ (key * golden));
+    return mix(stream + counter * golden);
+}
+
+int CounterRandom::range(unsigned long long key, unsigned long long counter, int minValue, int maxValue)
+{
+    unsigned long long span = static_cast<unsigned long long>(static_cast<long long>(maxValue) - minValue + 1);
+
+    // Multiply-shift on the top 32 bits instead of modulo (no bias worth worrying about for small spans)
+    unsigned long long high = at(key, counter) >> 32;
+    return minValue + static_cast<int>((high * span) >> 32);
+}
+
+double CounterRandom::unit(unsigned long long key, unsigned long long counter)
+{
+    // 53 random bits -> [0, 1)
+    return (at(key, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
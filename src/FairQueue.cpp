@@ -0,0 +1,253 @@
+#include "../include/FairQueue.h"
+#include "../include/Aircraft.h"
+#include <algorithm>
+
+const int AirlineRegistry::maxAirlines;
+
+AirlineRegistry::AirlineRegistry()
+    : entries(new Entry[maxAirlines]), count(0), totalWeight(0.0)
+{
+    for (int id = 0; id < maxAirlines; id++)
+    {
+        entries[id].weight.store(1.0, std::memory_order_relaxed);
+        entries[id].maxConcurrent.store(0, std::memory_order_relaxed);
+        entries[id].inService.store(0, std::memory_order_relaxed);
+    }
+}
+
+int AirlineRegistry::idOf(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::unordered_map<std::string, int>::const_iterator found = ids.find(name);
+    if (found != ids.end()) return found->second;
+
+    // Out of entries - the newcomer shares the last one
+    int id = count.load(std::memory_order_relaxed);
+    if (id >= maxAirlines) return maxAirlines - 1;
+
+    entries[id].name = name;
+    ids[name] = id;
+    totalWeight.store(totalWeight.load(std::memory_order_relaxed) + entries[id].weight.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+void AirlineRegistry::setPolicy(const std::string& name, double weight, int maxConcurrent)
+{
+    int id = idOf(name);
+    if (weight <= 0.0) weight = 1.0;    // Every airline keeps some share
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    double old = entries[id].weight.load(std::memory_order_relaxed);
+    entries[id].weight.store(weight, std::memory_order_relaxed);
+    entries[id].maxConcurrent.store(std::max(0, maxConcurrent), std::memory_order_relaxed);
+    totalWeight.store(totalWeight.load(std::memory_order_relaxed) - old + weight, std::memory_order_relaxed);
+}
+
+double AirlineRegistry::getWeight(int id) const
+{
+    return entries[id].weight.load(std::memory_order_relaxed);
+}
+
+double AirlineRegistry::getTotalWeight() const
+{
+    return totalWeight.load(std::memory_order_relaxed);
+}
+
+int AirlineRegistry::getQuota(int id) const
+{
+    return entries[id].maxConcurrent.load(std::memory_order_relaxed);
+}
+
+int AirlineRegistry::getInService(int id) const
+{
+    return entries[id].inService.load(std::memory_order_relaxed);
+}
+
+bool AirlineRegistry::atQuota(int id) const
+{
+    int quota = getQuota(id);
+    return quota > 0 && getInService(id) >= quota;
+}
+
+std::string AirlineRegistry::getName(int id) const
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return entries[id].name;
+}
+
+int AirlineRegistry::size() const
+{
+    return count.load(std::memory_order_acquire);
+}
+
+void AirlineRegistry::startService(int id)
+{
+    entries[id].inService.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AirlineRegistry::endService(int id)
+{
+    entries[id].inService.fetch_sub(1, std::memory_order_relaxed);
+}
+
+FairQueue::FairQueue(AirlineRegistry& airlineRegistry)
+    : registry(airlineRegistry)
+{
+}
+
+// VirtualClock: start at the later of the entry time and the airline's clock, then move
+// the clock on by the airline's spacing - one flight per spacing is its share of the runways
+long long FairQueue::admit(const Aircraft* aircraft, SimTime spacingMs)
+{
+    AircraftHandle handle = aircraft->tableHandle;
+    Entry* entry = handle < entries.size() ? &entries[handle] : nullptr;
+
+    if (entry == nullptr || !entry->admitted)
+    {
+        int airline = registry.idOf(aircraft->Airline);
+        grow(handle, airline);
+        entry = &entries[handle];
+        entry->airline = airline;
+        entry->admitted = true;
+        entry->inService = false;
+
+        if (aircraft->EmergencyNo > 0)
+        {
+            entry->finish = aircraft->queueEntryTime;     // Not metered - and doesn't use up the airline's share
+        }
+        else
+        {
+            SimTime spacing = static_cast<SimTime>(spacingMs * registry.getTotalWeight() / registry.getWeight(airline));
+            entry->finish = std::max(aircraft->queueEntryTime, virtualClock[airline]) + spacing;
+            virtualClock[airline] = entry->finish;
+        }
+    }
+    else if (entry->inService)
+    {
+        // Taken off the queue and put back (e.g. no runway fit) - it isn't using its quota after all
+        entry->inService = false;
+        registry.endService(entry->airline);
+    }
+
+    return keyOf(aircraft);
+}
+
+// Same as priorityKey() with the finish time for the entry time - a declared emergency
+// goes back to its entry time so it isn't held back by its airline's share
+long long FairQueue::keyOf(const Aircraft* aircraft) const
+{
+    AircraftHandle handle = aircraft->tableHandle;
+    bool admitted = handle < entries.size() && entries[handle].admitted;
+    SimTime finish = admitted && aircraft->EmergencyNo <= 0 ? entries[handle].finish : aircraft->queueEntryTime;
+    return static_cast<long long>(aircraft->staticPriority()) * 1000 - finish;
+}
+
+void FairQueue::push(Aircraft* aircraft, long long key)
+{
+    AircraftHandle handle = aircraft->tableHandle;
+    if (handle >= entries.size() || !entries[handle].admitted) return;
+
+    int airline = entries[handle].airline;
+    if (airlineQueues[airline]->push(aircraft, handle, key)) refresh(airline);
+}
+
+void FairQueue::remove(AircraftHandle handle)
+{
+    if (handle >= entries.size() || !entries[handle].admitted) return;
+
+    int airline = entries[handle].airline;
+    if (airlineQueues[airline]->remove(handle)) refresh(airline);
+}
+
+void FairQueue::update(AircraftHandle handle, long long key)
+{
+    if (handle >= entries.size() || !entries[handle].admitted) return;
+
+    int airline = entries[handle].airline;
+    if (airlineQueues[airline]->update(handle, key)) refresh(airline);
+}
+
+// Airlines that dropped below their quota come back first, then the best airline
+// head wins - an airline found at its quota is parked on the way
+Aircraft* FairQueue::top()
+{
+    for (size_t i = 0; i < parkedAirlines.size();)
+    {
+        int airline = parkedAirlines[i];
+        if (registry.atQuota(airline))
+        {
+            i++;
+            continue;
+        }
+        parked[airline] = 0;
+        parkedAirlines[i] = parkedAirlines.back();
+        parkedAirlines.pop_back();
+        refresh(airline);
+    }
+
+    while (!heads.empty())
+    {
+        int airline = static_cast<int>(heads.topHandle());
+        if (!registry.atQuota(airline)) return airlineQueues[airline]->top();
+
+        heads.remove(static_cast<AircraftHandle>(airline));
+        parked[airline] = 1;
+        parkedAirlines.push_back(airline);
+    }
+    return nullptr;
+}
+
+bool FairQueue::atQuota(AircraftHandle handle) const
+{
+    return handle < entries.size() && entries[handle].admitted && registry.atQuota(entries[handle].airline);
+}
+
+void FairQueue::served(AircraftHandle handle)
+{
+    if (handle >= entries.size() || !entries[handle].admitted || entries[handle].inService) return;
+
+    entries[handle].inService = true;
+    registry.startService(entries[handle].airline);
+}
+
+void FairQueue::finished(AircraftHandle handle)
+{
+    if (handle >= entries.size() || !entries[handle].admitted) return;
+
+    if (entries[handle].inService) registry.endService(entries[handle].airline);
+    entries[handle].admitted = false;
+    entries[handle].inService = false;
+}
+
+void FairQueue::grow(AircraftHandle handle, int airline)
+{
+    if (handle >= entries.size())
+    {
+        Entry empty = {0, 0, false, false};
+        entries.resize(handle + 1, empty);
+    }
+    while (static_cast<int>(airlineQueues.size()) <= airline)
+    {
+        airlineQueues.push_back(std::unique_ptr<IndexedHeap>(new IndexedHeap()));
+        virtualClock.push_back(0);
+        parked.push_back(0);
+    }
+}
+
+void FairQueue::refresh(int airline)
+{
+    if (parked[airline]) return;    // top() brings it back once it is under its quota
+
+    const IndexedHeap& queue = *airlineQueues[airline];
+    AircraftHandle id = static_cast<AircraftHandle>(airline);
+    if (queue.empty())
+    {
+        heads.remove(id);
+    }
+    else if (!heads.update(id, queue.topKey()))
+    {
+        heads.push(queue.top(), id, queue.topKey());
+    }
+}
@@ -0,0 +1,12 @@
+#include "../include/FlightProfile.h"
+
+// Out-of-class definitions for the constexpr members (C++11 needs them once they are odr-used)
+constexpr PhaseProfile FlightProfile::holding;
+constexpr PhaseProfile FlightProfile::approach;
+constexpr PhaseProfile FlightProfile::landing;
+constexpr PhaseProfile FlightProfile::taxi;
+constexpr PhaseProfile FlightProfile::atGate;
+constexpr PhaseProfile FlightProfile::takeoffRoll;
+constexpr PhaseProfile FlightProfile::climb;
+constexpr PhaseProfile FlightProfile::cruise;
+constexpr PhaseProfile FlightProfile::table[FlightProfile::typeCount][FlightProfile::phaseCount];
@@ -1,11 +1,16 @@
 #include "../include/FlightsScheduler.h"
+#include "../include/Airline.h"
 #include <algorithm>
-#include <ctime>
 #include <sstream>
 #include <cmath>
 
+const int FlightsScheduler::emergencyLevels;
+
 // Constructor initializes empty queues
 FlightsScheduler::FlightsScheduler()
+    : arrivalQueue(true), departureQueue(true),    // Ranks for estimateWaitTime()
+      arrivalFairness(airlineRegistry), departureFairness(airlineRegistry), fairScheduling(false),
+      intakeOverflows(0)
 {
     //vectors use karrahe hein so no need to initialize anything ig
 }
@@ -13,22 +18,17 @@ FlightsScheduler::FlightsScheduler()
 void FlightsScheduler::addArrival(Aircraft* aircraft)
 {
     // Set the current time as queue entry time (for FCFS tracking)
-    aircraft->queueEntryTime = time(NULL);
+    aircraft->queueEntryTime = SimClock::instance().now();
     
 
     arrivalMutex.lock();
 
     //critical section starts from here RAAAA
-    arrivalQueue.push_back(aircraft);
-    
-    // Sort the queue by priority (now that we've added a new aircraft)
-    sortQueues();
+    // Add to active flights list if it's not already there (gives it a table handle)
+    trackFlight(aircraft);
     
-    // Add to active flights list if it's not already there
-    if (std::find(activeFlights.begin(), activeFlights.end(), aircraft) == activeFlights.end())
-    {
-        activeFlights.push_back(aircraft);
-    }
+    // Push onto the heap (and its emergency bucket) - it finds its place by priority, no re-sort
+    enqueue(arrivalQueue, arrivalEmergencies, aircraft);
     
     // Unlock the mutex when we're done
     arrivalMutex.unlock();
@@ -38,24 +38,80 @@ void FlightsScheduler::addArrival(Aircraft* aircraft)
 void FlightsScheduler::addDeparture(Aircraft* aircraft)
 {
     // Set the current time as queue entry time (for FCFS tracking)
-    aircraft->queueEntryTime = time(NULL);
+    aircraft->queueEntryTime = SimClock::instance().now();
     
     departureMutex.lock();
     
-    // Add aircraft to the queue
-    departureQueue.push_back(aircraft);
+    // Add to active flights list if it's not already there (gives it a table handle)
+    trackFlight(aircraft);
     
-    // Sort the queue by priority (now that we've added a new aircraft)
-    sortQueues();
+    // Push onto the heap (and its emergency bucket) - it finds its place by priority, no re-sort
+    enqueue(departureQueue, departureEmergencies, aircraft);
     
-    // Add to active flights list if it's not already there
-    if (std::find(activeFlights.begin(), activeFlights.end(), aircraft) == activeFlights.end())
+    // Unlock the mutex when we're done
+    departureMutex.unlock();
+}
+
+// Submit an arrival without touching the queue lock - it is queued by the next drainIntake()
+// The row is still claimed here: the engine's step workers sync it from their own thread
+// The entry time is stamped now, so the wait in the ring still counts towards FCFS aging
+void FlightsScheduler::submitArrival(Aircraft* aircraft)
+{
+    aircraft->queueEntryTime = SimClock::instance().now();
+    trackFlight(aircraft);
+    if (!arrivalIntake.push(aircraft))
     {
-        activeFlights.push_back(aircraft);
+        intakeOverflows++;
+        addArrival(aircraft);   // Ring full - take the locked path
+    }
+}
+
+void FlightsScheduler::submitDeparture(Aircraft* aircraft)
+{
+    aircraft->queueEntryTime = SimClock::instance().now();
+    trackFlight(aircraft);
+    if (!departureIntake.push(aircraft))
+    {
+        intakeOverflows++;
+        addDeparture(aircraft);
+    }
+}
+
+// Queue every submitted flight with one lock per queue instead of one per flight
+// Heap keys come from queueEntryTime, so the order matches queuing them one by one
+size_t FlightsScheduler::drainIntake()
+{
+    std::lock_guard<std::mutex> intakeLock(intakeMutex);
+    size_t drained = 0;
+    
+    intakeBatch.clear();
+    if (arrivalIntake.drain(intakeBatch) > 0)
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        for (Aircraft* aircraft : intakeBatch)
+        {
+            enqueue(arrivalQueue, arrivalEmergencies, aircraft);
+        }
     }
+    drained += intakeBatch.size();
     
-    // Unlock the mutex when we're done
-    departureMutex.unlock();
+    intakeBatch.clear();
+    if (departureIntake.drain(intakeBatch) > 0)
+    {
+        std::lock_guard<std::mutex> lock(departureMutex);
+        for (Aircraft* aircraft : intakeBatch)
+        {
+            enqueue(departureQueue, departureEmergencies, aircraft);
+        }
+    }
+    drained += intakeBatch.size();
+    
+    return drained;
+}
+
+unsigned long long FlightsScheduler::getIntakeOverflows() const
+{
+    return intakeOverflows.load();
 }
 
 // Get the highest priority arrival flight
@@ -64,18 +120,15 @@ Aircraft* FlightsScheduler::getNextArrival()
     // Lock the queue while we're reading/modifying it
     arrivalMutex.lock();
     
-    // Check if there are any arrivals waiting
-    if (arrivalQueue.empty())
+    // Take the highest priority aircraft (an airline under its quota with fair scheduling on)
+    Aircraft* nextAircraft = nextOf(arrivalQueue);
+    if (nextAircraft == nullptr)
     {
         arrivalMutex.unlock(); // Don't forget to unlock before returning!
         return nullptr;        // No aircraft in queue
     }
     
-    // Get the first aircraft (highest priority after sorting)
-    Aircraft* nextAircraft = arrivalQueue.front();
-    
-    // Remove it from the queue
-    arrivalQueue.erase(arrivalQueue.begin());
+    dequeue(arrivalQueue, arrivalEmergencies, nextAircraft->tableHandle);
     
     // Unlock the mutex when we're done
     arrivalMutex.unlock();
@@ -90,18 +143,15 @@ Aircraft* FlightsScheduler::getNextDeparture()
     // Lock the queue while we're reading/modifying it
     departureMutex.lock();
     
-    // Check if there are any departures waiting
-    if (departureQueue.empty())
+    // Take the highest priority aircraft (an airline under its quota with fair scheduling on)
+    Aircraft* nextAircraft = nextOf(departureQueue);
+    if (nextAircraft == nullptr)
     {
         departureMutex.unlock(); // Don't forget to unlock before returning!
         return nullptr;          // No aircraft in queue
     }
     
-    // Get the first aircraft (highest priority after sorting)
-    Aircraft* nextAircraft = departureQueue.front();
-    
-    // Remove it from the queue
-    departureQueue.erase(departureQueue.begin());
+    dequeue(departureQueue, departureEmergencies, nextAircraft->tableHandle);
     
     // Unlock the mutex when we're done
     departureMutex.unlock();
@@ -114,37 +164,12 @@ Aircraft* FlightsScheduler::getNextDeparture()
 // This is the non-const version that removes the aircraft from the queue
 Aircraft* FlightsScheduler::removeNextEmergency()
 {
-    Aircraft* emergencyAircraft = nullptr;
-    int highestPriority = 0;
-    
-    // First check arrivals for emergencies
+    // Arrivals first - a bucket top is that level's best emergency, so this is O(1)
     arrivalMutex.lock();
-    for (size_t i = 0; i < arrivalQueue.size(); i++)
-    {
-        // Check if this is an emergency flight
-        if (arrivalQueue[i]->EmergencyNo > 0)
-        {
-            // Calculate its priority score
-            int priority = arrivalQueue[i]->calculatePriorityScore();
-            
-            // Check if it's the highest priority emergency so far
-            if (priority > highestPriority)
-            {
-                highestPriority = priority;
-                emergencyAircraft = arrivalQueue[i];
-            }
-        }
-    }
-    
-    // If we found an emergency in arrivals, remove it from the queue
+    Aircraft* emergencyAircraft = topEmergency(arrivalEmergencies);
     if (emergencyAircraft != nullptr)
     {
-        // Find the aircraft in the queue and remove it
-        auto it = std::find(arrivalQueue.begin(), arrivalQueue.end(), emergencyAircraft);
-        if (it != arrivalQueue.end())
-        {
-            arrivalQueue.erase(it);
-        }
+        dequeue(arrivalQueue, arrivalEmergencies, emergencyAircraft->tableHandle);
     }
     arrivalMutex.unlock();
     
@@ -152,32 +177,10 @@ Aircraft* FlightsScheduler::removeNextEmergency()
     if (emergencyAircraft == nullptr)
     {
         departureMutex.lock();
-        for (size_t i = 0; i < departureQueue.size(); i++)
-        {
-            // Check if this is an emergency flight
-            if (departureQueue[i]->EmergencyNo > 0)
-            {
-                // Calculate its priority score
-                int priority = departureQueue[i]->calculatePriorityScore();
-                
-                // Check if it's the highest priority emergency so far
-                if (priority > highestPriority)
-                {
-                    highestPriority = priority;
-                    emergencyAircraft = departureQueue[i];
-                }
-            }
-        }
-        
-        // If we found an emergency in departures, remove it from the queue
+        emergencyAircraft = topEmergency(departureEmergencies);
         if (emergencyAircraft != nullptr)
         {
-            // Find the aircraft in the queue and remove it
-            auto it = std::find(departureQueue.begin(), departureQueue.end(), emergencyAircraft);
-            if (it != departureQueue.end())
-            {
-                departureQueue.erase(it);
-            }
+            dequeue(departureQueue, departureEmergencies, emergencyAircraft->tableHandle);
         }
         departureMutex.unlock();
     }
@@ -186,129 +189,566 @@ Aircraft* FlightsScheduler::removeNextEmergency()
     return emergencyAircraft;
 }
 
-// Find any emergency flight in either queue without removing it (const version)
-// This version just peeks at the queue and doesn't modify it
-Aircraft* FlightsScheduler::getNextEmergency() const
+bool FlightsScheduler::peekEmergency(IndexedHeap::Entry& out) const
 {
-    // Oh boy, C++ const correctness can be tricky!
-    // This version doesn't modify anything, just looks for emergencies
-    
-    Aircraft* emergencyAircraft = nullptr;
-    int highestPriority = 0;
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        if (peekEmergencyOf(arrivalQueue, arrivalEmergencies, out)) return true;
+    }
     
-    // Check arrivals for emergencies (without modifying the queue)
-    for (size_t i = 0; i < arrivalQueue.size(); i++)
+    std::lock_guard<std::mutex> lock(departureMutex);
+    return peekEmergencyOf(departureQueue, departureEmergencies, out);
+}
+
+Aircraft* FlightsScheduler::peekTopArrival() const
+{
+    std::lock_guard<std::mutex> lock(arrivalMutex);
+    return arrivalQueue.empty() ? nullptr : arrivalQueue.top();
+}
+
+Aircraft* FlightsScheduler::peekTopDeparture() const
+{
+    std::lock_guard<std::mutex> lock(departureMutex);
+    return departureQueue.empty() ? nullptr : departureQueue.top();
+}
+
+// One queue at a time, so a reader never holds both locks
+void FlightsScheduler::collectQueued(const CandidateFilter& accept, std::vector<Aircraft*>& out) const
+{
     {
-        // Check if this is an emergency flight
-        if (arrivalQueue[i]->EmergencyNo > 0)
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        for (const IndexedHeap::Entry& entry : arrivalQueue.entries())
         {
-            // Calculate its priority score
-            int priority = arrivalQueue[i]->calculatePriorityScore();
-            
-            // Check if it's the highest priority emergency so far
-            if (priority > highestPriority)
-            {
-                highestPriority = priority;
-                emergencyAircraft = arrivalQueue[i];
-            }
+            if (!accept || accept(*entry.aircraft)) out.push_back(entry.aircraft);
         }
     }
     
-    // If no emergency in arrivals, check departures (without modifying the queue)
-    if (emergencyAircraft == nullptr)
+    std::lock_guard<std::mutex> lock(departureMutex);
+    for (const IndexedHeap::Entry& entry : departureQueue.entries())
     {
-        for (size_t i = 0; i < departureQueue.size(); i++)
-        {
-            // Check if this is an emergency flight
-            if (departureQueue[i]->EmergencyNo > 0)
-            {
-                // Calculate its priority score
-                int priority = departureQueue[i]->calculatePriorityScore();
-                
-                // Check if it's the highest priority emergency so far
-                if (priority > highestPriority)
-                {
-                    highestPriority = priority;
-                    emergencyAircraft = departureQueue[i];
-                }
-            }
-        }
+        if (!accept || accept(*entry.aircraft)) out.push_back(entry.aircraft);
+    }
+}
+
+const IndexedHeap& FlightsScheduler::getArrivalQueue() const
+{
+    return arrivalQueue;
+}
+
+const IndexedHeap& FlightsScheduler::getDepartureQueue() const
+{
+    return departureQueue;
+}
+
+// Take a flight out of whichever queue holds it
+bool FlightsScheduler::takeFromQueue(Aircraft* aircraft)
+{
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        if (dequeue(arrivalQueue, arrivalEmergencies, aircraft->tableHandle)) return true;
     }
     
-    // Return the highest priority emergency aircraft (or nullptr if no emergencies)
-    // This is just for peeking, not removing from queue
-    return emergencyAircraft;
+    std::lock_guard<std::mutex> lock(departureMutex);
+    return dequeue(departureQueue, departureEmergencies, aircraft->tableHandle);
+}
+
+size_t FlightsScheduler::peekArrivals(size_t window, const CandidateFilter& accept, std::vector<IndexedHeap::Entry>& out,
+                                      size_t limit)
+{
+    std::lock_guard<std::mutex> lock(arrivalMutex);
+    return peek(arrivalQueue, window, accept, out, limit);
 }
 
-// Sort both queues by priority score
-void FlightsScheduler::sortQueues()
+size_t FlightsScheduler::peekDepartures(size_t window, const CandidateFilter& accept, std::vector<IndexedHeap::Entry>& out,
+                                        size_t limit)
 {
-    // Sort arrival queue - no lock needed here because we're called from methods that already lock
-    // We want higher priority scores first, so we use this comparison function
-    std::sort(arrivalQueue.begin(), arrivalQueue.end(), 
-        [](Aircraft* a, Aircraft* b) {
-            return a->calculatePriorityScore() > b->calculatePriorityScore();
-        });
+    std::lock_guard<std::mutex> lock(departureMutex);
+    return peek(departureQueue, window, accept, out, limit);
+}
+
+// The candidate names its aircraft by handle and key, so a flight that left and a new one
+// that got its handle, or a flight re-keyed by an emergency, don't match
+bool FlightsScheduler::claim(const IndexedHeap::Entry& candidate)
+{
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        if (claimFrom(arrivalQueue, arrivalEmergencies, candidate)) return true;
+    }
     
-    // Sort departure queue - no lock needed here because we're called from methods that already lock
-    // Same comparison as above - higher scores first
-    std::sort(departureQueue.begin(), departureQueue.end(), 
-        [](Aircraft* a, Aircraft* b) {
-            return a->calculatePriorityScore() > b->calculatePriorityScore();
-        });
+    std::lock_guard<std::mutex> lock(departureMutex);
+    return claimFrom(departureQueue, departureEmergencies, candidate);
 }
 
-// Estimate wait time for an aircraft in the queue (FR5.2)
-int FlightsScheduler::estimateWaitTime(Aircraft* aircraft)
+bool FlightsScheduler::claimEmergency(const IndexedHeap::Entry& candidate)
 {
-    int position = -1;
-    const int processingTimePerAircraft = 2; // minutes per aircraft
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        if (claimFrom(arrivalQueue, arrivalEmergencies, candidate, false)) return true;
+    }
     
-    // Check which queue the aircraft is in and find its position
-    // We need to lock both queues while searching to avoid race conditions
+    std::lock_guard<std::mutex> lock(departureMutex);
+    return claimFrom(departureQueue, departureEmergencies, candidate, false);
+}
+
+// Remove a flight that finished or gave up waiting
+// Both mutexes are taken (arrival first, like everywhere else) since activeFlights is shared
+void FlightsScheduler::removeFlight(Aircraft* aircraft)
+{
+    // Queue anything still in the rings first, so this flight can't be queued after it is gone
+    drainIntake();
     
-    // First check arrival queue
-    arrivalMutex.lock();
-    for (size_t i = 0; i < arrivalQueue.size(); i++)
+    std::lock_guard<std::mutex> arrivalLock(arrivalMutex);
+    std::lock_guard<std::mutex> departureLock(departureMutex);
+    
+    // Straight to the aircraft's heap slots - before the table row (the heap key) is freed
+    dequeue(arrivalQueue, arrivalEmergencies, aircraft->tableHandle, false);
+    dequeue(departureQueue, departureEmergencies, aircraft->tableHandle, false);
+    
+    // Frees its airline's quota (either flow may have held it)
+    arrivalFairness.finished(aircraft->tableHandle);
+    departureFairness.finished(aircraft->tableHandle);
+    
+    // Not queued anymore - no FCFS aging
+    aircraft->queueEntryTime = -1;
+    
+    std::lock_guard<std::mutex> activeLock(activeMutex);
+    AircraftHandle handle = aircraft->tableHandle;
+    if (handle == invalidAircraftHandle) return;
+    
+    // O(1): move the last flight into the hole
+    int slot = activeSlots[handle];
+    Aircraft* last = activeFlights.back();
+    activeFlights[slot] = last;
+    activeSlots[last->tableHandle] = slot;
+    activeFlights.pop_back();
+    activeSlots[handle] = -1;
+    
+    aircraftTable.remove(aircraft);
+}
+
+// Find any emergency flight in either queue without removing it (const version)
+// This version just peeks at the bucket tops, under the queue locks the workers re-key them with
+Aircraft* FlightsScheduler::getNextEmergency() const
+{
+    IndexedHeap::Entry emergency;
+    if (!peekEmergency(emergency))
+    {
+        return nullptr;
+    }
+    
+    // Only a pointer to look at - claimEmergency() the entry to take it
+    return emergency.aircraft;
+}
+
+// Move a queued aircraft to where its current priority score puts it, and into
+// the bucket of its current emergency level (a newly declared emergency lands here)
+// Arrival mutex first, like everywhere else
+void FlightsScheduler::updatePriority(const Aircraft* aircraft)
+{
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        if (requeue(arrivalQueue, arrivalEmergencies, aircraft)) return;
+    }
+    
+    std::lock_guard<std::mutex> lock(departureMutex);
+    requeue(departureQueue, departureEmergencies, aircraft);
+}
+
+// Bucket index for an emergency level (-1 = not an emergency, levels above the last share it)
+int FlightsScheduler::emergencyBucket(int emergencyLevel)
+{
+    if (emergencyLevel <= 0) return -1;
+    return emergencyLevel < emergencyLevels ? emergencyLevel - 1 : emergencyLevels - 1;
+}
+
+// Push onto a queue and, for emergencies, onto the bucket of its level (queue mutex held)
+void FlightsScheduler::enqueue(IndexedHeap& queue, IndexedHeap* buckets, Aircraft* aircraft)
+{
+    // With fair scheduling the key carries the airline's finish time instead of the entry time
+    bool arrival = &queue == &arrivalQueue;
+    FairQueue* fairness = fairnessOf(queue);
+    long long key = fairness ? fairness->admit(aircraft, serviceModel.estimateWait(1, arrival)) : aircraft->priorityKey();
+    if (!queue.push(aircraft, aircraft->tableHandle, key)) return;
+    if (fairness) fairness->push(aircraft, key);
+    
+    telemetry.recordEnqueue(arrival ? QueueTelemetry::Arrivals : QueueTelemetry::Departures,
+                            aircraft->type);
+    
+    // Buckets reuse the queue's sequence, so equal keys leave them in queue order
+    int bucket = emergencyBucket(aircraft->EmergencyNo);
+    if (bucket >= 0)
     {
-        if (arrivalQueue[i] == aircraft)
+        buckets[bucket].push(aircraft, aircraft->tableHandle, key, queue.find(aircraft->tableHandle)->sequence);
+    }
+}
+
+// Remove from a queue and its emergency buckets (queue mutex held) - false if it wasn't queued
+// served = it leaves for a runway, otherwise it finished or timed out while queued
+bool FlightsScheduler::dequeue(IndexedHeap& queue, IndexedHeap* buckets, AircraftHandle handle, bool served)
+{
+    if (!queue.remove(handle)) return false;
+    
+    FairQueue* fairness = fairnessOf(queue);
+    if (fairness)
+    {
+        fairness->remove(handle);
+        if (served) fairness->served(handle);
+    }
+    
+    // The row is still live - removeFlight() frees it after this
+    const Aircraft* aircraft = aircraftTable.get(handle);
+    telemetry.recordDequeue(&queue == &arrivalQueue ? QueueTelemetry::Arrivals : QueueTelemetry::Departures,
+                            aircraft->type, SimClock::instance().now() - aircraft->queueEntryTime, served);
+    
+    for (int level = 0; level < emergencyLevels; level++)
+    {
+        if (buckets[level].remove(handle)) break;
+    }
+    return true;
+}
+
+// Re-key an aircraft in a queue and move it between buckets if its level changed
+// (queue mutex held) - false if it isn't in this queue
+bool FlightsScheduler::requeue(IndexedHeap& queue, IndexedHeap* buckets, const Aircraft* aircraft)
+{
+    AircraftHandle handle = aircraft->tableHandle;
+    FairQueue* fairness = fairnessOf(queue);
+    long long key = fairness ? fairness->keyOf(aircraft) : aircraft->priorityKey();
+    if (!queue.update(handle, key)) return false;
+    if (fairness) fairness->update(handle, key);
+    
+    int bucket = emergencyBucket(aircraft->EmergencyNo);
+    for (int level = 0; level < emergencyLevels; level++)
+    {
+        if (level == bucket) buckets[level].update(handle, key);
+        else buckets[level].remove(handle);
+    }
+    if (bucket >= 0 && !buckets[bucket].contains(handle))
+    {
+        buckets[bucket].push(aircraftTable.get(handle), handle, key, queue.find(handle)->sequence);
+    }
+    return true;
+}
+
+// The queue entry of a queue's best emergency (queue mutex held) - false if it has none
+bool FlightsScheduler::peekEmergencyOf(const IndexedHeap& queue, const IndexedHeap* buckets, IndexedHeap::Entry& out)
+{
+    Aircraft* emergency = topEmergency(buckets);
+    if (emergency == nullptr) return false;
+    
+    out = *queue.find(emergency->tableHandle);
+    return true;
+}
+
+// Best emergency across the level buckets - compares one top per level
+Aircraft* FlightsScheduler::topEmergency(const IndexedHeap* buckets)
+{
+    const IndexedHeap* best = nullptr;
+    for (int level = 0; level < emergencyLevels; level++)
+    {
+        if (buckets[level].empty()) continue;
+        if (best == nullptr || buckets[level].topKey() > best->topKey())
         {
-            position = static_cast<int>(i);
-            break;
+            best = &buckets[level];
         }
     }
+    return best ? best->top() : nullptr;
+}
+
+FairQueue* FlightsScheduler::fairnessOf(const IndexedHeap& queue)
+{
+    if (!fairScheduling) return nullptr;
+    return &queue == &arrivalQueue ? &arrivalFairness : &departureFairness;
+}
+
+Aircraft* FlightsScheduler::nextOf(IndexedHeap& queue)
+{
+    FairQueue* fairness = fairnessOf(queue);
+    return fairness ? fairness->top() : queue.top();
+}
+
+// The heap's best-first walk of the first 'window' entries, stopping once 'limit' are found
+size_t FlightsScheduler::peek(IndexedHeap& queue, size_t window, const CandidateFilter& accept,
+                              std::vector<IndexedHeap::Entry>& out, size_t limit)
+{
+    FairQueue* fairness = fairnessOf(queue);
+    out.clear();
+    if (limit == 0) return 0;
+    
+    queue.walkTop(window, [&](const IndexedHeap::Entry& entry) {
+        if ((fairness && fairness->atQuota(entry.handle)) || (accept && !accept(*entry.aircraft))) return true;
+        out.push_back(entry);
+        return out.size() < limit;
+    });
+    return out.size();
+}
+
+bool FlightsScheduler::claimFrom(IndexedHeap& queue, IndexedHeap* buckets, const IndexedHeap::Entry& candidate, bool keepQuota)
+{
+    const IndexedHeap::Entry* queued = queue.find(candidate.handle);
+    if (queued == nullptr || queued->aircraft != candidate.aircraft || queued->key != candidate.key) return false;
+    
+    FairQueue* fairness = fairnessOf(queue);
+    if (keepQuota && fairness && fairness->atQuota(candidate.handle)) return false;
+    
+    if (!dequeue(queue, buckets, candidate.handle)) return false;
+    if (&queue == &arrivalQueue) arrivalPlanner.release(candidate.handle);  // Its slot is used
+    return true;
+}
+
+// Estimate wait time for an aircraft in the queue (FR5.2)
+// Returns whole minutes, rounded up
+int FlightsScheduler::estimateWaitTime(Aircraft* aircraft)
+{
+    SimTime waitMs = estimateWaitMs(aircraft);
+    if (waitMs < 0) return -1;
+    return static_cast<int>((waitMs + 59999) / 60000);
+}
+
+// Aircraft ahead in the queue (O(log n) rank) times the measured runway service rate,
+// or the time until its runway slot if the arrival plan has one
+SimTime FlightsScheduler::estimateWaitMs(Aircraft* aircraft)
+{
+    drainIntake();
+    
+    // First check arrival queue (rank = aircraft ahead of it)
+    arrivalMutex.lock();
+    int position = arrivalQueue.rankOf(aircraft->tableHandle);
     arrivalMutex.unlock();
+    bool arrival = position >= 0;
     
     // If not found in arrivals, check departures
     if (position < 0)
     {
         departureMutex.lock();
-        for (size_t i = 0; i < departureQueue.size(); i++)
-        {
-            if (departureQueue[i] == aircraft)
-            {
-                position = static_cast<int>(i);
-                break;
-            }
-        }
+        position = departureQueue.rankOf(aircraft->tableHandle);
         departureMutex.unlock();
     }
     
-    // If aircraft found, calculate estimated wait time
-    if (position >= 0)
+    // Aircraft not found in either queue
+    if (position < 0) return -1;
+    
+    // A planned arrival waits until its runway slot
+    if (arrival)
     {
-        return position * processingTimePerAircraft;
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        ArrivalPlanner::Slot slot;
+        if (arrivalPlanner.findSlot(aircraft->tableHandle, slot) && slot.aircraft == aircraft)
+        {
+            return std::max<SimTime>(0, slot.start - SimClock::instance().now());
+        }
     }
     
-    // Aircraft not found in either queue
-    return -1;
+    return serviceModel.estimateWait(position, arrival);
 }
 
-// Schedule flights based on priority - will be enhanced when runway management is implemented
+ServiceTimeModel& FlightsScheduler::getServiceModel()
+{
+    return serviceModel;
+}
+
+const QueueTelemetry& FlightsScheduler::getTelemetry() const
+{
+    return telemetry;
+}
+
+// Plan runway slots for the first flights of the arrival queue (see ArrivalPlanner)
+// Runs under the arrival mutex so the plan always matches the queue it was made from
 void FlightsScheduler::scheduleFlight()
 {
-    // This will be implemented as part of the ATCScontroller logic
-    // For now, we've laid the groundwork with our priority queues
+    std::lock_guard<std::mutex> lock(arrivalMutex);
+    if (plannedRunways.empty()) return;
+    
+    arrivalQueue.topEntries(arrivalPlanner.getHorizon(), planEntries);
+    planFlights.clear();
+    for (const IndexedHeap::Entry& entry : planEntries)
+    {
+        // An airline at its quota gets no slot until one of its flights finishes
+        if (fairScheduling && arrivalFairness.atQuota(entry.handle)) continue;
+        
+        ArrivalPlanner::Flight flight;
+        flight.handle = entry.handle;
+        flight.aircraft = entry.aircraft;
+        flight.key = entry.key;
+        flight.priority = entry.aircraft->staticPriority();
+        flight.type = entry.aircraft->type;
+        planFlights.push_back(flight);
+    }
+    
+    // A busy runway is taken to be free one average service time from now
+    SimTime now = SimClock::instance().now();
+    planRunwayFree.clear();
+    for (RunwayClass* runway : plannedRunways)
+    {
+        planRunwayFree.push_back(runway->isOccupied(now) ? now + serviceModel.getServiceTime(runway->index) : now);
+    }
+    
+    arrivalPlanner.plan(planFlights, planRunwayFree, serviceModel);
+}
+
+void FlightsScheduler::setArrivalRunways(const std::vector<RunwayClass*>& runways)
+{
+    std::lock_guard<std::mutex> lock(arrivalMutex);
+    plannedRunways = runways;
+    
+    std::vector<int> indices;
+    for (RunwayClass* runway : runways)
+    {
+        indices.push_back(runway->index);
+    }
+    arrivalPlanner.setRunways(indices);
+}
+
+// The runway's next planned arrival - steal() hands back the runway's own next flight,
+// or another runway's when its plan is used up
+// Flights the filter turns down only leave the plan - the next scheduleFlight() plans them again
+bool FlightsScheduler::peekPlannedArrival(int runwayIndex, const CandidateFilter& accept, size_t window,
+                                          IndexedHeap::Entry& out)
+{
+    std::lock_guard<std::mutex> lock(arrivalMutex);
+    
+    const ArrivalPlanner::Slot* slot;
+    size_t turnedDown = 0;
+    while (turnedDown < window && (slot = arrivalPlanner.steal(runwayIndex)) != nullptr)
+    {
+        AircraftHandle handle = slot->handle;
+        Aircraft* aircraft = slot->aircraft;
+        
+        // Skip flights that left the queue since the plan was made (timeouts, emergencies),
+        // and flights whose airline reached its quota since
+        const IndexedHeap::Entry* queued = arrivalQueue.find(handle);
+        bool stale = aircraftTable.get(handle) != aircraft || queued == nullptr ||
+                     (fairScheduling && arrivalFairness.atQuota(handle));
+        if (!stale && (!accept || accept(*aircraft)))
+        {
+            out = *queued;  // Stays planned until it is claimed
+            return true;
+        }
+        
+        arrivalPlanner.release(handle);
+        if (!stale) turnedDown++;
+    }
+    
+    // Runway not planned, or nothing planned at all - plain queue order
+    if (peek(arrivalQueue, window, accept, planEntries, 1) == 0) return false;
+    out = planEntries.front();
+    return true;
+}
+
+ArrivalPlanner& FlightsScheduler::getArrivalPlanner()
+{
+    return arrivalPlanner;
+}
+
+void FlightsScheduler::setFairScheduling(bool enabled)
+{
+    std::lock_guard<std::mutex> arrivalLock(arrivalMutex);
+    std::lock_guard<std::mutex> departureLock(departureMutex);
+    fairScheduling = enabled;
+}
+
+bool FlightsScheduler::isFairScheduling() const
+{
+    return fairScheduling;
+}
+
+void FlightsScheduler::setAirlinePolicy(const std::string& airline, double weight, int maxConcurrent)
+{
+    airlineRegistry.setPolicy(airline, weight, maxConcurrent);
+}
+
+void FlightsScheduler::setAirlinePolicies(const std::vector<Airline*>& airlines)
+{
+    for (const Airline* airline : airlines)
+    {
+        airlineRegistry.setPolicy(airline->name, airline->weight, airline->maxFlights);
+    }
+}
+
+const AirlineRegistry& FlightsScheduler::getAirlineRegistry() const
+{
+    return airlineRegistry;
+}
+
+void FlightsScheduler::setPersistentQueues(bool enabled)
+{
+    std::lock_guard<std::mutex> arrivalLock(arrivalMutex);
+    std::lock_guard<std::mutex> departureLock(departureMutex);
+    arrivalQueue.setPersistent(enabled);
+    departureQueue.setPersistent(enabled);
+}
+
+// Both queues are read under their locks (arrival first), so the fork is one consistent moment;
+// a busy runway is taken to be free one average service time from now, like scheduleFlight()
+SchedulerState FlightsScheduler::fork(const std::vector<RunwayClass*>& runways)
+{
+    drainIntake();
+    
+    SimTime now = SimClock::instance().now();
+    std::vector<SchedulerState::Runway> states;
+    for (RunwayClass* runway : runways)
+    {
+        SchedulerState::Runway state;
+        state.index = runway->index;
+        state.type = runway->type;
+        state.freeAt = runway->isOccupied(now) ? now + serviceModel.getServiceTime(runway->index) : now;
+        for (int type = 0; type < ServiceTimeModel::typeCount; type++)
+        {
+            state.serviceMs[type] = serviceModel.getServiceTime(runway->index, static_cast<AirCraftType>(type));
+        }
+        states.push_back(state);
+    }
+    
+    std::lock_guard<std::mutex> arrivalLock(arrivalMutex);
+    std::lock_guard<std::mutex> departureLock(departureMutex);
+    return SchedulerState(arrivalQueue.snapshot(), departureQueue.snapshot(), states, now);
+}
+
+// Having a table row means the aircraft is already tracked - no need to search activeFlights
+void FlightsScheduler::trackFlight(Aircraft* aircraft)
+{
+    std::lock_guard<std::mutex> lock(activeMutex);
+    if (aircraft->tableHandle == invalidAircraftHandle)
+    {
+        AircraftHandle handle = aircraftTable.insert(aircraft);
+        if (handle == invalidAircraftHandle) return;     // Table full
+        
+        if (handle >= activeSlots.size())
+        {
+            activeSlots.resize(handle + 1, -1);
+        }
+        activeSlots[handle] = static_cast<int>(activeFlights.size());
+        activeFlights.push_back(aircraft);
+    }
+    else
+    {
+        aircraftTable.update(*aircraft);    // Requeued - queueEntryTime changed
+    }
+}
+
+AircraftTable& FlightsScheduler::getAircraftTable()
+{
+    return aircraftTable;
+}
+
+const AircraftTable& FlightsScheduler::getAircraftTable() const
+{
+    return aircraftTable;
+}
+
+bool FlightsScheduler::syncAircraft(const Aircraft* aircraft)
+{
+    // A new or changed emergency moves the aircraft up its queue
+    bool emergencyChanged = aircraft->tableHandle != invalidAircraftHandle &&
+                            aircraftTable.getEmergencyLevel(aircraft->tableHandle) != aircraft->EmergencyNo;
+    
+    aircraftTable.update(*aircraft);
+    
+    if (emergencyChanged)
+    {
+        updatePriority(aircraft);
+    }
+    return emergencyChanged;
 }
 
 // Get all currently active flights (both arrival and departure)
@@ -325,27 +765,18 @@ const std::vector<Aircraft*>& FlightsScheduler::getActiveFlights() const
 
 /**
  * Get queue statistics for visualization
- * Returns array with [total active, arrivals, departures, emergency]
+ * Fills stats with [total active, arrivals, departures, emergency]
  */
-int* FlightsScheduler::getQueueStatistics() const
+void FlightsScheduler::getQueueStatistics(int stats[4]) const
 {
-    // Using static array to avoid memory leaks
-    static int stats[4];
-    
     // Count emergency aircraft across all active flights
-    int emergencyCount = 0;
-    for (const auto& aircraft : activeFlights)
-    {
-        if (aircraft->EmergencyNo > 0) emergencyCount++;
-    }
+    int emergencyCount = aircraftTable.countEmergencies();
     
-    // Fill statistics array
-    stats[0] = static_cast<int>(activeFlights.size());  // Total active
-    stats[1] = static_cast<int>(arrivalQueue.size());   // Arrivals in queue
-    stats[2] = static_cast<int>(departureQueue.size()); // Departures in queue
-    stats[3] = emergencyCount;                          // Emergency aircraft
-    
-    return stats;
+    // Queue sizes from the telemetry depths - atomics, so no queue lock (and no race on the heaps)
+    stats[0] = static_cast<int>(aircraftTable.size());                              // Total active
+    stats[1] = static_cast<int>(telemetry.getDepth(QueueTelemetry::Arrivals));      // Arrivals in queue
+    stats[2] = static_cast<int>(telemetry.getDepth(QueueTelemetry::Departures));    // Departures in queue
+    stats[3] = emergencyCount;                                                      // Emergency aircraft
 }
 
 /**
@@ -354,19 +785,8 @@ int* FlightsScheduler::getQueueStatistics() const
  */
 std::vector<Aircraft*> FlightsScheduler::getActiveEmergencyAircraft() const
 {
-    // Create vector to hold emergency aircraft
-    std::vector<Aircraft*> emergencyAircraft;
-    
-    // Find emergency aircraft in all active flights
-    for (Aircraft* aircraft : activeFlights)
-    {
-        if (aircraft->EmergencyNo > 0)
-        {
-            emergencyAircraft.push_back(aircraft);
-        }
-    }
-    
-    return emergencyAircraft;
+    // Only the emergency column is read
+    return aircraftTable.collectEmergencies();
 }
 
 /**
@@ -375,19 +795,8 @@ std::vector<Aircraft*> FlightsScheduler::getActiveEmergencyAircraft() const
  */
 std::vector<Aircraft*> FlightsScheduler::getAircraftWithViolations() const
 {
-    // Create vector to hold aircraft with violations
-    std::vector<Aircraft*> violatingAircraft;
-    
-    // Find aircraft with violations in all active flights
-    for (Aircraft* aircraft : activeFlights)
-    {
-        if (aircraft->HasViolation || aircraft->hasActiveViolation)
-        {
-            violatingAircraft.push_back(aircraft);
-        }
-    }
-    
-    return violatingAircraft;
+    // Only the flags column is read
+    return aircraftTable.collectWithFlags(AircraftTable::FlagViolation | AircraftTable::FlagActiveViolation);
 }
 
 /**
@@ -396,19 +805,8 @@ std::vector<Aircraft*> FlightsScheduler::getAircraftWithViolations() const
  */
 std::vector<Aircraft*> FlightsScheduler::getAircraftByType(AirCraftType type) const
 {
-    // Create vector to hold aircraft of specified type
-    std::vector<Aircraft*> filteredAircraft;
-    
-    // Find aircraft of specified type in all active flights
-    for (Aircraft* aircraft : activeFlights)
-    {
-        if (aircraft->type == type)
-        {
-            filteredAircraft.push_back(aircraft);
-        }
-    }
-    
-    return filteredAircraft;
+    // Only the type column is read
+    return aircraftTable.collectByType(type);
 }
 
 /**
@@ -417,19 +815,8 @@ std::vector<Aircraft*> FlightsScheduler::getAircraftByType(AirCraftType type) co
  */
 std::vector<Aircraft*> FlightsScheduler::getAircraftByState(FlightState state) const
 {
-    // Create vector to hold aircraft in specified state
-    std::vector<Aircraft*> filteredAircraft;
-    
-    // Find aircraft in specified state in all active flights
-    for (Aircraft* aircraft : activeFlights)
-    {
-        if (aircraft->state == state)
-        {
-            filteredAircraft.push_back(aircraft);
-        }
-    }
-    
-    return filteredAircraft;
+    // Only the state column is read
+    return aircraftTable.collectByState(state);
 }
 
 /**
@@ -438,23 +825,8 @@ std::vector<Aircraft*> FlightsScheduler::getAircraftByState(FlightState state) c
  */
 Aircraft* FlightsScheduler::getAircraftAtPosition(int x, int y, int radius) const
 {
-    // This is useful for mouse interaction in SFML
-    for (Aircraft* aircraft : activeFlights)
-    {
-        // Simple distance calculation to check if position is within radius of aircraft
-        int dx = aircraft->x_position - x;
-        int dy = aircraft->y_position - y;
-        int distanceSquared = dx*dx + dy*dy;
-        
-        // If position is within radius of aircraft, return it
-        if (distanceSquared <= radius*radius)
-        {
-            return aircraft;
-        }
-    }
-    
-    // No aircraft found at specified position
-    return nullptr;
+    // This is useful for mouse interaction in SFML - only the position columns are read
+    return aircraftTable.findAt(x, y, radius);
 }
 
 /**
@@ -466,7 +838,8 @@ std::string FlightsScheduler::getStatusSummary() const
     std::stringstream summary;
     
     // Get statistics
-    int* stats = getQueueStatistics();
+    int stats[4];
+    getQueueStatistics(stats);
     
     // Create summary text
     summary << "Active Flights: " << stats[0] << " | ";
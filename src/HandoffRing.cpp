@@ -0,0 +1,81 @@
+#include "../include/HandoffRing.h"
+
+HandoffRing::HandoffRing(size_t capacity)
+    : tail(0), head(0)
+{
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+        slots[i].handoff = Handoff{nullptr, -1, 0};
+    }
+}
+
+bool HandoffRing::push(const Handoff& handoff)
+{
+    size_t position = tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots[position & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        long long lag = static_cast<long long>(sequence) - static_cast<long long>(position);
+
+        if (lag == 0)
+        {
+            // Slot is free for this lap - claim it (on failure 'position' is reloaded)
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.handoff = handoff;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (lag < 0)
+        {
+            // The consumer hasn't emptied this slot since last lap - full
+            return false;
+        }
+        else
+        {
+            // Another producer got here first
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t HandoffRing::drain(std::vector<Handoff>& out)
+{
+    size_t position = head.load(std::memory_order_relaxed);
+    size_t taken = 0;
+    while (true)
+    {
+        Slot& slot = slots[position & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            break;      // Empty, or the producer that claimed it is still writing
+        }
+
+        out.push_back(slot.handoff);
+        slot.sequence.store(position + mask + 1, std::memory_order_release);   // Free for the next lap
+        position++;
+        taken++;
+    }
+    head.store(position, std::memory_order_relaxed);
+    return taken;
+}
+
+size_t HandoffRing::capacity() const
+{
+    return mask + 1;
+}
+
+size_t HandoffRing::sizeApprox() const
+{
+    size_t produced = tail.load(std::memory_order_relaxed);
+    size_t consumed = head.load(std::memory_order_relaxed);
+    return produced > consumed ? produced - consumed : 0;
+}
@@ -0,0 +1,293 @@
+#include "../include/IndexedHeap.h"
+#include "../include/Aircraft.h"
+#include <algorithm>
+
+const size_t IndexedHeap::arity;
+
+IndexedHeap::IndexedHeap(bool trackRanks)
+    : nextSequence(0), ranked(trackRanks), persistent(false)
+{
+}
+
+bool IndexedHeap::push(Aircraft* aircraft, AircraftHandle handle, long long key)
+{
+    if (!push(aircraft, handle, key, nextSequence)) return false;
+    nextSequence++;
+    return true;
+}
+
+bool IndexedHeap::push(Aircraft* aircraft, AircraftHandle handle, long long key, unsigned long long sequence)
+{
+    if (handle == invalidAircraftHandle || contains(handle)) return false;
+
+    if (handle >= positions.size())
+    {
+        positions.resize(handle + 1, -1);
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.sequence = sequence;
+    entry.handle = handle;
+    entry.aircraft = aircraft;
+
+    heap.push_back(entry);
+    positions[handle] = static_cast<int>(heap.size() - 1);
+    siftUp(heap.size() - 1);
+
+    if (ranked) ranks.insert(handle, key, entry.sequence);
+    if (persistent) mirror.insert(mirrorEntry(entry));
+    return true;
+}
+
+Aircraft* IndexedHeap::top() const
+{
+    return heap.empty() ? nullptr : heap.front().aircraft;
+}
+
+long long IndexedHeap::topKey() const
+{
+    return heap.empty() ? 0 : heap.front().key;
+}
+
+AircraftHandle IndexedHeap::topHandle() const
+{
+    return heap.empty() ? invalidAircraftHandle : heap.front().handle;
+}
+
+Aircraft* IndexedHeap::pop()
+{
+    if (heap.empty()) return nullptr;
+
+    Aircraft* aircraft = heap.front().aircraft;
+    removeAt(0);
+    return aircraft;
+}
+
+bool IndexedHeap::remove(AircraftHandle handle)
+{
+    if (!contains(handle)) return false;
+
+    removeAt(static_cast<size_t>(positions[handle]));
+    return true;
+}
+
+bool IndexedHeap::update(AircraftHandle handle, long long key)
+{
+    if (!contains(handle)) return false;
+
+    size_t index = static_cast<size_t>(positions[handle]);
+    long long oldKey = heap[index].key;
+    if (persistent && key != oldKey)
+    {
+        PersistentQueue::Entry moved = mirrorEntry(heap[index]);
+        mirror.erase(moved);
+        moved.key = key;
+        mirror.insert(moved);
+    }
+    heap[index].key = key;
+
+    if (ranked && key != oldKey)
+    {
+        ranks.erase(handle);
+        ranks.insert(handle, key, heap[index].sequence);
+    }
+
+    // Only one of the two directions can apply
+    if (key > oldKey) siftUp(index);
+    else if (key < oldKey) siftDown(index);
+    return true;
+}
+
+bool IndexedHeap::contains(AircraftHandle handle) const
+{
+    return handle < positions.size() && positions[handle] >= 0;
+}
+
+const IndexedHeap::Entry* IndexedHeap::find(AircraftHandle handle) const
+{
+    return contains(handle) ? &heap[positions[handle]] : nullptr;
+}
+
+size_t IndexedHeap::size() const
+{
+    return heap.size();
+}
+
+bool IndexedHeap::empty() const
+{
+    return heap.empty();
+}
+
+void IndexedHeap::clear()
+{
+    for (const Entry& entry : heap)
+    {
+        positions[entry.handle] = -1;
+    }
+    heap.clear();
+    ranks.clear();
+    mirror.clear();
+}
+
+int IndexedHeap::rankOf(AircraftHandle handle) const
+{
+    if (!contains(handle)) return -1;
+    if (ranked) return ranks.rank(handle);
+
+    const Entry& target = heap[positions[handle]];
+    int rank = 0;
+    for (const Entry& entry : heap)
+    {
+        if (before(entry, target)) rank++;
+    }
+    return rank;
+}
+
+const std::vector<IndexedHeap::Entry>& IndexedHeap::entries() const
+{
+    return heap;
+}
+
+// The next entry in pop order is always the root or a child of one already taken,
+// so a small frontier heap of those candidates is enough
+void IndexedHeap::topEntries(size_t count, std::vector<Entry>& out) const
+{
+    out.clear();
+    walkTop(count, [&out](const Entry& entry) {
+        out.push_back(entry);
+        return true;
+    });
+}
+
+size_t IndexedHeap::walkTop(size_t count, const std::function<bool(const Entry&)>& visit) const
+{
+    if (heap.empty() || count == 0) return 0;
+
+    auto later = [this](size_t a, size_t b) { return before(heap[b], heap[a]); };
+    frontier.assign(1, 0);
+    size_t seen = 0;
+    while (!frontier.empty() && seen < count)
+    {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        size_t index = frontier.back();
+        frontier.pop_back();
+        seen++;
+        if (!visit(heap[index])) break;
+
+        size_t first = index * arity + 1;
+        for (size_t child = first; child < first + arity && child < heap.size(); child++)
+        {
+            frontier.push_back(child);
+            std::push_heap(frontier.begin(), frontier.end(), later);
+        }
+    }
+    return seen;
+}
+
+void IndexedHeap::setPersistent(bool enabled)
+{
+    persistent = enabled;
+    mirror = enabled ? snapshot() : PersistentQueue();
+}
+
+bool IndexedHeap::isPersistent() const
+{
+    return persistent;
+}
+
+PersistentQueue IndexedHeap::snapshot() const
+{
+    if (persistent) return mirror;
+
+    PersistentQueue copy;
+    for (const Entry& entry : heap)
+    {
+        copy.insert(mirrorEntry(entry));
+    }
+    return copy;
+}
+
+// The aircraft's entry time and type go along, so a snapshot stands on its own
+PersistentQueue::Entry IndexedHeap::mirrorEntry(const Entry& entry)
+{
+    PersistentQueue::Entry result;
+    result.key = entry.key;
+    result.sequence = entry.sequence;
+    result.handle = entry.handle;
+    result.aircraft = entry.aircraft;
+    result.entryTime = entry.aircraft ? entry.aircraft->queueEntryTime : 0;
+    result.type = entry.aircraft ? entry.aircraft->type : AirCraftType::Commercial;
+    return result;
+}
+
+// Store an entry at a heap index and record where its handle now lives
+void IndexedHeap::place(size_t index, const Entry& entry)
+{
+    heap[index] = entry;
+    positions[entry.handle] = static_cast<int>(index);
+}
+
+// Move the entry towards the root while it beats its parent (hole technique - one write per level)
+void IndexedHeap::siftUp(size_t index)
+{
+    Entry entry = heap[index];
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / arity;
+        if (!before(entry, heap[parent])) break;
+
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+// Move the entry towards the leaves while one of its children beats it
+void IndexedHeap::siftDown(size_t index)
+{
+    Entry entry = heap[index];
+    size_t count = heap.size();
+    while (true)
+    {
+        size_t first = index * arity + 1;
+        if (first >= count) break;
+
+        // Best of up to four children
+        size_t last = first + arity < count ? first + arity : count;
+        size_t best = first;
+        for (size_t child = first + 1; child < last; child++)
+        {
+            if (before(heap[child], heap[best])) best = child;
+        }
+
+        if (!before(heap[best], entry)) break;
+
+        place(index, heap[best]);
+        index = best;
+    }
+    place(index, entry);
+}
+
+// Fill the hole with the last entry and restore the heap around it
+void IndexedHeap::removeAt(size_t index)
+{
+    positions[heap[index].handle] = -1;
+    if (ranked) ranks.erase(heap[index].handle);
+    if (persistent) mirror.erase(mirrorEntry(heap[index]));
+
+    size_t last = heap.size() - 1;
+    if (index != last)
+    {
+        place(index, heap[last]);
+        heap.pop_back();
+
+        // The moved entry may belong above or below its new spot
+        if (index > 0 && before(heap[index], heap[(index - 1) / arity])) siftUp(index);
+        else siftDown(index);
+    }
+    else
+    {
+        heap.pop_back();
+    }
+}
@@ -0,0 +1,115 @@
+#include "../include/LogHistogram.h"
+
+const int LogHistogram::subBucketBits;
+const int LogHistogram::subBucketCount;
+const int LogHistogram::bucketCount;
+
+LogHistogram::LogHistogram()
+{
+    reset();
+}
+
+void LogHistogram::record(long long value)
+{
+    unsigned long long v = value > 0 ? static_cast<unsigned long long>(value) : 0;
+    counts[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(v, std::memory_order_relaxed);
+
+    // Only retries while someone else raises the max at the same moment
+    unsigned long long seen = max.load(std::memory_order_relaxed);
+    while (v > seen && !max.compare_exchange_weak(seen, v, std::memory_order_relaxed))
+    {
+    }
+}
+
+LogHistogram::Snapshot LogHistogram::snapshot() const
+{
+    Snapshot result;
+    for (int b = 0; b < bucketCount; b++)
+    {
+        result.counts[b] = counts[b].load(std::memory_order_relaxed);
+        result.count += result.counts[b];
+    }
+    result.sum = sum.load(std::memory_order_relaxed);
+    result.max = max.load(std::memory_order_relaxed);
+    return result;
+}
+
+void LogHistogram::reset()
+{
+    for (int b = 0; b < bucketCount; b++)
+    {
+        counts[b].store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Values below 16 get a bucket each. Above that, the top bit picks the
+ * group and the next four bits the sub-bucket within it.
+ */
+int LogHistogram::bucketOf(unsigned long long value)
+{
+    if (value < static_cast<unsigned long long>(subBucketCount)) return static_cast<int>(value);
+
+    int topBit = 63;
+    while (!(value >> topBit & 1ULL)) topBit--;
+
+    int shift = topBit - subBucketBits;
+    int group = shift + 1;
+    return group * subBucketCount + static_cast<int>((value >> shift) - subBucketCount);
+}
+
+unsigned long long LogHistogram::bucketValue(int bucket)
+{
+    int group = bucket / subBucketCount;
+    unsigned long long sub = static_cast<unsigned long long>(bucket % subBucketCount);
+    if (group == 0) return sub;
+
+    int shift = group - 1;
+    unsigned long long low = (subBucketCount + sub) << shift;
+    return low + ((1ULL << shift) >> 1);
+}
+
+LogHistogram::Snapshot::Snapshot()
+    : counts(bucketCount, 0), count(0), sum(0), max(0)
+{
+}
+
+void LogHistogram::Snapshot::merge(const Snapshot& other)
+{
+    for (int b = 0; b < bucketCount; b++)
+    {
+        counts[b] += other.counts[b];
+    }
+    count += other.count;
+    sum += other.sum;
+    if (other.max > max) max = other.max;
+}
+
+double LogHistogram::Snapshot::mean() const
+{
+    return count > 0 ? static_cast<double>(sum) / count : 0.0;
+}
+
+unsigned long long LogHistogram::Snapshot::percentile(double p) const
+{
+    if (count == 0) return 0;
+
+    unsigned long long wanted = static_cast<unsigned long long>(p * count + 0.5);
+    if (wanted < 1) wanted = 1;
+
+    unsigned long long seen = 0;
+    for (int b = 0; b < bucketCount; b++)
+    {
+        seen += counts[b];
+        if (seen >= wanted)
+        {
+            // The top bucket can't report more than was ever recorded
+            unsigned long long value = bucketValue(b);
+            return value < max ? value : max;
+        }
+    }
+    return max;
+}
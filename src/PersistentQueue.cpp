@@ -0,0 +1,187 @@
+#include "../include/PersistentQueue.h"
+#include "../include/CounterRandom.h"
+
+PersistentQueue::PersistentQueue()
+    : priorityKey(CounterRandom::keyFor("persistent-queue", 0))
+{
+}
+
+void PersistentQueue::insert(const Entry& entry)
+{
+    std::shared_ptr<Node> fresh = std::make_shared<Node>();
+    fresh->entry = entry;
+    fresh->priority = CounterRandom::at(priorityKey, entry.sequence);
+    fresh->size = 1;
+    root = insertInto(root, fresh);
+}
+
+bool PersistentQueue::erase(const Entry& entry)
+{
+    bool found = false;
+    NodePtr result = eraseFrom(root, entry, found);
+    if (found) root = result;
+    return found;
+}
+
+// The first entry is the leftmost node
+const PersistentQueue::Entry* PersistentQueue::top() const
+{
+    const Node* node = root.get();
+    if (node == nullptr) return nullptr;
+    while (node->left) node = node->left.get();
+    return &node->entry;
+}
+
+bool PersistentQueue::pop()
+{
+    const Entry* first = top();
+    if (first == nullptr) return false;
+
+    Entry entry = *first;
+    return erase(entry);
+}
+
+size_t PersistentQueue::size() const
+{
+    return sizeOf(root);
+}
+
+bool PersistentQueue::empty() const
+{
+    return !root;
+}
+
+void PersistentQueue::clear()
+{
+    root.reset();
+}
+
+int PersistentQueue::rankOf(const Entry& entry) const
+{
+    size_t result = 0;
+    const Node* current = root.get();
+    while (current != nullptr)
+    {
+        if (current->entry.handle == entry.handle && !before(entry, current->entry) && !before(current->entry, entry))
+        {
+            return static_cast<int>(result + sizeOf(current->left));
+        }
+        if (before(entry, current->entry))
+        {
+            current = current->left.get();
+        }
+        else
+        {
+            // The current node and its whole left subtree come first
+            result += sizeOf(current->left) + 1;
+            current = current->right.get();
+        }
+    }
+    return -1;
+}
+
+// In-order walk with an explicit stack of the nodes whose left side is done
+void PersistentQueue::topEntries(size_t count, std::vector<Entry>& out) const
+{
+    out.clear();
+    std::vector<const Node*> pending;
+    const Node* node = root.get();
+    while (out.size() < count && (node != nullptr || !pending.empty()))
+    {
+        while (node != nullptr)
+        {
+            pending.push_back(node);
+            node = node->left.get();
+        }
+        node = pending.back();
+        pending.pop_back();
+        out.push_back(node->entry);
+        node = node->right.get();
+    }
+}
+
+PersistentQueue::NodePtr PersistentQueue::rebuild(const Node& node, const NodePtr& left, const NodePtr& right)
+{
+    std::shared_ptr<Node> copy = std::make_shared<Node>();
+    copy->entry = node.entry;
+    copy->priority = node.priority;
+    copy->left = left;
+    copy->right = right;
+    copy->size = 1 + sizeOf(left) + sizeOf(right);
+    return copy;
+}
+
+// Walk down while the path's priorities beat the new node's, then split the rest under it
+PersistentQueue::NodePtr PersistentQueue::insertInto(const NodePtr& tree, const NodePtr& fresh)
+{
+    if (!tree) return fresh;
+
+    if (fresh->priority > tree->priority)
+    {
+        NodePtr beforePart, restPart;
+        split(tree, fresh->entry, beforePart, restPart);
+        return rebuild(*fresh, beforePart, restPart);
+    }
+
+    if (before(fresh->entry, tree->entry))
+    {
+        return rebuild(*tree, insertInto(tree->left, fresh), tree->right);
+    }
+    return rebuild(*tree, tree->left, insertInto(tree->right, fresh));
+}
+
+PersistentQueue::NodePtr PersistentQueue::eraseFrom(const NodePtr& tree, const Entry& entry, bool& found)
+{
+    if (!tree) return tree;
+
+    if (before(entry, tree->entry))
+    {
+        NodePtr left = eraseFrom(tree->left, entry, found);
+        return found ? rebuild(*tree, left, tree->right) : tree;
+    }
+    if (before(tree->entry, entry))
+    {
+        NodePtr right = eraseFrom(tree->right, entry, found);
+        return found ? rebuild(*tree, tree->left, right) : tree;
+    }
+
+    // Same key and sequence - only the same aircraft counts
+    if (tree->entry.handle != entry.handle) return tree;
+    found = true;
+    return merge(tree->left, tree->right);
+}
+
+void PersistentQueue::split(const NodePtr& tree, const Entry& pivot, NodePtr& beforePart, NodePtr& restPart)
+{
+    if (!tree)
+    {
+        beforePart.reset();
+        restPart.reset();
+        return;
+    }
+
+    if (before(tree->entry, pivot))
+    {
+        NodePtr right;
+        split(tree->right, pivot, right, restPart);
+        beforePart = rebuild(*tree, tree->left, right);
+    }
+    else
+    {
+        NodePtr left;
+        split(tree->left, pivot, beforePart, left);
+        restPart = rebuild(*tree, left, tree->right);
+    }
+}
+
+PersistentQueue::NodePtr PersistentQueue::merge(const NodePtr& a, const NodePtr& b)
+{
+    if (!a) return b;
+    if (!b) return a;
+
+    if (a->priority > b->priority)
+    {
+        return rebuild(*a, a->left, merge(a->right, b));
+    }
+    return rebuild(*b, merge(a, b->left), b->right);
+}
@@ -0,0 +1,142 @@
+#include "../include/QueueTelemetry.h"
+#include <sstream>
+#include <iomanip>
+
+const int QueueTelemetry::flowCount;
+const int QueueTelemetry::typeCount;
+
+QueueTelemetry::QueueTelemetry()
+{
+    reset();
+}
+
+void QueueTelemetry::recordEnqueue(Flow flow, AirCraftType type)
+{
+    FlowCounters& counters = flows[flow];
+    TypeCounters& typeCounters = counters.types[static_cast<int>(type)];
+    typeCounters.enqueued.fetch_add(1, std::memory_order_relaxed);
+    typeCounters.depth.fetch_add(1, std::memory_order_relaxed);
+    counters.depthSeen.record(counters.depth.fetch_add(1, std::memory_order_relaxed) + 1);
+}
+
+void QueueTelemetry::recordDequeue(Flow flow, AirCraftType type, SimTime waitedMs, bool served)
+{
+    FlowCounters& counters = flows[flow];
+    TypeCounters& typeCounters = counters.types[static_cast<int>(type)];
+    if (served)
+    {
+        typeCounters.served.fetch_add(1, std::memory_order_relaxed);
+        typeCounters.waitMs.record(waitedMs);
+    }
+    else
+    {
+        typeCounters.removed.fetch_add(1, std::memory_order_relaxed);
+    }
+    typeCounters.depth.fetch_sub(1, std::memory_order_relaxed);
+    counters.depthSeen.record(counters.depth.fetch_sub(1, std::memory_order_relaxed) - 1);
+}
+
+QueueTelemetry::Stats QueueTelemetry::getStats(Flow flow, AirCraftType type) const
+{
+    const TypeCounters& counters = flows[flow].types[static_cast<int>(type)];
+    Stats stats;
+    stats.enqueued = counters.enqueued.load(std::memory_order_relaxed);
+    stats.served = counters.served.load(std::memory_order_relaxed);
+    stats.removed = counters.removed.load(std::memory_order_relaxed);
+    stats.depth = counters.depth.load(std::memory_order_relaxed);
+    stats.waitMs = counters.waitMs.snapshot();
+    return stats;
+}
+
+QueueTelemetry::Stats QueueTelemetry::getStats(Flow flow) const
+{
+    Stats total;
+    total.enqueued = total.served = total.removed = 0;
+    total.depth = 0;
+    for (int type = 0; type < typeCount; type++)
+    {
+        Stats stats = getStats(flow, static_cast<AirCraftType>(type));
+        total.enqueued += stats.enqueued;
+        total.served += stats.served;
+        total.removed += stats.removed;
+        total.depth += stats.depth;
+        total.waitMs.merge(stats.waitMs);
+    }
+    return total;
+}
+
+long long QueueTelemetry::getDepth(Flow flow) const
+{
+    return flows[flow].depth.load(std::memory_order_relaxed);
+}
+
+LogHistogram::Snapshot QueueTelemetry::getDepthHistogram(Flow flow) const
+{
+    return flows[flow].depthSeen.snapshot();
+}
+
+// Waits in seconds, like the engine summary's latency lines
+static void printWait(std::ostream& report, const LogHistogram::Snapshot& waitMs)
+{
+    if (waitMs.count == 0)
+    {
+        report << "no waits";
+        return;
+    }
+    report << std::fixed << std::setprecision(2)
+           << "wait mean " << waitMs.mean() / 1000.0
+           << "  p50 " << waitMs.percentile(0.50) / 1000.0
+           << "  p90 " << waitMs.percentile(0.90) / 1000.0
+           << "  p99 " << waitMs.percentile(0.99) / 1000.0
+           << "  max " << waitMs.max / 1000.0 << "  (s)";
+}
+
+std::string QueueTelemetry::getReport() const
+{
+    static const char* flowNames[] = {"Arrivals", "Departures"};
+    static const char* typeNames[] = {"Commercial", "Cargo", "Emergency", "Military", "Medical"};
+    std::stringstream report;
+
+    report << "Queue telemetry:" << std::endl;
+    for (int flow = 0; flow < flowCount; flow++)
+    {
+        Stats stats = getStats(static_cast<Flow>(flow));
+        LogHistogram::Snapshot depth = getDepthHistogram(static_cast<Flow>(flow));
+        report << "  " << std::left << std::setw(12) << flowNames[flow] << std::right
+               << stats.enqueued << " queued, " << stats.served << " served, " << stats.removed << " removed, depth "
+               << getDepth(static_cast<Flow>(flow)) << " now, p50 " << depth.percentile(0.50)
+               << " p99 " << depth.percentile(0.99) << " max " << depth.max << std::endl;
+
+        for (int type = 0; type < typeCount; type++)
+        {
+            Stats typeStats = getStats(static_cast<Flow>(flow), static_cast<AirCraftType>(type));
+            if (typeStats.enqueued == 0) continue;
+
+            report << "    " << std::left << std::setw(12) << typeNames[type] << std::right
+                   << std::setw(7) << typeStats.enqueued << " queued "
+                   << std::setw(7) << typeStats.served << " served "
+                   << std::setw(7) << typeStats.removed << " removed  ";
+            printWait(report, typeStats.waitMs);
+            report << std::endl;
+        }
+    }
+
+    return report.str();
+}
+
+void QueueTelemetry::reset()
+{
+    for (FlowCounters& counters : flows)
+    {
+        for (TypeCounters& typeCounters : counters.types)
+        {
+            typeCounters.enqueued.store(0, std::memory_order_relaxed);
+            typeCounters.served.store(0, std::memory_order_relaxed);
+            typeCounters.removed.store(0, std::memory_order_relaxed);
+            typeCounters.depth.store(0, std::memory_order_relaxed);
+            typeCounters.waitMs.reset();
+        }
+        counters.depth.store(0, std::memory_order_relaxed);
+        counters.depthSeen.reset();
+    }
+}
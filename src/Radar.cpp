@@ -3,6 +3,7 @@
 #include <iostream>
 #include <unistd.h> // For write()
 #include <cstring> // For strncpy
+#include "../include/FlightProfile.h"
 
 // Constructor initializes radar with default range
 Radar::Radar() 
@@ -30,13 +31,8 @@ void Radar::setAVNPipe(int pipeWriteEnd)
 // Monitor aircraft and detect violations
 int Radar::monitorAirCraft(Aircraft& plane) 
 {
-    // Get speed limits for the current state
-    auto limits = getSpeedLimits(plane.state);
-    int minAllowed = limits.first;
-    int maxAllowed = limits.second;
-    
-    // Check if there's a violation
-    if (checkSpeedViolation(plane, minAllowed, maxAllowed))
+    // Check if there's a violation against the limits of its current state
+    if (checkSpeedViolation(plane))
     {
         // If we detect a violation, mark the aircraft
         plane.HasViolation = true;
@@ -63,12 +59,12 @@ std::vector<Radar::ViolationInfo> Radar::detectViolations(const std::vector<Airc
         }
         
         // Get the speed limits for this aircraft's state
-        auto limits = getSpeedLimits(plane->state);
+        auto limits = getSpeedLimits(plane->type, plane->state);
         int minAllowed = limits.first;
         int maxAllowed = limits.second;
         
         // Check if there's a violation
-        if (checkSpeedViolation(*plane, minAllowed, maxAllowed))
+        if (checkSpeedViolation(*plane))
         {
             // Add this aircraft to our violations list
             ViolationInfo info;
@@ -82,6 +78,35 @@ std::vector<Radar::ViolationInfo> Radar::detectViolations(const std::vector<Airc
     return violations;
 }
 
+// Monitor every row of the aircraft table for violations
+std::vector<Radar::ViolationInfo> Radar::detectViolations(const AircraftTable& table)
+{
+    // Limits come straight from the profile table, indexed by the type and state columns
+    std::vector<ViolationInfo> violations;
+    table.forEachBlock([&](const AircraftTable::Block& block, size_t rows) {
+        for (size_t r = 0; r < rows; r++)
+        {
+            // Skip free rows and aircraft that already have active violations
+            if ((block.flags[r] & (AircraftTable::FlagLive | AircraftTable::FlagActiveViolation)) != AircraftTable::FlagLive)
+            {
+                continue;
+            }
+            
+            const PhaseProfile& phase = FlightProfile::table[block.type[r]][block.state[r]];
+            if (FlightProfile::violates(phase, block.speed[r]))
+            {
+                ViolationInfo info;
+                info.aircraft = block.aircraft[r];
+                info.minAllowed = phase.minAllowed;
+                info.maxAllowed = phase.maxAllowed;
+                violations.push_back(info);
+            }
+        }
+    });
+    
+    return violations;
+}
+
 // Process and send a single violation to the AVN Generator
 void Radar::processViolation(Aircraft* aircraft, int minAllowed, int maxAllowed)
 {
@@ -153,85 +178,45 @@ void Radar::handleViolations(const std::vector<Aircraft*>& activeFlights)
     }
 }
 
-// Get speed limits for a given flight state
-std::pair<int, int> Radar::getSpeedLimits(FlightState state) 
+// Handle violations found by a table sweep
+void Radar::handleViolations(AircraftTable& table)
 {
-    // Set allowed speed range based on aircraft state
-    // Return a pair with <minSpeed, maxSpeed>
-    switch (state)
+    if (avnPipeWriteEnd <= 0)
     {
-        case FlightState::Holding:
-            return std::make_pair(400, 600);
-            
-        case FlightState::Approach:
-            return std::make_pair(240, 290);
-            
-        case FlightState::Landing:
-            return std::make_pair(30, 240); // Landing should be between 30-240
-            
-        case FlightState::Taxi:
-            return std::make_pair(15, 30);
-            
-        case FlightState::AtGate:
-            return std::make_pair(0, 5); // At gate should be nearly stationary
-            
-        case FlightState::TakeoffRoll:
-            return std::make_pair(0, 290);
-            
-        case FlightState::Climb:
-            return std::make_pair(250, 463);
-            
-        case FlightState::Cruise: 
-            return std::make_pair(800, 900);
-            
-        default:
-            // Unknown state - use conservative limits
-            return std::make_pair(0, 1000); 
+        // No pipe set up - can't send violations
+        std::cout << "Radar: No AVN pipe set up - can't send violations" << std::endl;
+        return;
+    }
+    
+    std::vector<ViolationInfo> violations = detectViolations(table);
+    for (const ViolationInfo& violationInfo : violations)
+    {
+        processViolation(violationInfo.aircraft, violationInfo.minAllowed, violationInfo.maxAllowed);
+        
+        // Keep the next sweep from reporting it again before the engine syncs the row
+        table.setFlags(violationInfo.aircraft->tableHandle, AircraftTable::FlagActiveViolation, true);
     }
 }
 
+// Get speed limits for a given flight state (the standard envelope from the profile table)
+std::pair<int, int> Radar::getSpeedLimits(FlightState state) 
+{
+    return getSpeedLimits(AirCraftType::Commercial, state);
+}
+
+// Get speed limits for a given aircraft type and flight state
+std::pair<int, int> Radar::getSpeedLimits(AirCraftType type, FlightState state)
+{
+    const PhaseProfile& phase = FlightProfile::get(type, state);
+    return std::make_pair(phase.minAllowed, phase.maxAllowed);
+}
+
 // Check if aircraft speed violates limits
-bool Radar::checkSpeedViolation(const Aircraft& aircraft, int minAllowed, int maxAllowed) 
+// Which sides are checked comes from the aircraft's profile, same rule Aircraft::checkForViolation() uses;
+// minAllowed/maxAllowed are only what gets reported
+bool Radar::checkSpeedViolation(const Aircraft& aircraft) 
 {
-    // Different states have different violation criteria
-    switch (aircraft.state)
-    {
-        case FlightState::Holding:
-            // Holding only has upper limit violation
-            return (aircraft.speed > maxAllowed);
-            
-        case FlightState::Approach:
-            // Approach has both lower and upper limit violations
-            return (aircraft.speed < minAllowed || aircraft.speed > maxAllowed);
-            
-        case FlightState::Landing:
-            // Landing only has upper limit violation
-            return (aircraft.speed > maxAllowed);
-            
-        case FlightState::Taxi:
-            // Taxi only has upper limit violation
-            return (aircraft.speed > maxAllowed);
-            
-        case FlightState::AtGate:
-            // Special case for at gate - violation if > 10
-            return (aircraft.speed > 10);
-            
-        case FlightState::TakeoffRoll:
-            // Takeoff only has upper limit violation
-            return (aircraft.speed > maxAllowed);
-            
-        case FlightState::Climb:
-            // Climb only has upper limit violation
-            return (aircraft.speed > maxAllowed);
-            
-        case FlightState::Cruise:
-            // Cruise has both lower and upper limit violations
-            return (aircraft.speed < minAllowed || aircraft.speed > maxAllowed);
-            
-        default:
-            // For unknown states, no violation
-            return false;
-    }
+    return FlightProfile::violates(FlightProfile::get(aircraft.type, aircraft.state), aircraft.speed);
 }
 
 // Simulate a violation for testing purposes
@@ -0,0 +1,150 @@
+#include "../include/RankIndex.h"
+#include "../include/CounterRandom.h"
+
+RankIndex::RankIndex()
+    : root(-1), priorityKey(CounterRandom::keyFor("rank-index", 0))
+{
+}
+
+bool RankIndex::insert(AircraftHandle handle, long long key, unsigned long long sequence)
+{
+    if (handle == invalidAircraftHandle || contains(handle)) return false;
+
+    if (handle >= nodeOf.size())
+    {
+        nodeOf.resize(handle + 1, -1);
+    }
+
+    int node;
+    if (!freeNodes.empty())
+    {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else
+    {
+        node = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node& fresh = nodes[node];
+    fresh.key = key;
+    fresh.sequence = sequence;
+    fresh.priority = CounterRandom::at(priorityKey, sequence);
+    fresh.left = -1;
+    fresh.right = -1;
+    fresh.size = 1;
+    fresh.handle = handle;
+    nodeOf[handle] = node;
+
+    // Everything before the new node, the node, then everything after it
+    int beforePart, restPart;
+    split(root, node, beforePart, restPart);
+    root = merge(merge(beforePart, node), restPart);
+    return true;
+}
+
+bool RankIndex::erase(AircraftHandle handle)
+{
+    if (!contains(handle)) return false;
+
+    int node = nodeOf[handle];
+
+    // Walk down to the node, shrinking the subtrees we pass through
+    int* link = &root;
+    while (*link != node)
+    {
+        nodes[*link].size--;
+        link = before(node, *link) ? &nodes[*link].left : &nodes[*link].right;
+    }
+    *link = merge(nodes[node].left, nodes[node].right);
+
+    nodeOf[handle] = -1;
+    freeNodes.push_back(node);
+    return true;
+}
+
+int RankIndex::rank(AircraftHandle handle) const
+{
+    if (!contains(handle)) return -1;
+
+    int node = nodeOf[handle];
+    int result = 0;
+    int current = root;
+    while (current != node)
+    {
+        if (before(node, current))
+        {
+            current = nodes[current].left;
+        }
+        else
+        {
+            // The current node and its whole left subtree come first
+            result += sizeOf(nodes[current].left) + 1;
+            current = nodes[current].right;
+        }
+    }
+    return result + sizeOf(nodes[node].left);
+}
+
+bool RankIndex::contains(AircraftHandle handle) const
+{
+    return handle < nodeOf.size() && nodeOf[handle] >= 0;
+}
+
+size_t RankIndex::size() const
+{
+    return static_cast<size_t>(sizeOf(root));
+}
+
+void RankIndex::clear()
+{
+    nodes.clear();
+    freeNodes.clear();
+    nodeOf.assign(nodeOf.size(), -1);
+    root = -1;
+}
+
+void RankIndex::resize(int node)
+{
+    nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+}
+
+void RankIndex::split(int tree, int pivot, int& beforePart, int& restPart)
+{
+    if (tree < 0)
+    {
+        beforePart = -1;
+        restPart = -1;
+        return;
+    }
+
+    if (before(tree, pivot))
+    {
+        split(nodes[tree].right, pivot, nodes[tree].right, restPart);
+        beforePart = tree;
+    }
+    else
+    {
+        split(nodes[tree].left, pivot, beforePart, nodes[tree].left);
+        restPart = tree;
+    }
+    resize(tree);
+}
+
+int RankIndex::merge(int a, int b)
+{
+    if (a < 0) return b;
+    if (b < 0) return a;
+
+    if (nodes[a].priority > nodes[b].priority)
+    {
+        nodes[a].right = merge(nodes[a].right, b);
+        resize(a);
+        return a;
+    }
+
+    nodes[b].left = merge(a, nodes[b].left);
+    resize(b);
+    return b;
+}
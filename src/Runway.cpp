@@ -1,56 +1,133 @@
 #include "../include/Runway.h"
+#include <limits>
 using namespace std;
 
+const SimTime RunwayClass::defaultLeaseMs;
+
 // Constructor initializes runway properties
-RunwayClass::RunwayClass() {
+RunwayClass::RunwayClass()
+    : lease(noRunwayLease), leaseExpiry(0), leaseSequence(0) {
     id = "";
     type = RunwayType::Arrival;
-    isOccupied = false;
-    turn = 0;
+    index = -1;
+    capabilities = defaultCapabilities(type);
 }
 
-RunwayClass::RunwayClass(string run, RunwayType Inputtype, bool occupied ) {
+// An occupied runway starts with a lease nobody owns that never expires
+RunwayClass::RunwayClass(string run, RunwayType Inputtype, bool occupied )
+    : lease(noRunwayLease), leaseExpiry(0), leaseSequence(0) {
     id = run;
     type = Inputtype;
-    isOccupied = occupied;
-    turn = 0;
+    index = -1;
+    capabilities = defaultCapabilities(type);
+    if (occupied) acquire(invalidAircraftHandle, 0, numeric_limits<SimTime>::max());
+}
+
+RunwayClass::RunwayClass(const RunwayClass& other)
+    : id(other.id), type(other.type), index(other.index), capabilities(other.capabilities),
+      lease(other.lease.load()), leaseExpiry(other.leaseExpiry.load()), leaseSequence(other.leaseSequence.load()) {
+}
+
+RunwayClass& RunwayClass::operator=(const RunwayClass& other) {
+    id = other.id;
+    type = other.type;
+    index = other.index;
+    capabilities = other.capabilities;
+    lease.store(other.lease.load());
+    leaseExpiry.store(other.leaseExpiry.load());
+    leaseSequence.store(other.leaseSequence.load());
+    return *this;
 }
 
 // Try to assign runway to an aircraft based on compatibility
-bool RunwayClass::tryAssign(Aircraft &plane) {
-    if (isOccupied) return false;
+bool RunwayClass::tryAssign(Aircraft &plane, SimTime leaseMs) {
+    // Arrival runways take N/S flights, departure runways E/W flights, flexible ones
+    // everything (cargo whatever its direction) - all through the capability bits
+    if (!canServe(plane)) return false;
     
-    // Assign runway based on direction
-    switch(plane.direction) {
-        case Direction::North:
-        case Direction::South:
-            if (type == RunwayType::Arrival || type == RunwayType::Flexible) {
-                isOccupied = true;
-                return true;
-            }
-            break;
-        case Direction::East:
-        case Direction::West:
-            if (type == RunwayType::Departure || type == RunwayType::Flexible) {
-                isOccupied = true;
-                return true;
-            }
-            break;
-    }
+    RunwayLease taken = acquire(plane.tableHandle, SimClock::instance().now(), leaseMs);
+    if (taken == noRunwayLease) return false;
     
-    // Special case for cargo
-    if (plane.type == AirCraftType::Cargo && type == RunwayType::Flexible) {
-        isOccupied = true;
-        return true;
+    plane.runwayLease = taken;
+    plane.assignedRunway = index;
+    return true;
+}
+
+// The expiry is stored before the CAS, so nobody sees the new lease with the old
+// expiry. Two acquirers racing for a free runway both store theirs - the loser's
+// differs from the winner's only by how far apart their 'now' was.
+RunwayLease RunwayClass::acquire(AircraftHandle owner, SimTime now, SimTime leaseMs) {
+    SimTime expiry = (leaseMs > numeric_limits<SimTime>::max() - now) ? numeric_limits<SimTime>::max()
+                                                                      : now + leaseMs;
+    RunwayLease current = lease.load(memory_order_acquire);
+    RunwayLease fresh = noRunwayLease;
+    for (;;) {
+        if (current != noRunwayLease && leaseExpiry.load(memory_order_acquire) > now) {
+            return noRunwayLease;   // Held, and the lease still counts
+        }
+        
+        // Sequence 0 never goes out, so a lease is never the free word
+        while (fresh == noRunwayLease) {
+            unsigned sequence = leaseSequence.fetch_add(1, memory_order_relaxed) + 1;
+            fresh = (sequence == 0) ? noRunwayLease : ((static_cast<RunwayLease>(sequence) << 32) | owner);
+        }
+        
+        leaseExpiry.store(expiry, memory_order_release);
+        if (lease.compare_exchange_weak(current, fresh, memory_order_acq_rel, memory_order_acquire)) {
+            return fresh;
+        }
     }
-    
-    return false;
 }
 
-// Release the runway after use
-void RunwayClass::release() {
-    isOccupied = false;
-    turn++;
+bool RunwayClass::release(RunwayLease held) {
+    if (held == noRunwayLease) return false;
+    return lease.compare_exchange_strong(held, noRunwayLease, memory_order_acq_rel, memory_order_acquire);
+}
+
+bool RunwayClass::isOccupied() const {
+    return isOccupied(SimClock::instance().now());
+}
+
+bool RunwayClass::isOccupied(SimTime now) const {
+    return lease.load(memory_order_acquire) != noRunwayLease && leaseExpiry.load(memory_order_acquire) > now;
+}
+
+RunwayLease RunwayClass::getLease() const {
+    return lease.load(memory_order_acquire);
+}
+
+SimTime RunwayClass::getLeaseExpiry() const {
+    return leaseExpiry.load(memory_order_acquire);
+}
+
+AircraftHandle RunwayClass::ownerOf(RunwayLease held) {
+    return static_cast<AircraftHandle>(held & 0xFFFFFFFFull);
+}
+
+bool RunwayClass::canServe(const Aircraft& plane) const {
+    return (requirementsOf(plane) & ~capabilities) == 0;
+}
+
+// Cargo is the flexible runways' alone (RWY-C), like the cargo rule in the requirements
+unsigned RunwayClass::defaultCapabilities(RunwayType type) {
+    switch (type) {
+        case RunwayType::Arrival:
+            return RunwayEmergencies | RunwayArrivals | RunwayNorthSouth;
+        case RunwayType::Departure:
+            return RunwayEmergencies | RunwayDepartures | RunwayEastWest;
+        case RunwayType::Flexible:
+            break;
+    }
+    return RunwayCargo | RunwayEmergencies | RunwayArrivals | RunwayDepartures | RunwayNorthSouth | RunwayEastWest;
+}
+
+unsigned RunwayClass::requirementsOf(const Aircraft& plane) {
+    unsigned needs = (plane.direction == Direction::North || plane.direction == Direction::South)
+                         ? (RunwayArrivals | RunwayNorthSouth)
+                         : (RunwayDepartures | RunwayEastWest);
+    if (plane.EmergencyNo > 0) needs |= RunwayEmergencies;
+    else if (plane.type == AirCraftType::Cargo) needs |= RunwayCargo;   // An emergency may use any runway
+    return needs;
 }
 
 // ======== SFML Visualization Abstraction Functions ========
@@ -82,7 +159,7 @@ std::string RunwayClass::getStatusText() const
     status += getTypeString();
     
     // Add occupancy status
-    status += isOccupied ? ", OCCUPIED)" : ", AVAILABLE)";
+    status += isOccupied() ? ", OCCUPIED)" : ", AVAILABLE)";
     
     return status;
 }
@@ -96,7 +173,7 @@ int* RunwayClass::getStatusColor() const
     // Using static array to avoid memory leaks
     static int color[3];
     
-    if (isOccupied) {
+    if (isOccupied()) {
         // Red for occupied runway
         color[0] = 255; // R
         color[1] = 0;   // G
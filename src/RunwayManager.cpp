@@ -20,7 +20,7 @@ RunwayManager::~RunwayManager()
 /**
  * Initialize runways with predefined configurations
  */
-void RunwayManager::initialize() 
+void RunwayManager::initialize(int runwayCount) 
 {
     // Clear any existing runways
     runways.clear();
@@ -36,6 +36,21 @@ void RunwayManager::initialize()
     // RWY-C: Flexible for cargo/emergency/overflow
     runways.emplace_back("RWY-C", RunwayType::Flexible, false);
 
+    // Bigger airports (headless engine runs) get extra runways: RWY-D, RWY-E, ...
+    // cycling arrival/departure/flexible like the first three
+    static const RunwayType typeCycle[] = {RunwayType::Arrival, RunwayType::Departure, RunwayType::Flexible};
+    for (int i = 3; i < runwayCount; i++)
+    {
+        std::string id = (i < 26) ? std::string("RWY-") + static_cast<char>('A' + i)
+                                  : "RWY-" + std::to_string(i + 1);
+        runways.emplace_back(id, typeCycle[i % 3], false);
+    }
+    
+    // Let each runway know where it sits, so flights can name the runway they got
+    for (size_t i = 0; i < runways.size(); i++)
+    {
+        runways[i].index = static_cast<int>(i);
+    }
 }
 
 /**
@@ -66,7 +81,7 @@ std::string RunwayManager::getStatusReport() const
     report << "--- RUNWAY STATUS UPDATE ---\n";
     
     for (size_t i = 0; i < runways.size(); ++i) {
-        report << runways[i].id << ": " << (runways[i].isOccupied ? "OCCUPIED" : "AVAILABLE") << "\n";
+        report << runways[i].id << ": " << (runways[i].isOccupied() ? "OCCUPIED" : "AVAILABLE") << "\n";
     }
     
     report << "---------------------------";
@@ -86,7 +101,7 @@ bool RunwayManager::isRunwayAvailable(const std::string& runwayId)
         if (runways[i].id == runwayId) 
         {
             // Found the runway, return its availability status (opposite of occupied)
-            return !runways[i].isOccupied;
+            return !runways[i].isOccupied();
         }
     }
     
@@ -133,7 +148,7 @@ std::vector<RunwayClass*> RunwayManager::getAvailableRunways() const
     for (size_t i = 0; i < runways.size(); i++)
     {
         // If the runway is not occupied, add a pointer to it in our result vector
-        if (!runways[i].isOccupied)
+        if (!runways[i].isOccupied())
         {
             // The const_cast is safe here because we're not modifying the runway
             // It's just needed because the function is const but returns non-const pointers
@@ -156,7 +171,7 @@ std::vector<RunwayClass*> RunwayManager::getOccupiedRunways() const
     for (size_t i = 0; i < runways.size(); i++)
     {
         // If the runway is occupied, add a pointer to it in our result vector
-        if (runways[i].isOccupied)
+        if (runways[i].isOccupied())
         {
             // Same const_cast reasoning as above
             occupiedRunways.push_back(const_cast<RunwayClass*>(&runways[i]));
@@ -180,7 +195,7 @@ int* RunwayManager::getRunwayStatistics() const
     int occupied = 0;
     for (const auto& runway : runways)
     {
-        if (runway.isOccupied) occupied++;
+        if (runway.isOccupied()) occupied++;
     }
     
     // Fill our statistics array
@@ -204,7 +219,7 @@ float RunwayManager::getAvailabilityPercentage() const
     int available = 0;
     for (const auto& runway : runways)
     {
-        if (!runway.isOccupied) available++;
+        if (!runway.isOccupied()) available++;
     }
     
     // Calculate and return percentage
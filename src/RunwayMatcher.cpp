@@ -0,0 +1,129 @@
+#include "../include/RunwayMatcher.h"
+#include <algorithm>
+
+const int RunwayMatcher::maskCount;
+
+// Bits set in a mask
+static int bitCount(unsigned mask)
+{
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) count++;
+    return count;
+}
+
+// For every requirement, the masks that have all its bits, fewest bits first
+RunwayMatcher::RunwayMatcher()
+    : freeByMask(maskCount), fitting(maskCount), freeCount(0)
+{
+    for (unsigned requirements = 0; requirements < static_cast<unsigned>(maskCount); requirements++)
+    {
+        for (unsigned mask = 0; mask < static_cast<unsigned>(maskCount); mask++)
+        {
+            if ((requirements & ~mask) == 0) fitting[requirements].push_back(mask);
+        }
+        std::stable_sort(fitting[requirements].begin(), fitting[requirements].end(),
+                         [](unsigned a, unsigned b) { return bitCount(a) < bitCount(b); });
+    }
+}
+
+void RunwayMatcher::setRunways(const std::vector<RunwayClass*>& newRunways)
+{
+    runways = newRunways;
+    positionOf.assign(runways.size(), -1);
+    runwayOf.clear();
+    for (size_t position = 0; position < runways.size(); position++)
+    {
+        int index = runways[position]->index;
+        if (index < 0) continue;
+        if (index >= static_cast<int>(runwayOf.size())) runwayOf.resize(index + 1, -1);
+        runwayOf[index] = static_cast<int>(position);
+    }
+    refresh();
+}
+
+void RunwayMatcher::refresh()
+{
+    for (std::vector<int>& bucket : freeByMask)
+    {
+        bucket.clear();
+    }
+    freeCount = 0;
+
+    // A runway whose lease ran out counts as free - tryAssign() takes it over
+    SimTime now = SimClock::instance().now();
+    for (size_t position = 0; position < runways.size(); position++)
+    {
+        const RunwayClass* runway = runways[position];
+        if (runway->isOccupied(now))
+        {
+            positionOf[position] = -1;
+            continue;
+        }
+
+        std::vector<int>& bucket = freeByMask[runway->capabilities & (maskCount - 1)];
+        positionOf[position] = static_cast<int>(bucket.size());
+        bucket.push_back(static_cast<int>(position));
+        freeCount++;
+    }
+}
+
+RunwayClass* RunwayMatcher::claim(unsigned requirements, int preferredIndex)
+{
+    if (preferredIndex >= 0 && preferredIndex < static_cast<int>(runwayOf.size()))
+    {
+        int position = runwayOf[preferredIndex];
+        if (position >= 0 && positionOf[position] >= 0 && (requirements & ~runways[position]->capabilities) == 0)
+        {
+            take(position);
+            return runways[position];
+        }
+    }
+
+    int position = find(requirements);
+    if (position < 0) return nullptr;
+
+    take(position);
+    return runways[position];
+}
+
+RunwayClass* RunwayMatcher::peek(unsigned requirements) const
+{
+    int position = find(requirements);
+    return position >= 0 ? runways[position] : nullptr;
+}
+
+size_t RunwayMatcher::getFreeCount() const
+{
+    return freeCount;
+}
+
+const std::vector<RunwayClass*>& RunwayMatcher::getRunways() const
+{
+    return runways;
+}
+
+// First non-empty bucket in best-fit order - at most 64 looks whatever the runway count
+int RunwayMatcher::find(unsigned requirements) const
+{
+    if (requirements >= static_cast<unsigned>(maskCount)) return -1;    // Needs a capability nobody has
+
+    for (unsigned mask : fitting[requirements])
+    {
+        const std::vector<int>& bucket = freeByMask[mask];
+        if (!bucket.empty()) return bucket.back();
+    }
+    return -1;
+}
+
+// Swap the last runway of the bucket into the hole
+void RunwayMatcher::take(int position)
+{
+    std::vector<int>& bucket = freeByMask[runways[position]->capabilities & (maskCount - 1)];
+    int slot = positionOf[position];
+    int last = bucket.back();
+    bucket[slot] = last;
+    positionOf[last] = slot;
+    bucket.pop_back();
+    positionOf[position] = -1;
+    freeCount--;
+}
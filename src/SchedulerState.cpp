@@ -0,0 +1,168 @@
+#include "../include/SchedulerState.h"
+#include <algorithm>
+
+SchedulerState::SchedulerState()
+    : now(0), assignedDelay(0)
+{
+}
+
+SchedulerState::SchedulerState(const PersistentQueue& arrivals, const PersistentQueue& departures,
+                               const std::vector<Runway>& runways, SimTime now)
+    : arrivals(arrivals), departures(departures), runways(runways), now(now), assignedDelay(0)
+{
+}
+
+SchedulerState SchedulerState::fork() const
+{
+    return *this;
+}
+
+// The flight is looked up in the queue of the flow the runway takes - arrivals first
+bool SchedulerState::assign(const PersistentQueue::Entry& flight, int runwayIndex)
+{
+    Runway* runway = findRunway(runwayIndex);
+    if (runway == nullptr) return false;
+
+    if (takes(*runway, true) && arrivals.erase(flight))
+    {
+        book(*runway, flight, true);
+        return true;
+    }
+    if (takes(*runway, false) && departures.erase(flight))
+    {
+        book(*runway, flight, false);
+        return true;
+    }
+    return false;
+}
+
+// A flexible runway takes the better of the two queue tops (arrivals on a tie, like the ATC)
+bool SchedulerState::assignNext(int runwayIndex)
+{
+    Runway* runway = findRunway(runwayIndex);
+    if (runway == nullptr) return false;
+
+    const PersistentQueue::Entry* arrival = takes(*runway, true) ? arrivals.top() : nullptr;
+    const PersistentQueue::Entry* departure = takes(*runway, false) ? departures.top() : nullptr;
+    if (arrival == nullptr && departure == nullptr) return false;
+
+    bool takeArrival = arrival != nullptr && (departure == nullptr || arrival->key >= departure->key);
+    PersistentQueue::Entry flight = takeArrival ? *arrival : *departure;
+    if (takeArrival) arrivals.pop();
+    else departures.pop();
+
+    book(*runway, flight, takeArrival);
+    return true;
+}
+
+SimTime SchedulerState::getAssignedDelay() const
+{
+    return assignedDelay;
+}
+
+// Reads the first 'horizon' entries of each queue without changing them, then hands
+// them out like assignNext() would, always to the runway that frees up first
+SimTime SchedulerState::score(size_t horizon) const
+{
+    std::vector<PersistentQueue::Entry> queued[2];
+    arrivals.topEntries(horizon, queued[0]);
+    departures.topEntries(horizon, queued[1]);
+    size_t next[2] = {0, 0};
+
+    std::vector<SimTime> freeAt;
+    for (const Runway& runway : runways)
+    {
+        freeAt.push_back(runway.freeAt);
+    }
+
+    SimTime projected = 0;
+    for (size_t placed = 0; placed < horizon; placed++)
+    {
+        int best = -1;
+        int bestFlow = -1;
+        for (size_t r = 0; r < runways.size(); r++)
+        {
+            int flow = -1;
+            for (int f = 0; f < 2; f++)
+            {
+                if (!takes(runways[r], f == 0) || next[f] >= queued[f].size()) continue;
+                if (flow < 0 || queued[f][next[f]].key > queued[flow][next[flow]].key) flow = f;
+            }
+            if (flow < 0) continue;
+
+            if (best < 0 || freeAt[r] < freeAt[best])
+            {
+                best = static_cast<int>(r);
+                bestFlow = flow;
+            }
+        }
+        if (best < 0) break;    // Nothing left that any runway takes
+
+        const PersistentQueue::Entry& flight = queued[bestFlow][next[bestFlow]++];
+        SimTime start = std::max(now, freeAt[best]);
+        freeAt[best] = start + runways[best].serviceMs[static_cast<int>(flight.type)];
+        projected += start - flight.entryTime;
+    }
+
+    return assignedDelay + projected;
+}
+
+std::vector<SchedulerState::Assignment> SchedulerState::getAssignments() const
+{
+    std::vector<Assignment> result;
+    for (const AssignmentNode* node = lastAssignment.get(); node != nullptr; node = node->previous.get())
+    {
+        result.push_back(node->assignment);
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+const PersistentQueue& SchedulerState::getArrivals() const
+{
+    return arrivals;
+}
+
+const PersistentQueue& SchedulerState::getDepartures() const
+{
+    return departures;
+}
+
+const std::vector<SchedulerState::Runway>& SchedulerState::getRunways() const
+{
+    return runways;
+}
+
+SimTime SchedulerState::getTime() const
+{
+    return now;
+}
+
+SchedulerState::Runway* SchedulerState::findRunway(int runwayIndex)
+{
+    for (Runway& runway : runways)
+    {
+        if (runway.index == runwayIndex) return &runway;
+    }
+    return nullptr;
+}
+
+bool SchedulerState::takes(const Runway& runway, bool arrival)
+{
+    if (runway.type == RunwayType::Flexible) return true;
+    return arrival ? runway.type == RunwayType::Arrival : runway.type == RunwayType::Departure;
+}
+
+void SchedulerState::book(Runway& runway, const PersistentQueue::Entry& flight, bool arrival)
+{
+    std::shared_ptr<AssignmentNode> node = std::make_shared<AssignmentNode>();
+    node->assignment.flight = flight;
+    node->assignment.runway = runway.index;
+    node->assignment.arrival = arrival;
+    node->assignment.start = std::max(now, runway.freeAt);
+    node->previous = lastAssignment;
+
+    runway.freeAt = node->assignment.start + runway.serviceMs[static_cast<int>(flight.type)];
+    assignedDelay += node->assignment.start - flight.entryTime;
+    lastAssignment = node;
+}
@@ -0,0 +1,85 @@
+#include "../include/ServiceTimeModel.h"
+
+const int ServiceTimeModel::typeCount;
+
+ServiceTimeModel::ServiceTimeModel(SimTime defaultServiceMs, double smoothing)
+    : defaultService(defaultServiceMs), alpha(smoothing), totalSamples(0)
+{
+}
+
+void ServiceTimeModel::record(int runwayIndex, AirCraftType type, bool arrival, SimTime serviceMs)
+{
+    if (runwayIndex < 0 || serviceMs < 0) return;
+
+    std::lock_guard<std::mutex> lock(modelMutex);
+    if (runwayIndex >= static_cast<int>(runways.size()))
+    {
+        RunwayStats empty = {};
+        runways.resize(runwayIndex + 1, empty);
+    }
+
+    RunwayStats& stats = runways[runwayIndex];
+    int typeIndex = static_cast<int>(type);
+    smooth(stats.byType[typeIndex], stats.typeSamples[typeIndex]++, static_cast<double>(serviceMs));
+    smooth(stats.overall, stats.samples++, static_cast<double>(serviceMs));
+    if (arrival) stats.servesArrivals = true;
+    else stats.servesDepartures = true;
+    totalSamples++;
+}
+
+SimTime ServiceTimeModel::getServiceTime(int runwayIndex, AirCraftType type) const
+{
+    std::lock_guard<std::mutex> lock(modelMutex);
+    if (runwayIndex < 0 || runwayIndex >= static_cast<int>(runways.size())) return defaultService;
+
+    const RunwayStats& stats = runways[runwayIndex];
+    int typeIndex = static_cast<int>(type);
+    if (stats.typeSamples[typeIndex] > 0) return static_cast<SimTime>(stats.byType[typeIndex]);
+    if (stats.samples > 0) return static_cast<SimTime>(stats.overall);
+    return defaultService;
+}
+
+SimTime ServiceTimeModel::getServiceTime(int runwayIndex) const
+{
+    std::lock_guard<std::mutex> lock(modelMutex);
+    if (runwayIndex < 0 || runwayIndex >= static_cast<int>(runways.size())) return defaultService;
+
+    const RunwayStats& stats = runways[runwayIndex];
+    return stats.samples > 0 ? static_cast<SimTime>(stats.overall) : defaultService;
+}
+
+/**
+ * Runways that served the flow work in parallel, so their service rates add up
+ */
+SimTime ServiceTimeModel::estimateWait(int ahead, bool arrival) const
+{
+    if (ahead <= 0) return 0;
+
+    std::lock_guard<std::mutex> lock(modelMutex);
+    double rate = 0.0;     // Flights per millisecond
+    for (const RunwayStats& stats : runways)
+    {
+        bool serves = arrival ? stats.servesArrivals : stats.servesDepartures;
+        if (serves && stats.overall > 0.0)
+        {
+            rate += 1.0 / stats.overall;
+        }
+    }
+
+    if (rate <= 0.0)
+    {
+        return static_cast<SimTime>(ahead) * defaultService;
+    }
+    return static_cast<SimTime>(ahead / rate);
+}
+
+unsigned long long ServiceTimeModel::getSampleCount() const
+{
+    std::lock_guard<std::mutex> lock(modelMutex);
+    return totalSamples;
+}
+
+void ServiceTimeModel::smooth(double& average, unsigned long long count, double sample) const
+{
+    average = (count == 0) ? sample : average + alpha * (sample - average);
+}
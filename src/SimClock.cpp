@@ -0,0 +1,138 @@
+#include "../include/SimClock.h"
+
+SimClock* SimClock::globalClock = nullptr;
+thread_local SimClock* SimClock::threadClock = nullptr;
+
+/**
+ * Constructor sets the mode and starts simulated time at 0
+ */
+SimClock::SimClock(ClockMode clockMode, double timeScale)
+    : virtualNow(0)
+{
+    configure(clockMode, timeScale);
+}
+
+/**
+ * Get the thread's clock, else the process-wide one (real time unless someone injected another one)
+ */
+SimClock& SimClock::instance()
+{
+    static SimClock defaultClock;
+    if (threadClock) return *threadClock;
+    return globalClock ? *globalClock : defaultClock;
+}
+
+void SimClock::setInstance(SimClock* clock)
+{
+    globalClock = clock;
+}
+
+void SimClock::bindThread(SimClock* clock)
+{
+    threadClock = clock;
+}
+
+/**
+ * Switch mode and restart simulated time from 0
+ */
+void SimClock::configure(ClockMode clockMode, double timeScale)
+{
+    mode = clockMode;
+
+    // RealTime is just Scaled with a factor of 1
+    scale = (mode == ClockMode::RealTime || timeScale <= 0.0) ? 1.0 : timeScale;
+    epoch = std::chrono::steady_clock::now();
+    virtualNow = 0;
+}
+
+/**
+ * Current simulated time in milliseconds
+ */
+SimTime SimClock::now() const
+{
+    if (mode == ClockMode::AsFastAsPossible)
+    {
+        return virtualNow.load();
+    }
+
+    auto realElapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+    return static_cast<SimTime>(realElapsed * scale / 1000.0);
+}
+
+long long SimClock::nowSeconds() const
+{
+    return now() / 1000;
+}
+
+void SimClock::sleepFor(SimTime durationMs)
+{
+    sleepUntil(now() + durationMs);
+}
+
+/**
+ * Sleep until the simulated time is reached.
+ * In AsFastAsPossible mode we wait for someone to advance the clock.
+ */
+void SimClock::sleepUntil(SimTime targetTime)
+{
+    if (mode == ClockMode::AsFastAsPossible)
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this, targetTime]() { return virtualNow.load() >= targetTime; });
+        return;
+    }
+
+    std::chrono::microseconds realWait = realTimeUntil(targetTime);
+    if (realWait.count() > 0)
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait_for(lock, realWait);
+    }
+}
+
+/**
+ * Convert a simulated deadline into a real-time wait
+ */
+std::chrono::microseconds SimClock::realTimeUntil(SimTime targetTime) const
+{
+    SimTime remaining = targetTime - now();
+    if (remaining <= 0 || mode == ClockMode::AsFastAsPossible)
+    {
+        return std::chrono::microseconds(0);
+    }
+    return std::chrono::microseconds(static_cast<long long>(remaining * 1000.0 / scale));
+}
+
+/**
+ * Jump virtual time forward - never backwards
+ */
+void SimClock::advanceTo(SimTime targetTime)
+{
+    if (mode != ClockMode::AsFastAsPossible) return;
+
+    SimTime current = virtualNow.load();
+    while (targetTime > current && !virtualNow.compare_exchange_weak(current, targetTime))
+    {
+        // current was reloaded by compare_exchange_weak, try again
+    }
+
+    // Wake anyone sleeping on virtual time
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    sleepCondition.notify_all();
+}
+
+bool SimClock::isVirtual() const
+{
+    return mode == ClockMode::AsFastAsPossible;
+}
+
+ClockMode SimClock::getMode() const
+{
+    return mode;
+}
+
+double SimClock::getScale() const
+{
+    return scale;
+}
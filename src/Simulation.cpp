@@ -1,5 +1,6 @@
 #include "../include/Simulation.h"
 #include "../include/visual/Visualizer.h"
+#include "../include/CounterRandom.h"
 
 /**
  * Constructor initializes simulation components and default parameters
@@ -18,8 +19,8 @@ Simulation::Simulation()
     isRunning = false;
     isPaused = false;
     
-    // Seed random number generator
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    // Seed the simulation's random streams (a different run every time)
+    CounterRandom::setSeed(static_cast<unsigned long long>(std::time(nullptr)));
 }
 
 /**
@@ -89,21 +90,26 @@ bool Simulation::run()
     isRunning = true;
     
     try {
-        // Launch ATC controller thread
-        if (!simulationManager->launchATCControllerThread()) {
-            std::cerr << "Failed to launch ATC controller thread!" << std::endl;
+        // Launch ATC controller loop
+        if (!simulationManager->launchATCController()) {
+            std::cerr << "Failed to launch ATC controller!" << std::endl;
             return false;
         }
         
         // Create random emergency for testing
         simulationManager->createRandomEmergency(airlineManager->getAllAirlines());
         
-        std::cout << "Launching aircraft threads..." << std::endl;
+        std::cout << "Launching aircraft..." << std::endl;
         
-        // Launch aircraft threads for each airline with a short delay between
+        // Hand every airline's aircraft to the simulation engine
         for (Airline* airline : airlineManager->getAllAirlines()) {
-            simulationManager->launchAirlineThreads(airline);
-            // No sleep here - faster startup for visual version
+            simulationManager->launchAirlineFlights(airline);
+        }
+        
+        // Everything is queued - let the engine workers go
+        if (!simulationManager->startSimulation()) {
+            std::cerr << "Failed to start simulation engine!" << std::endl;
+            return false;
         }
         
         std::cout << "All aircraft launched, simulation running..." << std::endl;
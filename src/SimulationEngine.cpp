@@ -0,0 +1,882 @@
+#include "../include/SimulationEngine.h"
+#include <algorithm>
+#include <limits>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// One step of a flight's phase sequence and how long it lasts
+struct PhaseStep
+{
+    FlightState state;
+    int durationSeconds;
+};
+
+// Arrivals: Holding -> Approach -> Landing -> Taxi -> AtGate
+static const PhaseStep arrivalPhases[] = {
+    {FlightState::Approach, 3},
+    {FlightState::Landing, 2},
+    {FlightState::Taxi, 2},
+    {FlightState::AtGate, 0}
+};
+
+// Departures: AtGate -> Taxi -> TakeoffRoll -> Climb -> Cruise
+static const PhaseStep departurePhases[] = {
+    {FlightState::Taxi, 2},
+    {FlightState::TakeoffRoll, 2},
+    {FlightState::Climb, 2},
+    {FlightState::Cruise, 0}
+};
+
+static const int phaseCount = 4;            // Both sequences have four steps
+static const int runwayTimeoutSeconds = 30; // Give up waiting for a runway after this
+static const int statusIntervalSeconds = 5; // Print wait estimates this often
+static const size_t stepGrainSize = 64;     // Aircraft per step task
+
+/**
+ * Constructor stores references to the shared components
+ */
+SimulationEngine::SimulationEngine(ATCScontroller* atc, RunwayManager* rwm, SimClock* simClock)
+    : atcController(atc), runwayManager(rwm), nextSequence(0), horizon(std::numeric_limits<SimTime>::max()),
+      running(false), busyWorkers(0), cpuAffinity(-1), activeTasks(0), stepInterval(1000), stepWorkers(0), stepArmed(false),
+      controllerEvents(false), controllerArmed(false), activeFlights(0), completedFlights(0), timedOutFlights(0), processedEvents(0),
+      completionTime(0)
+{
+    // Use the process-wide clock unless we were given one
+    clock = simClock ? simClock : &SimClock::instance();
+
+    // ATC status queries read our snapshots instead of the live flights
+    atcController->setWorldSnapshots(&worldSnapshots);
+}
+
+/**
+ * Destructor makes sure no worker outlives the engine
+ */
+SimulationEngine::~SimulationEngine()
+{
+    stop();
+    atcController->setWorldSnapshots(nullptr);
+    if (controllerEvents) atcController->getSignal().setWakeHandler(nullptr);
+}
+
+void SimulationEngine::setLogger(const std::function<void(const std::string&)>& logFunction)
+{
+    logger = logFunction;
+}
+
+/**
+ * Start the fixed pool of worker threads
+ */
+bool SimulationEngine::start(int workerCount)
+{
+    if (running) return false;
+
+    if (workerCount <= 0)
+    {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (workerCount <= 0) workerCount = 2; // hardware_concurrency() may return 0
+    }
+
+    // Step pool is sized to the hardware, independent of the event workers
+    if (stepInterval > 0)
+    {
+        stepPool.start(stepWorkers);
+    }
+
+    running = true;
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&SimulationEngine::workerLoop, this);
+    }
+
+    return true;
+}
+
+void SimulationEngine::setStepInterval(SimTime intervalMs, int workerCount)
+{
+    stepInterval = intervalMs;
+    stepWorkers = workerCount;
+}
+
+/**
+ * Add a flight - it enters the ATC queues once its Enter event fires
+ */
+void SimulationEngine::addFlight(Aircraft* aircraft, SimTime delayMs)
+{
+    addFlight(aircraft, delayMs, aircraft->aircraftIndex % 2 == 0);
+}
+
+void SimulationEngine::addFlight(Aircraft* aircraft, SimTime delayMs, bool isArrival)
+{
+    FlightContext* flight;
+    {
+        std::lock_guard<std::mutex> lock(flightsMutex);
+        if (!freeFlights.empty())
+        {
+            flight = freeFlights.back();
+            freeFlights.pop_back();
+        }
+        else
+        {
+            flights.emplace_back();
+            flight = &flights.back();
+            flight->generation = 0;
+        }
+    }
+
+    {
+        // Events still queued for the previous user of this context are now stale
+        std::lock_guard<std::mutex> lock(flight->stateMutex);
+        flight->generation++;
+        flight->aircraft = aircraft;
+        flight->isArrival = isArrival;
+        flight->waitingForRunway = false;
+        flight->phaseIndex = 0;
+        flight->enterTime = -1;
+        flight->runwayTime = -1;
+        flight->inProgress = false;
+        flight->stepSlot = -1;
+    }
+
+    activeFlights++;
+    schedule(flight, EventType::Enter, delayMs);
+
+    // Make sure the per-aircraft steps are running
+    armStep(clock->now() + stepInterval);
+}
+
+void SimulationEngine::setFlightFinishedListener(const std::function<void(Aircraft*, bool)>& listener)
+{
+    finishedListener = listener;
+}
+
+/**
+ * From now on every batch of controller signals queues a Controller event
+ */
+void SimulationEngine::setControllerEvents(bool enabled)
+{
+    controllerEvents = enabled;
+    if (enabled)
+    {
+        atcController->getSignal().setWakeHandler([this]() { armController(); });
+    }
+    else
+    {
+        atcController->getSignal().setWakeHandler(nullptr);
+    }
+}
+
+void SimulationEngine::setCpuAffinity(int cpu)
+{
+    cpuAffinity = cpu;
+}
+
+/**
+ * Let the workers move the virtual clock up to a new horizon
+ */
+void SimulationEngine::setHorizon(SimTime horizonTime)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        horizon = horizonTime;
+    }
+    queueCondition.notify_all();
+}
+
+/**
+ * Wait for the workers to run out of work below the horizon. Nobody else may
+ * add events meanwhile, or they could land before the clock we set here.
+ */
+void SimulationEngine::waitForHorizon()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    horizonCondition.wait(lock, [this]() { return !running || reachedHorizon(); });
+    if (horizon != std::numeric_limits<SimTime>::max())
+    {
+        clock->advanceTo(horizon);
+    }
+}
+
+bool SimulationEngine::reachedHorizon() const
+{
+    return busyWorkers == 0 && (eventQueue.empty() || eventQueue.front().dueTime > horizon);
+}
+
+/**
+ * Add a repeating task - first run after delayMs, then every intervalMs
+ */
+void SimulationEngine::addPeriodicTask(SimTime intervalMs, const std::function<bool()>& callback, SimTime delayMs)
+{
+    PeriodicTask* task;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        PeriodicTask newTask;
+        newTask.callback = callback;
+        newTask.interval = intervalMs;
+        tasks.push_back(newTask);
+        task = &tasks.back();
+    }
+
+    activeTasks++;
+
+    Event event;
+    event.dueTime = clock->now() + delayMs;
+    event.type = EventType::Periodic;
+    event.flight = nullptr;
+    event.generation = 0;
+    event.task = task;
+    pushEvent(event);
+}
+
+/**
+ * Wait until every flight has either completed or timed out
+ * and every periodic task has finished
+ */
+void SimulationEngine::waitForCompletion()
+{
+    std::unique_lock<std::mutex> lock(completionMutex);
+    completionCondition.wait(lock, [this]() {
+        return activeFlights.load() == 0 && activeTasks.load() == 0;
+    });
+}
+
+/**
+ * Stop and join all worker threads
+ */
+void SimulationEngine::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        running = false;
+    }
+    queueCondition.notify_all();
+    horizonCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+
+    stepPool.stop();
+}
+
+int SimulationEngine::getWorkerCount() const
+{
+    return static_cast<int>(workers.size());
+}
+
+int SimulationEngine::getActiveFlightCount() const
+{
+    return activeFlights.load();
+}
+
+int SimulationEngine::getCompletedFlightCount() const
+{
+    return completedFlights.load();
+}
+
+int SimulationEngine::getTimedOutFlightCount() const
+{
+    return timedOutFlights.load();
+}
+
+size_t SimulationEngine::getPendingEventCount()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return eventQueue.size();
+}
+
+unsigned long long SimulationEngine::getProcessedEventCount() const
+{
+    return processedEvents.load();
+}
+
+std::vector<SimTime> SimulationEngine::getRunwayWaitTimes()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return runwayWaitTimes;
+}
+
+std::vector<SimTime> SimulationEngine::getFlightTimes()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return flightTimes;
+}
+
+SimTime SimulationEngine::getCompletionTime() const
+{
+    return completionTime.load();
+}
+
+SimClock* SimulationEngine::getClock() const
+{
+    return clock;
+}
+
+const TaskPool& SimulationEngine::getStepPool() const
+{
+    return stepPool;
+}
+
+const WorldSnapshotBuffer& SimulationEngine::getWorldSnapshots() const
+{
+    return worldSnapshots;
+}
+
+/**
+ * Schedule a flight event delayMs simulated milliseconds from now
+ */
+void SimulationEngine::schedule(FlightContext* flight, EventType type, SimTime delayMs)
+{
+    Event event;
+    event.dueTime = clock->now() + delayMs;
+    event.type = type;
+    event.flight = flight;
+    event.generation = flight->generation;
+    event.task = nullptr;
+    pushEvent(event);
+}
+
+/**
+ * Push an event onto the heap and wake one worker to look at it
+ */
+void SimulationEngine::pushEvent(Event& event)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        event.sequence = nextSequence++;
+        eventQueue.push_back(event);
+        std::push_heap(eventQueue.begin(), eventQueue.end(), EventLater());
+    }
+    queueCondition.notify_one();
+}
+
+/**
+ * Worker loop - sleep until the earliest event is due, pop it and run it.
+ * Events for the same flight are chained (each one schedules the next), so a
+ * flight is never processed by two workers at once.
+ *
+ * With a virtual clock nobody else moves time forward: when no worker is busy
+ * (so no new earlier event can appear) we jump the clock to the next event,
+ * as long as it is within the horizon.
+ *
+ * A virtual clock only ever has events due at 'now' to run, and those touch
+ * the same queues and runways, so they run one after another rather than in
+ * whatever order the workers get to them. Each event then schedules its
+ * followers in a fixed order too, the sequence numbers come out the same
+ * every time, and a seeded run gives the same result for any worker count.
+ * The per-aircraft steps still fan out on the step pool.
+ */
+void SimulationEngine::workerLoop()
+{
+    // Everything this thread runs reads our clock, and stays on our CPU if we have one
+    SimClock::bindThread(clock);
+#ifdef __linux__
+    if (cpuAffinity >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpuAffinity, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#endif
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+
+    while (running)
+    {
+        if (eventQueue.empty())
+        {
+            if (busyWorkers == 0) horizonCondition.notify_all();
+            queueCondition.wait(lock);
+            continue;
+        }
+
+        SimTime dueTime = eventQueue.front().dueTime;
+        if (dueTime > clock->now())
+        {
+            if (clock->isVirtual())
+            {
+                if (busyWorkers == 0 && dueTime <= horizon)
+                {
+                    clock->advanceTo(dueTime);
+                }
+                else
+                {
+                    // A busy worker may still schedule something earlier, or we are at the horizon
+                    if (busyWorkers == 0) horizonCondition.notify_all();
+                    queueCondition.wait(lock);
+                }
+            }
+            else
+            {
+                queueCondition.wait_for(lock, clock->realTimeUntil(dueTime));
+            }
+            continue;
+        }
+
+        // Same-time events run one at a time with a virtual clock, in sequence order
+        if (clock->isVirtual() && busyWorkers > 0)
+        {
+            queueCondition.wait(lock);
+            continue;
+        }
+
+        std::pop_heap(eventQueue.begin(), eventQueue.end(), EventLater());
+        Event event = eventQueue.back();
+        eventQueue.pop_back();
+        busyWorkers++;
+
+        // Process outside the lock so other workers can keep going
+        lock.unlock();
+        processEvent(event);
+        lock.lock();
+
+        busyWorkers--;
+        if (busyWorkers == 0 && clock->isVirtual())
+        {
+            // Idle workers may be waiting for us before they can advance time
+            queueCondition.notify_all();
+        }
+    }
+}
+
+void SimulationEngine::processEvent(const Event& event)
+{
+    processedEvents++;
+
+    // Leftover timeout/status event of a flight whose context has been reused
+    if (event.flight && event.generation != event.flight->generation.load())
+    {
+        return;
+    }
+
+    switch (event.type)
+    {
+        case EventType::Enter:
+            handleEnter(event.flight);
+            break;
+        case EventType::WaitStatus:
+            handleWaitStatus(event.flight);
+            break;
+        case EventType::RunwayTimeout:
+            handleRunwayTimeout(event.flight);
+            break;
+        case EventType::PhaseChange:
+            handlePhaseChange(event.flight);
+            break;
+        case EventType::Periodic:
+            handlePeriodic(event);
+            break;
+        case EventType::Step:
+            handleStep(event);
+            break;
+        case EventType::Controller:
+            handleController();
+            break;
+    }
+}
+
+/**
+ * Flight becomes active and joins the arrival or departure queue
+ */
+void SimulationEngine::handleEnter(FlightContext* flight)
+{
+    std::lock_guard<std::mutex> lock(flight->stateMutex);
+    Aircraft* plane = flight->aircraft;
+    plane->isActive = true;
+    flight->enterTime = clock->now();
+    flight->inProgress = true;
+    {
+        std::lock_guard<std::mutex> flightsLock(flightsMutex);
+        flight->stepSlot = static_cast<int>(steppingFlights.size());
+        steppingFlights.push_back(flight);
+    }
+
+    log("Flight " + plane->FlightNumber + " is now active");
+
+    // ATC calls this from AssignRunaway() - it may fire as soon as we join a queue,
+    // and blocks on stateMutex until we're done here
+    flight->waitingForRunway = true;
+    plane->hasRunwayAssigned = false;
+    plane->assignedRunway = -1;
+    plane->runwayLease = noRunwayLease;
+    unsigned int generation = flight->generation;
+    plane->onRunwayAssigned = [this, flight, generation](Aircraft*) {
+        handleRunwayAssigned(flight, generation);
+    };
+
+    // Even index = arrival (North/South), odd index = departure (East/West)
+    if (flight->isArrival)
+    {
+        plane->direction = (plane->aircraftIndex % 4 == 0) ? Direction::North : Direction::South;
+        plane->state = FlightState::Holding;
+        atcController->scheduleArrival(plane);
+
+        log("Flight " + plane->FlightNumber + " entering from " +
+            (plane->direction == Direction::North ? "North" : "South") +
+            " has entered the arrival queue");
+    }
+    else
+    {
+        plane->direction = (plane->aircraftIndex % 4 == 1) ? Direction::East : Direction::West;
+        plane->state = FlightState::AtGate;
+        atcController->scheduleDeparture(plane);
+
+        log("Flight " + plane->FlightNumber + " departing to " +
+            (plane->direction == Direction::East ? "East" : "West") +
+            " has entered the departure queue");
+    }
+
+    // One timeout event instead of checking every second
+    schedule(flight, EventType::RunwayTimeout, runwayTimeoutSeconds * 1000LL);
+
+    // Wait estimates are only worth the events if someone reads them
+    if (logger)
+    {
+        schedule(flight, EventType::WaitStatus, statusIntervalSeconds * 1000LL);
+    }
+}
+
+/**
+ * ATC assigned us a runway - start the next phase right away
+ */
+void SimulationEngine::handleRunwayAssigned(FlightContext* flight, unsigned int generation)
+{
+    std::lock_guard<std::mutex> lock(flight->stateMutex);
+
+    // Too late - the flight already timed out (and the context may be reused)
+    if (!flight->waitingForRunway || flight->generation != generation) return;
+
+    // Steps read the flag under this lock, so it is set here rather than on the ATC thread
+    flight->waitingForRunway = false;
+    flight->runwayTime = clock->now();
+    flight->aircraft->hasRunwayAssigned = true;
+    atcController->syncAircraft(flight->aircraft);
+    log("Flight " + flight->aircraft->FlightNumber + " has been assigned a runway!");
+    schedule(flight, EventType::PhaseChange, 0);
+}
+
+/**
+ * Every 5 seconds while waiting, print status update with estimated wait time
+ */
+void SimulationEngine::handleWaitStatus(FlightContext* flight)
+{
+    std::lock_guard<std::mutex> lock(flight->stateMutex);
+    if (!flight->waitingForRunway) return;
+
+    SimTime waited = clock->now() - flight->enterTime;
+    if (waited >= runwayTimeoutSeconds * 1000LL) return;
+
+    Aircraft* plane = flight->aircraft;
+    SimTime estimatedWait = atcController->getScheduler()->estimateWaitMs(plane);
+    log("Flight " + plane->FlightNumber +
+        (flight->isArrival ? " holding" : " at gate") +
+        ", estimated wait: " + std::to_string(estimatedWait / 1000) + " seconds");
+
+    schedule(flight, EventType::WaitStatus, statusIntervalSeconds * 1000LL);
+}
+
+/**
+ * Give up on the runway 30 seconds after joining the queue
+ * (a no-op if ATC got to us first)
+ */
+void SimulationEngine::handleRunwayTimeout(FlightContext* flight)
+{
+    std::unique_lock<std::mutex> lock(flight->stateMutex);
+    if (!flight->waitingForRunway) return;
+
+    flight->waitingForRunway = false;
+    log("Flight " + flight->aircraft->FlightNumber + " timed out waiting for runway!");
+    finishFlight(flight, true, lock);
+}
+
+/**
+ * Move the flight to its next phase and schedule the one after it
+ */
+void SimulationEngine::handlePhaseChange(FlightContext* flight)
+{
+    std::unique_lock<std::mutex> lock(flight->stateMutex);
+    Aircraft* plane = flight->aircraft;
+    const PhaseStep* phases = flight->isArrival ? arrivalPhases : departurePhases;
+    const PhaseStep& step = phases[flight->phaseIndex];
+
+    plane->state = step.state;
+    plane->UpdateSpeed();
+    atcController->syncAircraft(plane);
+
+    switch (step.state)
+    {
+        case FlightState::Taxi:
+            log("Flight " + plane->FlightNumber + " is now taxiing at " +
+                std::to_string(plane->speed) + " km/h");
+            break;
+        case FlightState::TakeoffRoll:
+            log("Flight " + plane->FlightNumber + " is taking off at " +
+                std::to_string(plane->speed) + " km/h");
+            break;
+        case FlightState::Climb:
+            log("Flight " + plane->FlightNumber + " is climbing at " +
+                std::to_string(plane->speed) + " km/h");
+            break;
+        case FlightState::AtGate:
+            log("Flight " + plane->FlightNumber + " has arrived at gate");
+            break;
+        case FlightState::Cruise:
+            log("Flight " + plane->FlightNumber + " has reached cruising altitude at " +
+                std::to_string(plane->speed) + " km/h");
+            break;
+        default:
+            break;
+    }
+
+    flight->phaseIndex++;
+    if (flight->phaseIndex >= phaseCount)
+    {
+        finishFlight(flight, false, lock);
+        return;
+    }
+
+    schedule(flight, EventType::PhaseChange, step.durationSeconds * 1000LL);
+}
+
+/**
+ * Run a periodic task and schedule its next run on a fixed grid
+ */
+void SimulationEngine::handlePeriodic(const Event& event)
+{
+    PeriodicTask* task = event.task;
+
+    if (!task->callback())
+    {
+        // Task is done - maybe it was the last thing keeping us busy
+        activeTasks--;
+        notifyIfIdle();
+        return;
+    }
+
+    // Anchor to the previous due time so the period doesn't drift
+    Event next = event;
+    next.dueTime = event.dueTime + task->interval;
+    pushEvent(next);
+}
+
+/**
+ * Run one step for every flight in progress as tasks on the step pool.
+ * Events keep going on the other workers; the per-flight lock keeps a
+ * step and a phase change from touching the same aircraft at once.
+ * Each task copies its aircraft into the next snapshot while it still
+ * holds that lock, so the snapshot never reads a row another thread is
+ * writing and never has to hold the events off.
+ */
+void SimulationEngine::handleStep(const Event& event)
+{
+    std::vector<FlightContext*> batch;
+    {
+        std::lock_guard<std::mutex> lock(flightsMutex);
+        batch = steppingFlights;
+    }
+
+    // No free slot (readers still hold every spare one) - step anyway and publish next tick
+    WorldSnapshot* snapshot = worldSnapshots.beginWrite();
+    if (snapshot) snapshot->aircraft.resize(batch.size());
+
+    stepPool.parallelFor(batch.size(), stepGrainSize, [this, &batch, snapshot](size_t i) {
+        SimClock::bindThread(clock);    // Step pool threads belong to no engine of their own
+        stepFlight(batch[i], snapshot ? &snapshot->aircraft[i] : nullptr);
+    });
+
+    // Every aircraft has moved - let the readers see this tick
+    if (snapshot) publishSnapshot(snapshot, event.dueTime);
+
+    // Keep stepping while there is anything left to fly
+    stepArmed = false;
+    if (activeFlights.load() > 0)
+    {
+        armStep(event.dueTime + stepInterval);
+    }
+}
+
+void SimulationEngine::armStep(SimTime dueTime)
+{
+    if (stepInterval <= 0 || stepArmed.exchange(true)) return;
+
+    Event event;
+    event.dueTime = dueTime;
+    event.type = EventType::Step;
+    event.flight = nullptr;
+    event.generation = 0;
+    event.task = nullptr;
+    pushEvent(event);
+}
+
+/**
+ * Signals from flights arrive in the middle of other events - the round runs
+ * as its own event at the same simulated time, so a runway freed by a
+ * finishing flight is handed out before the clock moves on.
+ */
+void SimulationEngine::armController()
+{
+    if (controllerArmed.exchange(true)) return;
+
+    Event event;
+    event.dueTime = clock->now();
+    event.type = EventType::Controller;
+    event.flight = nullptr;
+    event.generation = 0;
+    event.task = nullptr;
+    pushEvent(event);
+}
+
+// Disarm first, so a signal raised during the round queues the next one
+void SimulationEngine::handleController()
+{
+    controllerArmed = false;
+    atcController->handleSignals();
+}
+
+/**
+ * Finish a snapshot the step tasks filled with their aircraft (count them,
+ * copy the runways) and publish it. Only the Step handler calls this, so
+ * there is a single writer.
+ */
+void SimulationEngine::publishSnapshot(WorldSnapshot* snapshot, SimTime now)
+{
+    snapshot->finish(runwayManager, now);
+    worldSnapshots.publish(snapshot);
+}
+
+/**
+ * Continuous part of the flight: speed for the current phase, the
+ * speed-limit check and the position. Phase changes stay event driven.
+ */
+void SimulationEngine::stepFlight(FlightContext* flight, AircraftView* view)
+{
+    std::lock_guard<std::mutex> lock(flight->stateMutex);
+    if (!flight->inProgress)
+    {
+        if (view) view->ref.handle = invalidAircraftHandle;    // Finished meanwhile - left out
+        return;
+    }
+
+    Aircraft* plane = flight->aircraft;
+    plane->UpdateSpeed();
+    plane->checkForViolation();
+    plane->updatePosition();
+    atcController->syncAircraft(plane);
+    if (view) view->copyFrom(*plane, atcController->getScheduler()->getAircraftTable().refOf(plane));
+}
+
+/**
+ * Release the runway (if we had one) and mark the flight as done.
+ * Called with the flight's stateMutex held; it is released before the flight
+ * is taken out of ATC, because ATC may be inside AssignRunaway() for this
+ * aircraft and waiting for that same lock.
+ */
+void SimulationEngine::finishFlight(FlightContext* flight, bool timedOut, std::unique_lock<std::mutex>& lock)
+{
+    Aircraft* plane = flight->aircraft;
+    flight->inProgress = false;
+    {
+        // Swap-remove from the stepping list
+        std::lock_guard<std::mutex> flightsLock(flightsMutex);
+        FlightContext* last = steppingFlights.back();
+        steppingFlights[flight->stepSlot] = last;
+        last->stepSlot = flight->stepSlot;
+        steppingFlights.pop_back();
+        flight->stepSlot = -1;
+    }
+
+    if (!timedOut)
+    {
+        // Give back our runway lease now that we're at the gate / airborne, and teach
+        // the wait estimates how long we held it (unless the lease ran out first)
+        int runwayIndex = plane->assignedRunway;
+        if (releaseRunway(plane))
+        {
+            atcController->getScheduler()->getServiceModel().record(
+                runwayIndex, plane->type, flight->isArrival, clock->now() - flight->runwayTime);
+        }
+        completedFlights++;
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        runwayWaitTimes.push_back(flight->runwayTime - flight->enterTime);
+        flightTimes.push_back(clock->now() - flight->enterTime);
+    }
+    else
+    {
+        timedOutFlights++;
+    }
+
+    plane->isActive = false;
+    log("Flight " + plane->FlightNumber + " has completed its journey");
+    lock.unlock();
+
+    // A timed-out flight is still queued - take it out so ATC can't assign it later.
+    // Once this returns ATC holds no reference to the aircraft.
+    atcController->removeFlight(plane);
+
+    // The ATC round that raced our timeout may have leased us a runway - hand it straight back
+    if (timedOut)
+    {
+        releaseRunway(plane);
+    }
+
+    if (finishedListener)
+    {
+        finishedListener(plane, timedOut);
+    }
+
+    {
+        // Context can be handed to the next flight
+        std::lock_guard<std::mutex> flightsLock(flightsMutex);
+        freeFlights.push_back(flight);
+    }
+
+    activeFlights--;
+    notifyIfIdle();
+}
+
+/**
+ * Release by lease: only the runway this aircraft was leased, and only if
+ * the lease is still the runway's current one. A lease that expired and
+ * went to another flight is left alone.
+ */
+bool SimulationEngine::releaseRunway(Aircraft* plane)
+{
+    RunwayClass* runway = runwayManager->getRunwayByIndex(plane->assignedRunway);
+    bool released = runway && runway->release(plane->runwayLease);
+    if (released)
+    {
+        atcController->notifyRunwayFreed();
+    }
+    else if (runway)
+    {
+        log("Flight " + plane->FlightNumber + " lost its lease on " + runway->id);
+    }
+
+    plane->assignedRunway = -1;
+    plane->runwayLease = noRunwayLease;
+    return released;
+}
+
+/**
+ * Last one out wakes up anyone waiting for completion
+ */
+void SimulationEngine::notifyIfIdle()
+{
+    if (activeFlights.load() == 0 && activeTasks.load() == 0)
+    {
+        // Leftover events (the next step, say) may still move the clock while the waiter wakes up
+        completionTime = clock->now();
+        std::lock_guard<std::mutex> lock(completionMutex);
+        completionCondition.notify_all();
+    }
+}
+
+void SimulationEngine::log(const std::string& message)
+{
+    if (logger) logger(message);
+}
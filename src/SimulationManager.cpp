@@ -1,25 +1,8 @@
 #include "../include/SimulationManager.h"
-#include <cstdlib>
+#include "../include/CounterRandom.h"
 #include <ctime>
 #include <sstream>
-
-// Struct that holds thread arguments for flight simulation
-struct SimulationManager::ThreadArgs 
-{
-    Aircraft* aircraft;
-    SimulationManager* manager;
-    ATCScontroller* atc;
-    RunwayManager* runways;
-};
-
-// Struct that holds thread arguments for ATC controller
-struct SimulationManager::ATCArgs 
-{
-    SimulationManager* manager;
-    ATCScontroller* atc;
-    RunwayManager* runways;
-    int duration;
-};
+#include <memory>
 
 /**
  * Constructor initializes threading resources and stores references to shared components
@@ -30,6 +13,10 @@ SimulationManager::SimulationManager(ATCScontroller* atc, RunwayManager* rwm)
     // Initialize the mutex for thread-safe console output
     pthread_mutex_init(&consoleMutex, nullptr);
     pthread_mutex_init(&visualDataMutex, nullptr);
+    
+    // Discrete-event engine that runs every flight's lifecycle
+    engine = new SimulationEngine(atc, rwm);
+    engine->setLogger([this](const std::string& message) { logMessage(message); });
 }
 
 /**
@@ -37,318 +24,74 @@ SimulationManager::SimulationManager(ATCScontroller* atc, RunwayManager* rwm)
  */
 SimulationManager::~SimulationManager() 
 {
+    // Stop the engine workers before the mutexes go away
+    delete engine;
+    
     // Destroy the mutex when done
     pthread_mutex_destroy(&consoleMutex);
     pthread_mutex_destroy(&visualDataMutex);
 }
 
 /**
- * Thread function that simulates a plane flight
- * This is where all the flight logic happens - previously in Flight() function in main.cpp
+ * Hand all aircraft of an airline to the simulation engine
  */
-void* SimulationManager::flightThreadFunction(void* arg) 
+bool SimulationManager::launchAirlineFlights(Airline* airline) 
 {
-    // Cast the argument back to ThreadArgs
-    ThreadArgs* args = static_cast<ThreadArgs*>(arg);
-    Aircraft* plane = args->aircraft;
-    SimulationManager* manager = args->manager;
-    ATCScontroller* atcController = args->atc;
-    RunwayManager* runwayManager = args->runways;
-    
-    // Mark the plane as active
-    plane->isActive = true;
-    
-    // Log that the flight is active
-    manager->logMessage("Flight " + plane->FlightNumber + " is now active");
-
-    // Set flight direction based on type (for simulation purposes)
-    // North/South for arrivals, East/West for departures
-    // We'll use a simple rule: even index = arrival, odd index = departure
-    if (plane->aircraftIndex % 2 == 0) 
-    {
-        // Arrival flow - either North or South
-        plane->direction = (plane->aircraftIndex % 4 == 0) ? Direction::North : Direction::South;
-
-        //NOTE : WE CAN DO THE POSITION WALA PART OR NOT, TO BE DECIDEDDDDDDDD ????
-        /* Commenting this for now, same for the departures
-        // Randomly generate x and y positions based on direction
-        Was also thinking of adding z(height) and making directions to 360
-        //Getting a bit complicated, but we can add this later
-        //Have to align it with the sprites too
-        // Have to do some math with the speed as well as distance
-        //Monday ko together we do this after classes
-        //Update Position Function has to be added somewhere
-        if(plane->direction == Direction::North) 
-        {
-            plane->x_position = rand() % 1000000; // Random x position for North
-            plane->y_position = 0; // Fixed y position for North
-        }
-        else if(plane->direction == Direction::South) 
-        {
-            plane->x_position = rand() % 100; // Random x position for South
-            plane->y_position = 100; // Fixed y position for South
-        }
-        */
-        
-        // For arrivals, start at Holding state
-        plane->state = FlightState::Holding;
-        
-        // Add to arrival queue
-        atcController->scheduleArrival(plane);
-        
-        manager->logMessage("Flight " + plane->FlightNumber + 
-                           " entering from " + 
-                           (plane->direction == Direction::North ? "North" : "South") + 
-                           " has entered the arrival queue");
-        
-        // Simulate the arrival sequence
-        int waitTime = 0;
-        while (!plane->hasRunwayAssigned && waitTime < 30) 
-        {
-            sleep(1);  // Check every second if runway assigned
-            waitTime++;
-            
-            // Every 5 seconds, print status update with estimated wait time
-            if (waitTime % 5 == 0) 
-            {
-                int estimatedWait = atcController->getScheduler()->estimateWaitTime(plane);
-                manager->logMessage("Flight " + plane->FlightNumber + 
-                                   " holding, estimated wait: " + 
-                                   std::to_string(estimatedWait) + " minutes");
-            }
-        }
-        
-        // If runway assigned, proceed with landing sequence
-        if (plane->hasRunwayAssigned) 
-        {
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " has been assigned a runway!");
-            
-            // Approach phase
-            plane->state = FlightState::Approach;
-            plane->UpdateSpeed();
-            sleep(3);
-            
-            // Landing phase
-            plane->state = FlightState::Landing;
-            plane->UpdateSpeed();
-            sleep(2);
-            
-            // Taxi phase
-            plane->state = FlightState::Taxi;
-            plane->UpdateSpeed();
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " is now taxiing at " + std::to_string(plane->speed) + " km/h");
-            sleep(2);
-            
-            // At gate
-            plane->state = FlightState::AtGate;
-            plane->UpdateSpeed();
-            
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " has arrived at gate");
-            
-            // Release the runway now that we're at the gate
-            for (int i = 0; i < runwayManager->getRunwayCount(); i++) 
-            {
-                RunwayClass* runway = runwayManager->getRunwayByIndex(i);
-                if (runway && runway->isOccupied) 
-                {
-                    runway->release();
-                    break;
-                }
-            }
-        } 
-        else 
-        {
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " timed out waiting for runway!");
-        }
-    } 
-    else 
+    // Each aircraft becomes a chain of events instead of a thread
+    for (size_t i = 0; i < airline->aircrafts.size(); ++i) 
     {
-        // Departure flow - either East or West
-        plane->direction = (plane->aircraftIndex % 4 == 1) ? Direction::East : Direction::West;
-        
-        // For departures, start at the gate
-        plane->state = FlightState::AtGate;
-        
-        // Add to departure queue
-        atcController->scheduleDeparture(plane);
-        
-        manager->logMessage("Flight " + plane->FlightNumber + 
-                           " departing to " + 
-                           (plane->direction == Direction::East ? "East" : "West") + 
-                           " has entered the departure queue");
-        
-        // Simulate the departure sequence
-        int waitTime = 0;
-        while (!plane->hasRunwayAssigned && waitTime < 30) 
-        {
-            sleep(1);  // Check every second if runway assigned
-            waitTime++;
-            
-            // Every 5 seconds, print status update with estimated wait time
-            if (waitTime % 5 == 0) 
-            {
-                int estimatedWait = atcController->getScheduler()->estimateWaitTime(plane);
-                manager->logMessage("Flight " + plane->FlightNumber + 
-                                   " at gate, estimated wait: " + 
-                                   std::to_string(estimatedWait) + " minutes");
-            }
-        }
-        
-        // If runway assigned, proceed with takeoff sequence
-        if (plane->hasRunwayAssigned) 
-        {
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " has been assigned a runway!");
-            
-            // Taxi phase
-            plane->state = FlightState::Taxi;
-            plane->UpdateSpeed();
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " is now taxiing at " + std::to_string(plane->speed) + " km/h");
-            sleep(2);
-            
-            // Takeoff phase
-            plane->state = FlightState::TakeoffRoll;
-            plane->UpdateSpeed();
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " is taking off at " + std::to_string(plane->speed) + " km/h");
-            sleep(2);
-            
-            // Climb phase
-            plane->state = FlightState::Climb;
-            plane->UpdateSpeed();
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " is climbing at " + std::to_string(plane->speed) + " km/h");
-            sleep(2);
-            
-            // Cruise phase
-            plane->state = FlightState::Cruise;
-            plane->UpdateSpeed();
-            
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " has reached cruising altitude at " + std::to_string(plane->speed) + " km/h");
-            
-            // Release the runway now that we're airborne
-            for (int i = 0; i < runwayManager->getRunwayCount(); i++) 
-            {
-                RunwayClass* runway = runwayManager->getRunwayByIndex(i);
-                if (runway && runway->isOccupied) 
-                {
-                    runway->release();
-                    break;
-                }
-            }
-        } 
-        else 
-        {
-            manager->logMessage("Flight " + plane->FlightNumber + 
-                               " timed out waiting for runway!");
-        }
+        engine->addFlight(&airline->aircrafts[i]);
     }
-    
-    // Flight is now complete or timed out
-    plane->isActive = false;
-    
-    manager->logMessage("Flight " + plane->FlightNumber + 
-                       " has completed its journey");
-    
-    // Clean up the args we allocated
-    delete args;
-    
-    // Exit thread
-    pthread_exit(nullptr);
+
+    return true;
 }
 
 /**
- * Thread function that monitors air traffic control
- * This was previously a lambda in main.cpp
+ * Start the engine workers once the initial flights and the ATC loop are queued
+ * (with an as-fast-as-possible clock the workers would otherwise race ahead in time)
  */
-void* SimulationManager::atcControllerThreadFunction(void* arg) 
+bool SimulationManager::startSimulation() 
 {
-    // Extract the arguments
-    ATCArgs* args = static_cast<ATCArgs*>(arg);
-    SimulationManager* manager = args->manager;
-    ATCScontroller* atcController = args->atc;
-    RunwayManager* runwayManager = args->runways;
-    int duration = args->duration;
-    
-    manager->logMessage("ATC controller active - monitoring flights");
-    
-    // Run the controller for the specified duration
-    for (int i = 0; i < duration; i++) 
+    if (engine->getWorkerCount() > 0) 
     {
-        atcController->monitorFlight();
-        sleep(1);  // Check every second
-        
-        // Every 20 seconds, print runway status
-        if (i % 20 == 0) 
-        {
-            manager->logMessage("\n" + runwayManager->getStatusReport() + "\n");
-        }
+        return true;
     }
     
-    // Clean up the args we allocated
-    delete args;
-    
-    return nullptr;
-}
-
-/**
- * Launch threads for all aircraft in an airline
- */
-bool SimulationManager::launchAirlineThreads(Airline* airline) 
-{
-    // Create a thread for each aircraft in the airline
-    for (size_t i = 0; i < airline->aircrafts.size(); ++i) 
+    if (!engine->start()) 
     {
-        // Create arguments struct to pass to thread
-        ThreadArgs* args = new ThreadArgs;
-        args->aircraft = &airline->aircrafts[i];
-        args->manager = this;
-        args->atc = atcController;
-        args->runways = runwayManager;
-        
-        // Create thread ID
-        pthread_t threadId;
-        aircraftThreads.push_back(threadId);
-        
-        // Launch thread
-        int result = pthread_create(&aircraftThreads.back(), NULL, 
-                                   flightThreadFunction, 
-                                   static_cast<void*>(args));
-        
-        if (result != 0) {
-            std::cerr << "Error creating thread for Aircraft " << 
-                     airline->aircrafts[i].FlightNumber << std::endl;
-            return false;
-        }
+        std::cerr << "Error starting simulation engine workers" << std::endl;
+        return false;
     }
-
+    
     return true;
 }
 
 /**
- * Launch ATC controller thread
+ * Launch the ATC controller
+ * Assignment rounds run as engine events whenever a flight queues, a runway
+ * is freed or an emergency is declared; a periodic task once per simulated
+ * second prints the runway status and keeps the run going for its duration
  */
-bool SimulationManager::launchATCControllerThread() 
+bool SimulationManager::launchATCController() 
 {
-    // Create arguments
-    ATCArgs* args = new ATCArgs;
-    args->manager = this;
-    args->atc = atcController;
-    args->runways = runwayManager;
-    args->duration = 300; // 5 minutes = 300 seconds
-    
-    // Launch thread
-    int result = pthread_create(&atcControllerThread, NULL, 
-                               atcControllerThreadFunction, 
-                               static_cast<void*>(args));
-                               
-    return (result == 0);
+    logMessage("ATC controller active - monitoring flights");
+    
+    const int duration = 300; // 5 minutes = 300 simulated seconds
+    std::shared_ptr<int> tick = std::make_shared<int>(0);
+    
+    engine->setControllerEvents(true);
+    engine->addPeriodicTask(1000, [this, tick, duration]() {
+        // Every 20 seconds, print runway status
+        if (*tick % 20 == 0) 
+        {
+            logMessage("\n" + runwayManager->getStatusReport() + "\n");
+        }
+        
+        // Keep going until we've run for the full duration
+        return ++(*tick) < duration;
+    });
+    
+    return true;
 }
 
 /**
@@ -356,19 +99,23 @@ bool SimulationManager::launchATCControllerThread()
  */
 void SimulationManager::createRandomEmergency(const std::vector<Airline*>& airlines) 
 {
+    // Own random stream, positioned by the simulated time of the call
+    const unsigned long long key = CounterRandom::keyFor("SimulationManager::createRandomEmergency", 0);
+    const unsigned long long counter = static_cast<unsigned long long>(SimClock::instance().now()) << 2;
+    
     // 1 in 3 chance of emergency
-    if (rand() % 3 == 0) {
+    if (CounterRandom::range(key, counter, 0, 2) == 0) {
         // Pick a random airline
         if (!airlines.empty()) {
-            int randomAirlineIndex = rand() % airlines.size();
+            int randomAirlineIndex = CounterRandom::range(key, counter + 1, 0, static_cast<int>(airlines.size()) - 1);
             Airline* randomAirline = airlines[randomAirlineIndex];
             
             if (!randomAirline->aircrafts.empty()) {
                 // Pick a random aircraft
-                int randomAircraftIndex = rand() % randomAirline->aircrafts.size();
+                int randomAircraftIndex = CounterRandom::range(key, counter + 2, 0, static_cast<int>(randomAirline->aircrafts.size()) - 1);
                 
                 // Set emergency level (1-3)
-                randomAirline->aircrafts[randomAircraftIndex].EmergencyNo = 1 + rand() % 3;
+                randomAirline->aircrafts[randomAircraftIndex].EmergencyNo = CounterRandom::range(key, counter + 3, 1, 3);
                 
                 logMessage("EMERGENCY ALERT: " + 
                           randomAirline->aircrafts[randomAircraftIndex].FlightNumber + 
@@ -384,13 +131,8 @@ void SimulationManager::createRandomEmergency(const std::vector<Airline*>& airli
  */
 void SimulationManager::waitForCompletion() 
 {
-    // Wait for all aircraft threads to finish
-    for (auto& threadId : aircraftThreads) {
-        pthread_join(threadId, nullptr);
-    }
-    
-    // Join the ATC controller thread
-    pthread_join(atcControllerThread, nullptr);
+    // Wait for every flight and the ATC loop in the engine to finish
+    engine->waitForCompletion();
     
     // Stop visualization thread
     stopVisualization();
@@ -537,6 +279,9 @@ void SimulationManager::updateVisualizationData()
     // Ensure runway manager is set
     visualizer->setRunwayManager(runwayManager);
     
+    // Aircraft are drawn from the engine's snapshots when it has published one
+    visualizer->setWorldSnapshots(&engine->getWorldSnapshots());
+    
     pthread_mutex_unlock(&visualDataMutex);
 }
 
@@ -574,7 +319,11 @@ std::string SimulationManager::getSimulationStatistics() const
     
     // Add general simulation status
     stats << "===== Simulation Statistics =====" << std::endl;
-    stats << "Aircraft threads: " << aircraftThreads.size() << std::endl;
+    stats << "Engine workers: " << engine->getWorkerCount() << std::endl;
+    stats << "Active flights: " << engine->getActiveFlightCount() 
+          << " | Completed: " << engine->getCompletedFlightCount() 
+          << " | Timed out: " << engine->getTimedOutFlightCount() << std::endl;
+    stats << engine->getStepPool().getStatsReport();
     
     // Add runway statistics if available
     if (runwayManager)
@@ -0,0 +1,266 @@
+#include "../include/TaskPool.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+thread_local TaskPool* TaskPool::currentPool = nullptr;
+thread_local int TaskPool::currentWorker = -1;
+
+TaskPool::TaskPool()
+    : running(false), nextWorker(0), wakeCount(0)
+{
+}
+
+/**
+ * Destructor makes sure no worker outlives the pool
+ */
+TaskPool::~TaskPool()
+{
+    stop();
+}
+
+/**
+ * Start one worker (with its own deque) per hardware thread unless told otherwise
+ */
+bool TaskPool::start(int workerCount)
+{
+    if (running) return false;
+
+    if (workerCount <= 0)
+    {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (workerCount <= 0) workerCount = 2; // hardware_concurrency() may return 0
+    }
+
+    // Create all deques before any thread can try to steal from them
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(new Worker());
+    }
+
+    running = true;
+    startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers[i]->thread = std::thread(&TaskPool::workerLoop, this, i);
+    }
+
+    return true;
+}
+
+/**
+ * Let the workers drain what is queued, then join them
+ */
+void TaskPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    workers.clear();
+}
+
+/**
+ * Queue a task. Workers push onto their own deque so related work stays
+ * on the same core; everybody else spreads tasks round-robin.
+ */
+void TaskPool::submit(const Task& task)
+{
+    if (workers.empty())
+    {
+        // Pool not started - just run it here
+        task();
+        return;
+    }
+
+    int target;
+    if (currentPool == this && currentWorker >= 0)
+    {
+        target = currentWorker;
+    }
+    else
+    {
+        target = static_cast<int>(nextWorker++ % workers.size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->tasks.push_back(task);
+    }
+
+    // Bumped under the lock, so a worker about to sleep either sees it or gets the notify
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCount++;
+    }
+    wakeCondition.notify_one();
+}
+
+/**
+ * Split [0, count) into chunks, run them on the pool and wait for all of them
+ */
+void TaskPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t)>& body)
+{
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    // Shared completion counter for this batch
+    struct Batch
+    {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->remaining = (count + grainSize - 1) / grainSize;
+
+    for (size_t begin = 0; begin < count; begin += grainSize)
+    {
+        size_t end = std::min(count, begin + grainSize);
+        submit([batch, begin, end, &body]() {
+            for (size_t i = begin; i < end; i++)
+            {
+                body(i);
+            }
+
+            if (--batch->remaining == 0)
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->done.notify_all();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&batch]() { return batch->remaining.load() == 0; });
+}
+
+int TaskPool::getWorkerCount() const
+{
+    return static_cast<int>(workers.size());
+}
+
+/**
+ * Snapshot of every worker's counters
+ */
+std::vector<TaskPool::WorkerStats> TaskPool::getWorkerStats() const
+{
+    std::vector<WorkerStats> stats;
+
+    long long elapsedMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    for (const auto& worker : workers)
+    {
+        WorkerStats entry;
+        entry.executed = worker->executed.load();
+        entry.stolen = worker->stolen.load();
+        entry.utilization = elapsedMicros > 0
+            ? static_cast<double>(worker->busyMicros.load()) / elapsedMicros : 0.0;
+        stats.push_back(entry);
+    }
+
+    return stats;
+}
+
+/**
+ * One line per worker: tasks run, steals and utilization
+ */
+std::string TaskPool::getStatsReport() const
+{
+    std::stringstream report;
+    std::vector<WorkerStats> stats = getWorkerStats();
+
+    report << "Task pool: " << stats.size() << " workers" << std::endl;
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        report << "  Worker " << i << ": " << stats[i].executed << " tasks, "
+               << stats[i].stolen << " stolen, "
+               << std::fixed << std::setprecision(1) << stats[i].utilization * 100.0
+               << "% busy" << std::endl;
+    }
+
+    return report.str();
+}
+
+/**
+ * Newest task from our own deque
+ */
+bool TaskPool::popLocal(int index, Task& task)
+{
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+/**
+ * Oldest task from the first non-empty victim, starting next to us
+ */
+bool TaskPool::steal(int thief, Task& task)
+{
+    int count = static_cast<int>(workers.size());
+    for (int offset = 1; offset < count; offset++)
+    {
+        Worker& victim = *workers[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Worker loop - own deque first, then steal, then sleep until something is
+ * submitted. A failed steal always sleeps: a task taken by another worker
+ * is gone, and only a new submission can give us work.
+ */
+void TaskPool::workerLoop(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    Worker& self = *workers[index];
+
+    while (true)
+    {
+        Task task;
+        bool stolen = false;
+
+        // Read before looking: a task submitted later changes it, one submitted earlier is found
+        unsigned long long seen = wakeCount.load();
+        if (!popLocal(index, task))
+        {
+            stolen = steal(index, task);
+            if (!stolen)
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                if (!running) break;    // Every deque is drained
+                wakeCondition.wait(lock, [this, seen]() { return wakeCount.load() != seen || !running; });
+                continue;
+            }
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        task();
+        auto end = std::chrono::steady_clock::now();
+
+        self.busyMicros += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+        self.executed++;
+        if (stolen) self.stolen++;
+    }
+
+    currentPool = nullptr;
+    currentWorker = -1;
+}
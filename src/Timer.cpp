@@ -3,15 +3,22 @@
 // Constructor initializes timer values
 Timer::Timer() 
 {
+    clock = nullptr;
     startTime = 0;
     durationSeconds = 0;
     running = false;
 }
 
+// Use a specific clock instead of the process-wide one
+void Timer::setClock(SimClock* simClock) 
+{
+    clock = simClock;
+}
+
 // Start the timer by recording current time and setting running flag
 void Timer::start() 
 {
-    startTime = time(NULL);
+    startTime = (clock ? *clock : SimClock::instance()).now();
     running = true;
 }
 
@@ -32,7 +39,8 @@ bool Timer::isTimeUp() const
 int Timer::getElapsedSeconds() const 
 {
     if (!running) return 0;
-    return static_cast<int>(time(NULL) - startTime);
+    SimTime now = (clock ? *clock : SimClock::instance()).now();
+    return static_cast<int>((now - startTime) / 1000);
 }
 
 // Set the duration of the timer in seconds
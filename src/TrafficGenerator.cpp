@@ -0,0 +1,301 @@
+#include "../include/TrafficGenerator.h"
+#include "../include/CounterRandom.h"
+#include <cmath>
+#include <limits>
+
+// Busy mornings and evenings, quiet nights - normalized to a mean of 1 in defaultConfig()
+static const double dailyProfile[24] = {
+    0.2, 0.1, 0.1, 0.1, 0.2, 0.5,   // 00:00 - 05:59
+    1.0, 1.5, 1.8, 1.6, 1.3, 1.2,   // 06:00 - 11:59
+    1.2, 1.2, 1.3, 1.4, 1.6, 1.8,   // 12:00 - 17:59
+    1.7, 1.4, 1.1, 0.8, 0.5, 0.3    // 18:00 - 23:59
+};
+
+// The six standard airlines and their share of the traffic (same split as the standard fleets)
+struct StandardAirline
+{
+    const char* name;
+    AirCraftType type;
+    int fleetShare;
+};
+
+static const StandardAirline standardAirlines[] = {
+    {"PIA", AirCraftType::Commercial, 6},
+    {"AirBlue", AirCraftType::Commercial, 4},
+    {"FedEx", AirCraftType::Cargo, 3},
+    {"Pakistan Airforce", AirCraftType::Military, 2},
+    {"Blue Dart", AirCraftType::Cargo, 2},
+    {"AghaKhan Air", AirCraftType::Medical, 3}
+};
+
+static const SimTime hourMs = 3600LL * 1000LL;
+static const SimTime generationWindowMs = 1000;   // Generate one simulated second at a time
+
+/**
+ * Constructor just remembers the engine - nothing is generated until start()
+ */
+TrafficGenerator::TrafficGenerator(SimulationEngine* simulationEngine)
+    : engine(simulationEngine), generatedUntil(0), generatedCount(0), emergencyCount(0)
+{
+    config = defaultConfig(1000.0, 24 * hourMs, 1);
+}
+
+/**
+ * Standard airlines flying flightsPerDay in total with a daily profile
+ */
+TrafficConfig TrafficGenerator::defaultConfig(double flightsPerDay, SimTime duration, unsigned int seed)
+{
+    TrafficConfig result;
+
+    int totalShare = 0;
+    for (const StandardAirline& airline : standardAirlines)
+    {
+        totalShare += airline.fleetShare;
+    }
+
+    for (const StandardAirline& airline : standardAirlines)
+    {
+        AirlineTraffic traffic;
+        traffic.name = airline.name;
+
+        // Half of every airline's flights arrive, half depart
+        double perHour = flightsPerDay / 24.0 * airline.fleetShare / totalShare;
+        traffic.arrivalsPerHour = perHour / 2.0;
+        traffic.departuresPerHour = perHour / 2.0;
+
+        // Airlines fly their own aircraft type
+        for (int t = 0; t < aircraftTypeCount; t++)
+        {
+            traffic.typeMix[t] = 0.0;
+        }
+        traffic.typeMix[static_cast<int>(airline.type)] = 1.0;
+
+        result.airlines.push_back(traffic);
+    }
+
+    // Normalize the daily profile so the mean rate over the day is what was asked for
+    double profileSum = 0.0;
+    for (int h = 0; h < 24; h++)
+    {
+        profileSum += dailyProfile[h];
+    }
+    for (int h = 0; h < 24; h++)
+    {
+        result.hourlyProfile[h] = dailyProfile[h] * 24.0 / profileSum;
+    }
+
+    result.useDailyProfile = true;
+    result.emergencyRate = 0.01;
+    result.duration = duration;
+    result.seed = seed;
+    return result;
+}
+
+void TrafficGenerator::configure(const TrafficConfig& trafficConfig)
+{
+    config = trafficConfig;
+}
+
+/**
+ * Set up the streams, generate the first second and register the periodic
+ * task that keeps generating. Aircraft come back to the pool when the engine
+ * reports them finished.
+ */
+void TrafficGenerator::start()
+{
+    // Highest hourly multiplier - the envelope for thinning
+    double peakMultiplier = 1.0;
+    if (config.useDailyProfile)
+    {
+        peakMultiplier = 0.0;
+        for (int h = 0; h < 24; h++)
+        {
+            peakMultiplier = std::max(peakMultiplier, config.hourlyProfile[h]);
+        }
+    }
+
+    generatedUntil = engine->getClock()->now();
+
+    streams.clear();
+    for (size_t a = 0; a < config.airlines.size(); a++)
+    {
+        for (int direction = 0; direction < 2; direction++)
+        {
+            Stream stream;
+            stream.airline = static_cast<int>(a);
+            stream.isArrival = (direction == 0);
+            double perHour = stream.isArrival ? config.airlines[a].arrivalsPerHour
+                                              : config.airlines[a].departuresPerHour;
+            stream.baseRatePerMs = perHour / hourMs;
+            stream.peakRatePerMs = stream.baseRatePerMs * peakMultiplier;
+            stream.nextTime = generatedUntil;
+            stream.sequence = 0;
+            stream.randomKey = CounterRandom::keyFor(
+                config.airlines[a].name + (stream.isArrival ? "/arrivals" : "/departures"), config.seed);
+            stream.randomCounter = 0;
+            advanceStream(stream);
+            streams.push_back(stream);
+        }
+    }
+
+    engine->setFlightFinishedListener([this](Aircraft* aircraft, bool) {
+        releaseAircraft(aircraft);
+    });
+
+    SimTime endTime = generatedUntil + config.duration;
+    generateUntil(std::min(endTime, generatedUntil + generationWindowMs));
+
+    // One window per simulated second until the configured duration is covered
+    engine->addPeriodicTask(generationWindowMs, [this, endTime]() {
+        generateUntil(std::min(endTime, engine->getClock()->now() + generationWindowMs));
+        return generatedUntil < endTime;
+    }, generationWindowMs);
+}
+
+long long TrafficGenerator::getGeneratedCount() const
+{
+    return generatedCount.load();
+}
+
+long long TrafficGenerator::getEmergencyCount() const
+{
+    return emergencyCount.load();
+}
+
+size_t TrafficGenerator::getPoolSize()
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return aircraftPool.size();
+}
+
+size_t TrafficGenerator::getAircraftInUse()
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return aircraftPool.size() - freeAircraft.size();
+}
+
+/**
+ * Emit every stream's flights that fall before 'until'
+ */
+void TrafficGenerator::generateUntil(SimTime until)
+{
+    SimTime now = engine->getClock()->now();
+
+    for (Stream& stream : streams)
+    {
+        const AirlineTraffic& airline = config.airlines[stream.airline];
+
+        while (stream.nextTime < until)
+        {
+            SimTime entryTime = stream.nextTime;
+            advanceStream(stream);
+
+            // Even index = arrival, odd = departure; the engine derives the direction from it
+            int index = static_cast<int>(stream.sequence * 2 + (stream.isArrival ? 0 : 1));
+            stream.sequence++;
+
+            Aircraft* aircraft = acquireAircraft(index, airline.name, pickType(stream, airline));
+            if (config.emergencyRate > 0.0 && nextUnit(stream) < config.emergencyRate)
+            {
+                aircraft->EmergencyNo = 1 + static_cast<int>(nextUnit(stream) * 3); // Level 1-3
+                emergencyCount++;
+            }
+
+            generatedCount++;
+            engine->addFlight(aircraft, std::max<SimTime>(0, entryTime - now));
+        }
+    }
+
+    generatedUntil = until;
+}
+
+/**
+ * Next candidate from the peak-rate Poisson process, thinned down to the
+ * rate of the hour it lands in
+ */
+void TrafficGenerator::advanceStream(Stream& stream)
+{
+    if (stream.peakRatePerMs <= 0.0)
+    {
+        stream.nextTime = std::numeric_limits<SimTime>::max();
+        return;
+    }
+
+    double time = static_cast<double>(stream.nextTime);
+
+    while (true)
+    {
+        // Exponential gap by inversion
+        time += -std::log(1.0 - nextUnit(stream)) / stream.peakRatePerMs;
+        double rate = stream.baseRatePerMs * rateMultiplier(static_cast<SimTime>(time));
+        if (nextUnit(stream) * stream.peakRatePerMs <= rate)
+        {
+            break;
+        }
+    }
+
+    // Round up so the flight never lands before the candidate we just accepted
+    stream.nextTime = static_cast<SimTime>(std::ceil(time));
+}
+
+double TrafficGenerator::rateMultiplier(SimTime time) const
+{
+    if (!config.useDailyProfile) return 1.0;
+
+    int hour = static_cast<int>((time / hourMs) % 24);
+    return config.hourlyProfile[hour];
+}
+
+double TrafficGenerator::nextUnit(Stream& stream)
+{
+    return CounterRandom::unit(stream.randomKey, stream.randomCounter++);
+}
+
+/**
+ * Walk the cumulative weights of the airline's type mix
+ */
+AirCraftType TrafficGenerator::pickType(Stream& stream, const AirlineTraffic& airline)
+{
+    double total = 0.0;
+    int lastWeighted = 0;
+    for (int t = 0; t < aircraftTypeCount; t++)
+    {
+        total += airline.typeMix[t];
+        if (airline.typeMix[t] > 0.0) lastWeighted = t;
+    }
+    if (total <= 0.0) return AirCraftType::Commercial;
+
+    double pick = nextUnit(stream) * total;
+    for (int t = 0; t < aircraftTypeCount; t++)
+    {
+        if (airline.typeMix[t] <= 0.0) continue;
+        pick -= airline.typeMix[t];
+        if (pick < 0.0) return static_cast<AirCraftType>(t);
+    }
+    return static_cast<AirCraftType>(lastWeighted); // Rounding left us past the end
+}
+
+/**
+ * Reuse a finished aircraft if there is one, otherwise grow the pool
+ */
+Aircraft* TrafficGenerator::acquireAircraft(int index, const std::string& airlineName, AirCraftType type)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    if (freeAircraft.empty())
+    {
+        aircraftPool.emplace_back(index, airlineName, type);
+        return &aircraftPool.back();
+    }
+
+    Aircraft* aircraft = freeAircraft.back();
+    freeAircraft.pop_back();
+    *aircraft = Aircraft(index, airlineName, type);
+    return aircraft;
+}
+
+void TrafficGenerator::releaseAircraft(Aircraft* aircraft)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    freeAircraft.push_back(aircraft);
+}
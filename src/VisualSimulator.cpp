@@ -9,6 +9,7 @@ VisualSimulator::VisualSimulator()
     // Initialize our running flag to false until everything is set up
     isRunning = false;
     runwayMgr = nullptr;
+    worldSnapshots = nullptr;
     screenWidth = 1200;
     screenHeight = 600;
 }
@@ -251,6 +252,57 @@ void VisualSimulator::setRunwayManager(RunwayManager* manager)
     runwayMgr = manager;
 }
 
+/**
+ * Set the snapshot buffer to draw aircraft from
+ * Rendering then never touches the live aircraft
+ */
+void VisualSimulator::setWorldSnapshots(const WorldSnapshotBuffer* snapshots)
+{
+    worldSnapshots = snapshots;
+}
+
+/**
+ * Select the appropriate texture based on aircraft type
+ * This makes our code way more maintainable than having duplicate logic!
+ */
+const sf::Texture& VisualSimulator::aircraftTexture(AirCraftType type) const
+{
+    switch (type)
+    {
+        case AirCraftType::Commercial:
+            return commercialAircraftTexture;
+        case AirCraftType::Cargo:
+            return cargoAircraftTexture;
+        case AirCraftType::Military:
+        case AirCraftType::Emergency:
+        case AirCraftType::Medical:
+            // For now, using military texture for emergency/medical too
+            return militaryAircraftTexture;
+        default:
+            // Fallback to commercial if we have an unknown type
+            // Better than crashing, right? ¯\_(ツ)_/¯
+            return commercialAircraftTexture;
+    }
+}
+
+/**
+ * Color tint for special cases (white = no tint)
+ */
+sf::Color VisualSimulator::aircraftTint(int emergencyLevel, bool violation) const
+{
+    if (emergencyLevel > 0)
+    {
+        // Red tint for emergency aircraft
+        return sf::Color(255, 100, 100, 255);  // Reddish
+    }
+    if (violation)
+    {
+        // Yellow tint for aircraft with violations
+        return sf::Color(255, 255, 100, 255);  // Yellowish
+    }
+    return sf::Color::White;
+}
+
 /**
  * Create aircraft sprite based on aircraft type
  * Returns sprite object configured with proper texture and position
@@ -266,26 +318,7 @@ sf::Sprite VisualSimulator::createAircraftSprite(const Aircraft* aircraft)
     sf::Sprite sprite;
     
     // Select the appropriate texture based on aircraft type
-    // This makes our code way more maintainable than having duplicate logic!
-    switch (aircraft->type)
-    {
-        case AirCraftType::Commercial:
-            sprite.setTexture(commercialAircraftTexture);
-            break;
-        case AirCraftType::Cargo:
-            sprite.setTexture(cargoAircraftTexture);
-            break;
-        case AirCraftType::Military:
-        case AirCraftType::Emergency:
-        case AirCraftType::Medical:
-            // For now, using military texture for emergency/medical too
-            sprite.setTexture(militaryAircraftTexture);
-            break;
-        default:
-            // Fallback to commercial if we have an unknown type
-            // Better than crashing, right? ¯\_(ツ)_/¯
-            sprite.setTexture(commercialAircraftTexture);
-    }
+    sprite.setTexture(aircraftTexture(aircraft->type));
     
     // Scale the sprite appropriately
     sprite.setScale(0.1f, 0.1f);
@@ -321,24 +354,47 @@ void VisualSimulator::updateAircraftSprite(sf::Sprite& sprite, const Aircraft* a
     // Update rotation
     sprite.setRotation(aircraft->getRotationAngle());
     
-    // Apply visual effects based on aircraft state
-    // Reset color first (in case it was previously modified)
-    sprite.setColor(sf::Color::White);
+    // Apply visual effects based on aircraft state (replaces any previous tint)
+    sprite.setColor(aircraftTint(aircraft->EmergencyNo, aircraft->HasViolation || aircraft->hasActiveViolation));
     
-    // Apply color tint for special cases
-    if (aircraft->EmergencyNo > 0)
-    {
-        // Red tint for emergency aircraft
-        sprite.setColor(sf::Color(255, 100, 100, 255));  // Reddish
-    }
-    else if (aircraft->HasViolation || aircraft->hasActiveViolation)
+    // Update cached sprite
+    aircraftSpriteCache[aircraft->FlightNumber] = sprite;
+}
+
+/**
+ * Create aircraft sprite for a snapshot view
+ * Same texture, scale and origin as the live aircraft version
+ */
+sf::Sprite VisualSimulator::createAircraftSprite(const AircraftView& aircraft)
+{
+    std::map<std::string, sf::Sprite>::iterator cached = aircraftSpriteCache.find(aircraft.flightNumber);
+    if (cached != aircraftSpriteCache.end())
     {
-        // Yellow tint for aircraft with violations
-        sprite.setColor(sf::Color(255, 255, 100, 255));  // Yellowish
+        return cached->second;
     }
     
+    sf::Sprite sprite;
+    sprite.setTexture(aircraftTexture(aircraft.type));
+    sprite.setScale(0.1f, 0.1f);
+    
+    sf::FloatRect bounds = sprite.getLocalBounds();
+    sprite.setOrigin(bounds.width / 2, bounds.height / 2);
+    
+    updateAircraftSprite(sprite, aircraft);
+    return sprite;
+}
+
+/**
+ * Update sprite position, rotation and tint from a snapshot view
+ */
+void VisualSimulator::updateAircraftSprite(sf::Sprite& sprite, const AircraftView& aircraft)
+{
+    sprite.setPosition(mapWorldToScreen(aircraft.x, aircraft.y));
+    sprite.setRotation(aircraft.getRotationAngle());
+    sprite.setColor(aircraftTint(aircraft.emergencyLevel, aircraft.hasViolation()));
+    
     // Update cached sprite
-    aircraftSpriteCache[aircraft->FlightNumber] = sprite;
+    aircraftSpriteCache[aircraft.flightNumber] = sprite;
 }
 
 /**
@@ -375,7 +431,7 @@ sf::Sprite VisualSimulator::createRunwaySprite(const RunwayClass* runway)
     sprite.setPosition(x, y);
     
     // If runway is occupied, add visual indicator
-    if (runway->isOccupied)
+    if (runway->isOccupied())
     {
         // This is a simple color tint, but you could do more complex effects
         sprite.setColor(sf::Color(255, 200, 200)); // Light red tint
@@ -535,7 +591,7 @@ void VisualSimulator::renderRunways()
             sf::Text text = createText(statusText, bounds.left, bounds.top + bounds.height + 5.0f, 12);
             
             // If runway is occupied, make text red
-            if (runway->isOccupied)
+            if (runway->isOccupied())
             {
                 text.setFillColor(sf::Color::Red);
             }
@@ -547,6 +603,30 @@ void VisualSimulator::renderRunways()
 
 void VisualSimulator::renderAircraft()
 {
+    // Draw from the latest snapshot when the engine publishes them
+    WorldSnapshotBuffer::Ref snapshot;
+    if (worldSnapshots) snapshot = worldSnapshots->acquire();
+    if (snapshot)
+    {
+        for (const AircraftView& aircraft : snapshot->aircraft)
+        {
+            if (!aircraft.isActive()) continue;
+            
+            sf::Sprite aircraftSprite = createAircraftSprite(aircraft);
+            window.draw(aircraftSprite);
+            
+            // Aircraft information text above the sprite, colored by state
+            sf::FloatRect bounds = aircraftSprite.getGlobalBounds();
+            sf::Text text = createText(aircraft.getDisplayName(), bounds.left, bounds.top - 20.0f, 12);
+            int color[3];
+            aircraft.getStatusColor(color);
+            text.setFillColor(sf::Color(color[0], color[1], color[2]));
+            
+            window.draw(text);
+        }
+        return;
+    }
+    
     // Skip if no aircraft to render
     if (aircraftList.empty()) return;
     
@@ -612,10 +692,16 @@ void VisualSimulator::renderStatusPanel()
     }
     
     // Draw aircraft count
-    std::string countText = "Aircraft: " + std::to_string(aircraftList.size());
-    sf::Text aircraftCount = createText(countText, 
-                                     screenWidth - 300.0f, screenHeight - 80.0f, 14);
-    window.draw(aircraftCount);
+    size_t aircraftCount = aircraftList.size();
+    if (worldSnapshots)
+    {
+        WorldSnapshotBuffer::Ref snapshot = worldSnapshots->acquire();
+        if (snapshot) aircraftCount = snapshot->aircraft.size();
+    }
+    std::string countText = "Aircraft: " + std::to_string(aircraftCount);
+    sf::Text aircraftCountText = createText(countText, 
+                                         screenWidth - 300.0f, screenHeight - 80.0f, 14);
+    window.draw(aircraftCountText);
     
     // Draw time information (using system time)
     time_t now = time(nullptr);
@@ -0,0 +1,237 @@
+#include "../include/WorldSnapshot.h"
+#include "../include/Aircraft.h"
+#include "../include/RunwayManager.h"
+#include <utility>
+
+const int WorldSnapshotBuffer::slotCount;
+
+void AircraftView::copyFrom(const Aircraft& aircraft, const AircraftRef& rowRef)
+{
+    ref = rowRef;
+    flightNumber = aircraft.FlightNumber;
+    type = aircraft.type;
+    state = aircraft.state;
+    direction = aircraft.direction;
+    speed = aircraft.speed;
+    x = aircraft.x_position;
+    y = aircraft.y_position;
+    emergencyLevel = aircraft.EmergencyNo;
+    flags = AircraftTable::flagsOf(aircraft);
+    queueEntryTime = aircraft.queueEntryTime;
+}
+
+bool AircraftView::hasViolation() const
+{
+    return (flags & (AircraftTable::FlagViolation | AircraftTable::FlagActiveViolation)) != 0;
+}
+
+bool AircraftView::isActive() const
+{
+    return (flags & AircraftTable::FlagActive) != 0;
+}
+
+std::string AircraftView::getDisplayName() const
+{
+    return Aircraft::displayName(flightNumber, state, emergencyLevel, hasViolation());
+}
+
+float AircraftView::getRotationAngle() const
+{
+    return Aircraft::rotationAngle(direction);
+}
+
+void AircraftView::getStatusColor(int rgb[3]) const
+{
+    Aircraft::statusColor(state, emergencyLevel, hasViolation(), rgb);
+}
+
+WorldSnapshot::WorldSnapshot()
+    : sequence(0), time(0), emergencyCount(0), activeViolationCount(0)
+{
+    for (int i = 0; i < 8; i++) stateCounts[i] = 0;
+    for (int i = 0; i < 5; i++) typeCounts[i] = 0;
+}
+
+/**
+ * Copy every live row of the table plus the runway states. Views are
+ * assigned in place so a reused slot keeps its string buffers.
+ */
+void WorldSnapshot::capture(const AircraftTable& table, RunwayManager* runwayManager, SimTime now)
+{
+    size_t count = 0;
+    table.forEachBlockLocked([&](const AircraftTable::Block& block, size_t rows) {
+        for (size_t r = 0; r < rows; r++)
+        {
+            if (!(block.flags[r] & AircraftTable::FlagLive)) continue;
+
+            if (count == aircraft.size()) aircraft.emplace_back();
+            AircraftView& view = aircraft[count++];
+            view.ref.handle = block.aircraft[r]->tableHandle;
+            view.ref.generation = block.generation[r];
+            view.flightNumber = block.aircraft[r]->FlightNumber;
+            view.type = static_cast<AirCraftType>(block.type[r]);
+            view.state = static_cast<FlightState>(block.state[r]);
+            view.direction = static_cast<Direction>(block.direction[r]);
+            view.speed = block.speed[r];
+            view.x = block.x[r];
+            view.y = block.y[r];
+            view.emergencyLevel = block.emergency[r];
+            view.flags = block.flags[r];
+            view.queueEntryTime = block.queueEntry[r];
+        }
+    });
+    aircraft.resize(count);
+    finish(runwayManager, now);
+}
+
+void WorldSnapshot::finish(RunwayManager* runwayManager, SimTime now)
+{
+    time = now;
+    for (int i = 0; i < 8; i++) stateCounts[i] = 0;
+    for (int i = 0; i < 5; i++) typeCounts[i] = 0;
+    emergencyCount = 0;
+    activeViolationCount = 0;
+
+    // Keep the order of the views that are left - swapping keeps their strings' buffers
+    size_t count = 0;
+    for (size_t i = 0; i < aircraft.size(); i++)
+    {
+        if (aircraft[i].ref.handle == invalidAircraftHandle) continue;
+        if (count != i) std::swap(aircraft[count], aircraft[i]);
+        const AircraftView& view = aircraft[count++];
+
+        stateCounts[static_cast<int>(view.state)]++;
+        typeCounts[static_cast<int>(view.type)]++;
+        if (view.emergencyLevel > 0) emergencyCount++;
+        if (view.flags & AircraftTable::FlagActiveViolation) activeViolationCount++;
+    }
+    aircraft.resize(count);
+
+    runways.clear();
+    if (runwayManager)
+    {
+        for (int i = 0; i < runwayManager->getRunwayCount(); i++)
+        {
+            RunwayClass* runway = runwayManager->getRunwayByIndex(i);
+            if (!runway) continue;
+
+            RunwayView view;
+            view.id = runway->id;
+            view.type = runway->type;
+            view.occupied = runway->isOccupied();
+            runways.push_back(view);
+        }
+    }
+}
+
+// ======== WorldSnapshotBuffer::Ref ========
+
+WorldSnapshotBuffer::Ref::Ref()
+    : snapshot(nullptr), pin(nullptr)
+{
+}
+
+WorldSnapshotBuffer::Ref::Ref(const WorldSnapshot* pinnedSnapshot, std::atomic<int>* pinCount)
+    : snapshot(pinnedSnapshot), pin(pinCount)
+{
+}
+
+WorldSnapshotBuffer::Ref::Ref(Ref&& other)
+    : snapshot(other.snapshot), pin(other.pin)
+{
+    other.snapshot = nullptr;
+    other.pin = nullptr;
+}
+
+WorldSnapshotBuffer::Ref& WorldSnapshotBuffer::Ref::operator=(Ref&& other)
+{
+    if (this != &other)
+    {
+        release();
+        snapshot = other.snapshot;
+        pin = other.pin;
+        other.snapshot = nullptr;
+        other.pin = nullptr;
+    }
+    return *this;
+}
+
+WorldSnapshotBuffer::Ref::~Ref()
+{
+    release();
+}
+
+void WorldSnapshotBuffer::Ref::release()
+{
+    if (pin) pin->fetch_sub(1);
+    snapshot = nullptr;
+    pin = nullptr;
+}
+
+// ======== WorldSnapshotBuffer ========
+
+WorldSnapshotBuffer::WorldSnapshotBuffer()
+    : published(-1), nextSequence(1), publishedCount(0), skippedCount(0)
+{
+    for (int i = 0; i < slotCount; i++)
+    {
+        pins[i] = 0;
+    }
+}
+
+/**
+ * A slot that is not the published one and that no reader holds.
+ * A reader that pins it after this check backs off in acquire(),
+ * because the slot is not published.
+ */
+WorldSnapshot* WorldSnapshotBuffer::beginWrite()
+{
+    int current = published.load();
+    for (int i = 0; i < slotCount; i++)
+    {
+        if (i != current && pins[i].load() == 0)
+        {
+            return &slots[i];
+        }
+    }
+
+    skippedCount++;
+    return nullptr;
+}
+
+void WorldSnapshotBuffer::publish(WorldSnapshot* snapshot)
+{
+    snapshot->sequence = nextSequence++;
+    published.store(static_cast<int>(snapshot - slots));
+    publishedCount++;
+}
+
+/**
+ * Pin the published slot, then make sure it is still the published one -
+ * otherwise the writer may already be refilling it, so let go and retry
+ */
+WorldSnapshotBuffer::Ref WorldSnapshotBuffer::acquire() const
+{
+    while (true)
+    {
+        int slot = published.load();
+        if (slot < 0) return Ref();
+
+        pins[slot].fetch_add(1);
+        if (published.load() == slot)
+        {
+            return Ref(&slots[slot], &pins[slot]);
+        }
+        pins[slot].fetch_sub(1);
+    }
+}
+
+unsigned long long WorldSnapshotBuffer::getPublishedCount() const
+{
+    return publishedCount.load();
+}
+
+unsigned long long WorldSnapshotBuffer::getSkippedCount() const
+{
+    return skippedCount.load();
+}
@@ -0,0 +1,1828 @@
+#include "Benchmarks.h"
+#include "../../include/Aircraft.h"
+#include "../../include/AircraftTable.h"
+#include "../../include/IndexedHeap.h"
+#include "../../include/FlightsScheduler.h"
+#include "../../include/Radar.h"
+#include "../../include/CounterRandom.h"
+#include "../../include/ArrivalPlanner.h"
+#include "../../include/ServiceTimeModel.h"
+#include "../../include/QueueTelemetry.h"
+#include "../../include/AirlineManager.h"
+#include "../../include/SchedulerState.h"
+#include "../../include/Runway.h"
+#include "../../include/RunwayManager.h"
+#include "../../include/ATCScontroller.h"
+#include "../../include/LogHistogram.h"
+#include "../../include/AirportNetwork.h"
+#include "../../include/SimulationEngine.h"
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <vector>
+#include <unordered_set>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include <cmath>
+
+// Run body a few times and keep the fastest run (milliseconds)
+static double bestOf(int runs, const std::function<void()>& body)
+{
+    double best = 0.0;
+    for (int run = 0; run < runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+        if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+// One row of "old vs new" timings with the speedup
+static void printComparison(const std::string& label, double oldTime, double newTime, const char* unit = " ms")
+{
+    std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << oldTime << unit
+              << std::setw(10) << newTime << unit
+              << std::setw(11) << std::setprecision(1) << (newTime > 0 ? oldTime / newTime : 0.0) << "x" << std::endl;
+}
+
+// Microseconds per operation of a timed loop
+static double perOperation(double ms, size_t operations)
+{
+    return operations > 0 ? ms * 1000.0 / operations : 0.0;
+}
+
+/**
+ * Aircraft* sweeps (what the scheduler, ATC and radar used to do) against
+ * the same sweeps over AircraftTable columns
+ */
+static int benchScan(const BenchmarkOptions& options)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    size_t count = static_cast<size_t>(options.aircraftCount);
+    unsigned long long key = CounterRandom::keyFor("bench/scan", 0);
+
+    // Aircraft allocated one after another, like the traffic generator's pool
+    std::deque<Aircraft> fleet;
+    std::vector<Aircraft*> pointers;
+    AircraftTable table;
+    pointers.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned long long counter = i * 8;
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 6],
+                           static_cast<AirCraftType>(CounterRandom::range(key, counter, 0, 4)));
+        Aircraft& aircraft = fleet.back();
+        aircraft.state = static_cast<FlightState>(CounterRandom::range(key, counter + 1, 0, 7));
+        aircraft.speed = CounterRandom::range(key, counter + 2, 0, 950);
+        aircraft.EmergencyNo = (CounterRandom::range(key, counter + 3, 0, 99) == 0) ? 1 : 0;
+        aircraft.x_position = CounterRandom::range(key, counter + 4, 0, 1279);
+        aircraft.y_position = CounterRandom::range(key, counter + 5, 0, 719);
+        aircraft.isActive = true;
+        pointers.push_back(&aircraft);
+        table.insert(&aircraft);
+    }
+
+    Radar radar;
+    const int runs = 5;
+    size_t pointerResult = 0, tableResult = 0;
+
+    std::cout << "Scan benchmark: " << count << " aircraft (sizeof(Aircraft) = " << sizeof(Aircraft)
+              << " bytes), best of " << runs << " runs" << std::endl;
+    std::cout << std::left << std::setw(22) << "" << std::right << std::setw(13) << "Aircraft*"
+              << std::setw(13) << "table" << std::setw(12) << "speedup" << std::endl;
+
+    // Radar violation sweep
+    double pointerMs = bestOf(runs, [&]() { pointerResult = radar.detectViolations(pointers).size(); });
+    double tableMs = bestOf(runs, [&]() { tableResult = radar.detectViolations(table).size(); });
+    printComparison("Radar violations", pointerMs, tableMs);
+    bool matches = (pointerResult == tableResult);
+
+    // getAircraftByState
+    pointerMs = bestOf(runs, [&]() {
+        std::vector<Aircraft*> holding;
+        for (Aircraft* aircraft : pointers)
+        {
+            if (aircraft->state == FlightState::Holding) holding.push_back(aircraft);
+        }
+        pointerResult = holding.size();
+    });
+    tableMs = bestOf(runs, [&]() { tableResult = table.collectByState(FlightState::Holding).size(); });
+    printComparison("By state", pointerMs, tableMs);
+    matches = matches && (pointerResult == tableResult);
+
+    // Emergency count (getQueueStatistics)
+    pointerMs = bestOf(runs, [&]() {
+        size_t emergencies = 0;
+        for (Aircraft* aircraft : pointers)
+        {
+            if (aircraft->EmergencyNo > 0) emergencies++;
+        }
+        pointerResult = emergencies;
+    });
+    tableMs = bestOf(runs, [&]() { tableResult = static_cast<size_t>(table.countEmergencies()); });
+    printComparison("Emergency count", pointerMs, tableMs);
+    matches = matches && (pointerResult == tableResult);
+
+    // Cache lines a radar sweep has to bring in: at least one per Aircraft object,
+    // against the flags, type, state and speed columns (7 bytes per row)
+    size_t pointerLines = count;
+    size_t tableLines = (count * 7 + 63) / 64;
+    std::cout << "Cache lines per radar sweep: >= " << pointerLines << " vs ~" << tableLines
+              << " (" << std::setprecision(1) << static_cast<double>(pointerLines) / tableLines << "x fewer)" << std::endl;
+
+    if (!matches)
+    {
+        std::cerr << "Table and pointer scans disagree!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * The scheduler queue the way it used to be: a vector re-sorted by
+ * calculatePriorityScore() on every push, popped from the front
+ */
+struct SortedVectorQueue
+{
+    std::vector<Aircraft*> queue;
+
+    void sort()
+    {
+        std::sort(queue.begin(), queue.end(), [](Aircraft* a, Aircraft* b) {
+            return a->calculatePriorityScore() > b->calculatePriorityScore();
+        });
+    }
+
+    void push(Aircraft* aircraft)
+    {
+        queue.push_back(aircraft);
+        sort();
+    }
+
+    Aircraft* pop()
+    {
+        Aircraft* aircraft = queue.front();
+        queue.erase(queue.begin());
+        return aircraft;
+    }
+
+    void remove(Aircraft* aircraft)
+    {
+        queue.erase(std::find(queue.begin(), queue.end(), aircraft));
+    }
+};
+
+/**
+ * Push, pop, remove and priority update on a queue that already holds
+ * queuedCount flights. The vector gets fewer operations than the heap
+ * because each of its pushes re-sorts the whole queue.
+ */
+static bool benchQueueSize(size_t queuedCount)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    const size_t vectorOps = 20;
+    const size_t heapOps = 10000;
+    unsigned long long key = CounterRandom::keyFor("bench/queue", queuedCount);
+
+    // Queued flights plus spares for the timed pushes
+    std::deque<Aircraft> fleet;
+    AircraftTable table;
+    size_t total = queuedCount + heapOps;
+    for (size_t i = 0; i < total; i++)
+    {
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 6],
+                           static_cast<AirCraftType>(CounterRandom::range(key, i * 2, 0, 4)));
+        fleet.back().EmergencyNo = (CounterRandom::range(key, i * 2 + 1, 0, 99) == 0) ? 1 : 0;
+        table.insert(&fleet.back());
+    }
+
+    SortedVectorQueue vectorQueue;
+    IndexedHeap heap(true);     // With ranks, like the scheduler's queues
+    for (size_t i = 0; i < queuedCount; i++)
+    {
+        vectorQueue.queue.push_back(&fleet[i]);
+        heap.push(&fleet[i], fleet[i].tableHandle, fleet[i].priorityKey());
+    }
+    vectorQueue.sort();
+
+    // Both queues must hand out the same priorities in the same order (checked on copies)
+    bool matches = true;
+    SortedVectorQueue vectorCheck = vectorQueue;
+    IndexedHeap heapCheck = heap;
+    for (size_t i = 0; i < 100 && !heapCheck.empty(); i++)
+    {
+        matches = matches && (vectorCheck.pop()->calculatePriorityScore() == heapCheck.pop()->calculatePriorityScore());
+    }
+
+    std::cout << std::left << std::setw(22) << (std::to_string(queuedCount) + " queued") << std::right
+              << std::setw(13) << "vector+sort" << std::setw(13) << "heap" << std::setw(12) << "speedup" << std::endl;
+
+    // Push spares, then pop the same number back off
+    double vectorMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < vectorOps; i++) vectorQueue.push(&fleet[queuedCount + i]);
+    });
+    double heapMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < heapOps; i++)
+        {
+            Aircraft& aircraft = fleet[queuedCount + i];
+            heap.push(&aircraft, aircraft.tableHandle, aircraft.priorityKey());
+        }
+    });
+    printComparison("  push", perOperation(vectorMs, vectorOps), perOperation(heapMs, heapOps), " us");
+
+    vectorMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < vectorOps; i++) vectorQueue.pop();
+    });
+    heapMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < heapOps; i++) heap.pop();
+    });
+    printComparison("  pop", perOperation(vectorMs, vectorOps), perOperation(heapMs, heapOps), " us");
+
+    // The heap went through more pushes and pops than the vector, so probes and removals
+    // only use flights that are queued in both
+    std::unordered_set<Aircraft*> inVector(vectorQueue.queue.begin(), vectorQueue.queue.end());
+    std::vector<Aircraft*> shared;
+    for (const IndexedHeap::Entry& entry : heap.entries())
+    {
+        if (inVector.count(entry.aircraft) != 0) shared.push_back(entry.aircraft);
+    }
+
+    // Queue position for the wait estimate - linear search against the rank treap
+    std::vector<Aircraft*> probes;
+    for (size_t i = 0; i < heapOps; i++)
+    {
+        probes.push_back(shared[CounterRandom::range(key, total * 2 + i, 0, static_cast<int>(shared.size()) - 1)]);
+    }
+    std::vector<int> ranks(heapOps);
+    vectorMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < vectorOps * 10; i++)
+        {
+            ranks[i] = static_cast<int>(std::find(vectorQueue.queue.begin(), vectorQueue.queue.end(), probes[i]) - vectorQueue.queue.begin());
+        }
+    });
+    heapMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < heapOps; i++) ranks[i] = heap.rankOf(probes[i]->tableHandle);
+    });
+    printComparison("  rank", perOperation(vectorMs, vectorOps * 10), perOperation(heapMs, heapOps), " us");
+
+    // Spot-check the treap against counting the entries that come out first
+    for (size_t i = 0; i < 20; i++)
+    {
+        const IndexedHeap::Entry* probe = nullptr;
+        for (const IndexedHeap::Entry& entry : heap.entries())
+        {
+            if (entry.handle == probes[i]->tableHandle) probe = &entry;
+        }
+
+        int expected = 0;
+        for (const IndexedHeap::Entry& entry : heap.entries())
+        {
+            if (entry.key > probe->key || (entry.key == probe->key && entry.sequence < probe->sequence)) expected++;
+        }
+        matches = matches && (heap.rankOf(probe->handle) == expected);
+    }
+
+    // Remove flights from the middle (timed out or diverted) - a quarter of the queue at most
+    std::vector<Aircraft*> victims;
+    size_t victimCount = std::min(heapOps, shared.size() / 4);
+    for (Aircraft* aircraft : shared)
+    {
+        if (victims.size() == victimCount) break;
+        victims.push_back(aircraft);
+    }
+    size_t removeOps = std::min(heapOps, victims.size());
+    size_t vectorRemoveOps = std::min(vectorOps, removeOps);
+    vectorMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < vectorRemoveOps; i++) vectorQueue.remove(victims[i]);
+    });
+    heapMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < removeOps; i++) heap.remove(victims[i]->tableHandle);
+    });
+    printComparison("  remove", perOperation(vectorMs, vectorRemoveOps), perOperation(heapMs, removeOps), " us");
+
+    // Raise flights to an emergency - the vector has to re-sort, the heap sifts one entry up
+    std::vector<Aircraft*> raised;
+    for (const IndexedHeap::Entry& entry : heap.entries())
+    {
+        if (raised.size() == heapOps) break;
+        raised.push_back(entry.aircraft);
+    }
+    size_t updateOps = raised.size();
+    size_t vectorUpdateOps = std::min(vectorOps, updateOps);
+    vectorMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < vectorUpdateOps; i++)
+        {
+            raised[i]->EmergencyNo = 2;
+            vectorQueue.sort();
+        }
+    });
+    heapMs = bestOf(1, [&]() {
+        for (size_t i = 0; i < updateOps; i++)
+        {
+            raised[i]->EmergencyNo = 2;
+            heap.update(raised[i]->tableHandle, raised[i]->priorityKey());
+        }
+    });
+    printComparison("  priority update", perOperation(vectorMs, vectorUpdateOps), perOperation(heapMs, updateOps), " us");
+
+    return matches;
+}
+
+// Scheduler queue: vector + sort against IndexedHeap at 10k and 100k queued flights
+static int benchQueue(const BenchmarkOptions& options)
+{
+    (void)options;
+    std::cout << "Queue benchmark: microseconds per operation" << std::endl;
+
+    bool matches = benchQueueSize(10000);
+    matches = benchQueueSize(100000) && matches;
+
+    if (!matches)
+    {
+        std::cerr << "Heap disagrees with the sorted vector or its own ranks!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Queue one batch of requests from 'threads' producer threads, either
+ * through the locked addArrival/addDeparture or through the intake rings
+ * with one consumer draining them. Returns the producers' time and checks
+ * that every request ended up queued.
+ */
+static double timeIntake(size_t requests, int threads, bool useRings, unsigned long long& overflows, bool& complete)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    unsigned long long key = CounterRandom::keyFor("bench/intake", 0);
+
+    std::deque<Aircraft> fleet;
+    for (size_t i = 0; i < requests; i++)
+    {
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 6],
+                           static_cast<AirCraftType>(CounterRandom::range(key, i, 0, 4)));
+    }
+
+    FlightsScheduler scheduler;
+    std::atomic<bool> producing(true);
+    std::thread consumer;
+    if (useRings)
+    {
+        consumer = std::thread([&]() {
+            while (producing.load())
+            {
+                if (scheduler.drainIntake() == 0) std::this_thread::yield();
+            }
+        });
+    }
+
+    // Even requests are arrivals, odd ones departures; thread t takes every threads-th request
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++)
+    {
+        producers.emplace_back([&, t]() {
+            for (size_t i = static_cast<size_t>(t); i < requests; i += threads)
+            {
+                Aircraft* aircraft = &fleet[i];
+                if (useRings)
+                {
+                    if (i % 2 == 0) scheduler.submitArrival(aircraft);
+                    else scheduler.submitDeparture(aircraft);
+                }
+                else
+                {
+                    if (i % 2 == 0) scheduler.addArrival(aircraft);
+                    else scheduler.addDeparture(aircraft);
+                }
+            }
+        });
+    }
+    for (std::thread& producer : producers) producer.join();
+    auto end = std::chrono::steady_clock::now();
+
+    if (useRings)
+    {
+        producing = false;
+        consumer.join();
+        scheduler.drainIntake();
+        overflows += scheduler.getIntakeOverflows();
+    }
+
+    complete = complete && scheduler.getArrivalQueue().size() + scheduler.getDepartureQueue().size() == requests;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
+// Producer-side cost of queuing requests: locked queues against intake rings, 1 to 8 threads
+static int benchIntake(const BenchmarkOptions& options)
+{
+    (void)options;
+    const size_t requests = 200000;
+    const int threadCounts[] = {1, 2, 4, 8};
+
+    std::cout << "Intake benchmark: nanoseconds per request, " << requests << " requests, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(22) << "producers" << std::right
+              << std::setw(13) << "locked" << std::setw(13) << "rings" << std::setw(12) << "speedup" << std::endl;
+
+    unsigned long long overflows = 0;
+    bool complete = true;
+    for (int threads : threadCounts)
+    {
+        double lockedMs = timeIntake(requests, threads, false, overflows, complete);
+        double ringMs = timeIntake(requests, threads, true, overflows, complete);
+        printComparison("  " + std::to_string(threads) + (threads == 1 ? " thread" : " threads"),
+                        perOperation(lockedMs, requests) * 1000.0, perOperation(ringMs, requests) * 1000.0, " ns");
+    }
+    std::cout << "Requests that found a ring full: " << overflows << std::endl;
+
+    if (!complete)
+    {
+        std::cerr << "Some requests never reached a queue!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Queued arrivals for the planner: random types, entry times a few seconds
+ * apart and the odd emergency, handed over in queue order like
+ * FlightsScheduler::scheduleFlight() does.
+ */
+static void makeArrivals(size_t count, unsigned long long key, std::deque<Aircraft>& fleet, AircraftTable& table,
+                         std::vector<ArrivalPlanner::Flight>& flights)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    IndexedHeap queue;
+    for (size_t i = 0; i < count; i++)
+    {
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 6],
+                           static_cast<AirCraftType>(CounterRandom::range(key, i * 3, 0, 4)));
+        Aircraft& aircraft = fleet.back();
+        aircraft.EmergencyNo = (CounterRandom::range(key, i * 3 + 1, 0, 99) == 0) ? 1 : 0;
+        aircraft.queueEntryTime = static_cast<SimTime>(i) * 2000 + CounterRandom::range(key, i * 3 + 2, 0, 1999);
+        table.insert(&aircraft);
+        queue.push(&aircraft, aircraft.tableHandle, aircraft.priorityKey());
+    }
+
+    std::vector<IndexedHeap::Entry> entries;
+    queue.topEntries(count, entries);
+    flights.clear();
+    for (const IndexedHeap::Entry& entry : entries)
+    {
+        ArrivalPlanner::Flight flight;
+        flight.handle = entry.handle;
+        flight.aircraft = entry.aircraft;
+        flight.key = entry.key;
+        flight.priority = entry.aircraft->staticPriority();
+        flight.type = entry.aircraft->type;
+        flights.push_back(flight);
+    }
+}
+
+// Total delay (slot start - queue entry) of a plan in minutes, and whether it keeps the shift and priority rules
+static double planDelay(const ArrivalPlanner& planner, const std::vector<ArrivalPlanner::Flight>& flights, bool& valid)
+{
+    std::vector<ArrivalPlanner::Slot> slots = planner.getSlots();
+    valid = valid && slots.size() == flights.size();
+
+    double delay = 0.0;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        const ArrivalPlanner::Slot& slot = slots[i];
+        delay += (slot.start - slot.aircraft->queueEntryTime) / 60000.0;
+        valid = valid && slot.shift <= planner.getMaxShift() && slot.shift >= -planner.getMaxShift();
+
+        // Nobody lands ahead of a higher priority flight that was queued before it on the same runway
+        for (size_t j = i + 1; j < slots.size() && slots[j].runway == slot.runway; j++)
+        {
+            bool queuedBefore = slots[j].aircraft->priorityKey() > slot.aircraft->priorityKey();
+            valid = valid && !(queuedBefore && slots[j].aircraft->staticPriority() > slot.aircraft->staticPriority());
+        }
+    }
+    return delay;
+}
+
+// Best total start time over every order of a few flights that keeps the rules (one runway)
+static long long bruteForceBest(const std::vector<ArrivalPlanner::Flight>& flights, const std::vector<SimTime>& service, int maxShift)
+{
+    std::vector<int> order(flights.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+
+    long long best = -1;
+    do
+    {
+        bool allowed = true;
+        long long start = 0, total = 0;
+        for (size_t p = 0; p < order.size() && allowed; p++)
+        {
+            int i = order[p];
+            allowed = std::abs(static_cast<int>(p) - i) <= maxShift;
+            for (size_t q = p + 1; q < order.size() && allowed; q++)
+            {
+                allowed = !(order[q] < i && flights[order[q]].priority > flights[i].priority);
+            }
+            total += start;
+            start += service[i];
+        }
+        if (allowed && (best < 0 || total < best)) best = total;
+    } while (std::next_permutation(order.begin(), order.end()));
+    return best;
+}
+
+// Arrival planner: plan and re-plan time for 100-1000 queued arrivals, delay against queue order
+static int benchPlan(const BenchmarkOptions& options)
+{
+    (void)options;
+    const size_t sizes[] = {100, 500, 1000};
+    const size_t joiners = 10;
+    const std::vector<int> runways = {0, 2};
+
+    // Runway occupancy by type, as if measured - shorter for light traffic, longer for cargo
+    static const SimTime serviceByType[] = {90000, 150000, 80000, 70000, 60000};
+    ServiceTimeModel model;
+    for (int runway : runways)
+    {
+        for (int type = 0; type < ServiceTimeModel::typeCount; type++)
+        {
+            model.record(runway, static_cast<AirCraftType>(type), true, serviceByType[type]);
+        }
+    }
+
+    std::cout << "Arrival plan benchmark: " << runways.size() << " runways, max shift 3" << std::endl;
+    std::cout << std::left << std::setw(12) << "arrivals" << std::right
+              << std::setw(14) << "full plan" << std::setw(16) << "join +" + std::to_string(joiners)
+              << std::setw(14) << "reused" << std::setw(16) << "queue order" << std::setw(14) << "planned" << std::endl;
+
+    bool valid = true;
+    for (size_t count : sizes)
+    {
+        std::deque<Aircraft> fleet;
+        AircraftTable table;
+        std::vector<ArrivalPlanner::Flight> flights;
+        makeArrivals(count + joiners, CounterRandom::keyFor("bench/plan", count), fleet, table, flights);
+
+        // The newest arrivals join last, behind everything already planned
+        std::vector<ArrivalPlanner::Flight> before, after;
+        for (const ArrivalPlanner::Flight& flight : flights)
+        {
+            (flight.aircraft->tableHandle < count ? before : after).push_back(flight);
+        }
+        std::vector<SimTime> runwayFree(runways.size(), static_cast<SimTime>(count) * 2000);
+
+        double fullMs = bestOf(5, [&]() {
+            ArrivalPlanner planner(3, count + joiners);
+            planner.setRunways(runways);
+            planner.plan(before, runwayFree, model);
+        });
+
+        double joinMs = 0.0;
+        double reused = 0.0;
+        for (int run = 0; run < 5; run++)
+        {
+            ArrivalPlanner planner(3, count + joiners);
+            planner.setRunways(runways);
+            planner.plan(before, runwayFree, model);
+            unsigned long long computed = planner.getLayersComputed(), kept = planner.getLayersReused();
+
+            double ms = bestOf(1, [&]() { planner.plan(flights, runwayFree, model); });
+            if (run == 0 || ms < joinMs) joinMs = ms;
+            computed = planner.getLayersComputed() - computed;
+            kept = planner.getLayersReused() - kept;
+            reused = 100.0 * kept / std::max(1ULL, computed + kept);
+        }
+
+        // Same allocation, no position shifting = queue order
+        ArrivalPlanner fcfs(0, count + joiners);
+        fcfs.setRunways(runways);
+        fcfs.plan(flights, runwayFree, model);
+        ArrivalPlanner planner(3, count + joiners);
+        planner.setRunways(runways);
+        planner.plan(flights, runwayFree, model);
+        double fcfsDelay = planDelay(fcfs, flights, valid);
+        double plannedDelay = planDelay(planner, flights, valid);
+        valid = valid && plannedDelay <= fcfsDelay;
+
+        std::cout << std::left << std::setw(12) << count << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(11) << fullMs << " ms" << std::setw(13) << joinMs << " ms"
+                  << std::setw(13) << std::setprecision(1) << reused << "%"
+                  << std::setw(12) << std::setprecision(0) << fcfsDelay << " min"
+                  << std::setw(10) << plannedDelay << " min" << std::endl;
+    }
+
+    // The dynamic program must match trying every order on small cases
+    for (unsigned long long trial = 0; trial < 20; trial++)
+    {
+        std::deque<Aircraft> fleet;
+        AircraftTable table;
+        std::vector<ArrivalPlanner::Flight> flights;
+        makeArrivals(8, CounterRandom::keyFor("bench/plan/check", trial), fleet, table, flights);
+
+        ArrivalPlanner planner(2, 8);
+        planner.setRunways(std::vector<int>(1, 0));
+        planner.plan(flights, std::vector<SimTime>(1, 0), model);
+
+        std::vector<SimTime> service;
+        for (const ArrivalPlanner::Flight& flight : flights) service.push_back(model.getServiceTime(0, flight.type));
+
+        long long total = 0;
+        for (const ArrivalPlanner::Slot& slot : planner.getSlots()) total += slot.start;
+        valid = valid && total == bruteForceBest(flights, service, 2);
+    }
+
+    if (!valid)
+    {
+        std::cerr << "Plan breaks the shift or priority rules, or isn't optimal!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Wall time for 'threads' threads to record 'pairs' enqueue/dequeue pairs each, with or without a shared lock
+static double timeTelemetry(QueueTelemetry& telemetry, size_t pairs, int threads, bool locked)
+{
+    std::mutex lock;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&telemetry, &lock, pairs, locked, t]() {
+            QueueTelemetry::Flow flow = (t % 2 == 0) ? QueueTelemetry::Arrivals : QueueTelemetry::Departures;
+            for (size_t i = 0; i < pairs; i++)
+            {
+                AirCraftType type = static_cast<AirCraftType>(i % 5);
+                if (locked)
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    telemetry.recordEnqueue(flow, type);
+                    telemetry.recordDequeue(flow, type, static_cast<SimTime>(i % 60000), true);
+                }
+                else
+                {
+                    telemetry.recordEnqueue(flow, type);
+                    telemetry.recordDequeue(flow, type, static_cast<SimTime>(i % 60000), true);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
+// Cost of the queue telemetry per enqueue/dequeue pair, lock-free against behind one mutex
+static int benchTelemetry(const BenchmarkOptions& options)
+{
+    (void)options;
+    const size_t pairs = 500000;
+    const int threadCounts[] = {1, 2, 4, 8};
+
+    std::cout << "Telemetry benchmark: nanoseconds per enqueue/dequeue pair, " << pairs << " pairs per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(22) << "recording threads" << std::right
+              << std::setw(13) << "mutex" << std::setw(13) << "atomics" << std::setw(12) << "speedup" << std::endl;
+
+    bool complete = true;
+    for (int threads : threadCounts)
+    {
+        QueueTelemetry locked, lockFree;
+        double lockedMs = timeTelemetry(locked, pairs, threads, true);
+        double lockFreeMs = timeTelemetry(lockFree, pairs, threads, false);
+        size_t total = pairs * threads;
+        printComparison("  " + std::to_string(threads) + (threads == 1 ? " thread" : " threads"),
+                        perOperation(lockedMs, total) * 1000.0, perOperation(lockFreeMs, total) * 1000.0, " ns");
+
+        // Every pair must be counted once and the queues end up empty
+        QueueTelemetry::Stats arrivals = lockFree.getStats(QueueTelemetry::Arrivals);
+        QueueTelemetry::Stats departures = lockFree.getStats(QueueTelemetry::Departures);
+        complete = complete && arrivals.served + departures.served == total &&
+                   arrivals.waitMs.count + departures.waitMs.count == total &&
+                   lockFree.getDepth(QueueTelemetry::Arrivals) == 0 && lockFree.getDepth(QueueTelemetry::Departures) == 0;
+    }
+
+    // Percentiles from the buckets stay within a bucket width (1/16) of the exact ones
+    LogHistogram histogram;
+    std::vector<long long> values;
+    unsigned long long key = CounterRandom::keyFor("bench/telemetry", 0);
+    for (unsigned long long i = 0; i < 100000; i++)
+    {
+        long long value = CounterRandom::range(key, i, 0, 600000);
+        values.push_back(value);
+        histogram.record(value);
+    }
+    std::sort(values.begin(), values.end());
+    LogHistogram::Snapshot snapshot = histogram.snapshot();
+    for (double p : {0.5, 0.9, 0.99})
+    {
+        double exact = static_cast<double>(values[static_cast<size_t>(p * values.size()) - 1]);
+        double estimate = static_cast<double>(snapshot.percentile(p));
+        std::cout << "  p" << static_cast<int>(p * 100) << " of 100k waits: exact " << std::setprecision(1)
+                  << exact / 1000.0 << " s, histogram " << estimate / 1000.0 << " s" << std::endl;
+        complete = complete && std::abs(estimate - exact) <= exact / 16.0 + 1.0;
+    }
+
+    if (!complete)
+    {
+        std::cerr << "Telemetry lost a record or a percentile is off by more than a bucket!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// One arrival request of the fairness benchmark
+struct FairRequest
+{
+    SimTime entry;
+    int airline;        // Index into the airline list
+    bool emergency;
+};
+
+/**
+ * Feeds the requests to a scheduler on a virtual clock, one tick per
+ * simulated second: four runways take 90 s per flight, emergencies first,
+ * and a flight frees its airline's quota when it leaves the runway.
+ * Collects every served flight's queue wait per airline (emergencies in
+ * the last list) and checks no airline ever held more runways than its
+ * quota with regular flights.
+ */
+static void runFairLoad(bool fair, const std::vector<Airline*>& airlines, const std::vector<FairRequest>& requests,
+                        SimTime durationMs, std::vector<std::vector<SimTime>>& waits, bool& quotaKept)
+{
+    const int runwayCount = 4;
+    const SimTime serviceMs = 90000;
+    SimClock::instance().configure(ClockMode::AsFastAsPossible);
+
+    FlightsScheduler scheduler;
+    for (int runway = 0; runway < runwayCount; runway++)
+    {
+        scheduler.getServiceModel().record(runway, AirCraftType::Commercial, true, serviceMs);
+    }
+    scheduler.setFairScheduling(fair);
+    scheduler.setAirlinePolicies(airlines);
+
+    std::deque<Aircraft> fleet;
+    std::vector<Aircraft*> onRunway(runwayCount, nullptr);
+    std::vector<SimTime> freeAt(runwayCount, 0);
+    waits.assign(airlines.size() + 1, std::vector<SimTime>());
+
+    size_t next = 0;
+    for (SimTime now = 0; now <= durationMs; now += 1000)
+    {
+        SimClock::instance().advanceTo(now);
+        while (next < requests.size() && requests[next].entry <= now)
+        {
+            const Airline* airline = airlines[requests[next].airline];
+            fleet.emplace_back(static_cast<int>(next), airline->name, airline->type);
+            fleet.back().EmergencyNo = requests[next].emergency ? 1 : 0;
+            scheduler.addArrival(&fleet.back());
+            next++;
+        }
+
+        std::vector<int> regularOnRunway(airlines.size(), 0);
+        for (int runway = 0; runway < runwayCount; runway++)
+        {
+            if (onRunway[runway] != nullptr && freeAt[runway] <= now)
+            {
+                scheduler.removeFlight(onRunway[runway]);
+                onRunway[runway] = nullptr;
+            }
+            if (onRunway[runway] == nullptr)
+            {
+                Aircraft* aircraft = scheduler.removeNextEmergency();
+                if (aircraft == nullptr) aircraft = scheduler.getNextArrival();
+                if (aircraft == nullptr) continue;
+
+                int airline = requests[aircraft->aircraftIndex].airline;
+                waits[aircraft->EmergencyNo > 0 ? airlines.size() : airline].push_back(now - aircraft->queueEntryTime);
+                onRunway[runway] = aircraft;
+                freeAt[runway] = now + serviceMs;
+            }
+            if (onRunway[runway]->EmergencyNo == 0)
+            {
+                regularOnRunway[requests[onRunway[runway]->aircraftIndex].airline]++;
+            }
+        }
+
+        for (size_t a = 0; a < airlines.size(); a++)
+        {
+            if (fair && regularOnRunway[a] > airlines[a]->maxFlights) quotaKept = false;
+        }
+    }
+}
+
+// p-th percentile of a list of waits in minutes (0 if empty)
+static double waitPercentile(std::vector<SimTime> waits, double p)
+{
+    if (waits.empty()) return 0.0;
+    std::sort(waits.begin(), waits.end());
+    size_t index = static_cast<size_t>(p * (waits.size() - 1));
+    return waits[index] / 60000.0;
+}
+
+/**
+ * One airline (PIA) floods the arrival queue at several times its share
+ * while the rest fly their normal rates, putting the runways 25% over
+ * capacity. Plain priority order makes every airline wait behind the
+ * flood; weighted-fair order should keep the other airlines' waits short
+ * and push the backlog onto the airline that caused it.
+ */
+static int benchFair(const BenchmarkOptions& options)
+{
+    (void)options;
+    const SimTime durationMs = 4 * 3600 * 1000LL;
+    const double normalPerHour = 80.0;      // All airlines together at their fleet shares
+    const double floodPerHour = 120.0;      // Extra PIA requests on top
+
+    AirlineManager manager;
+    manager.initialize(0);      // Weights and quotas only
+    const std::vector<Airline*>& airlines = manager.getAllAirlines();
+    double totalWeight = 0.0;
+    for (const Airline* airline : airlines) totalWeight += airline->weight;
+
+    // Poisson arrivals per airline, merged by entry time
+    std::vector<FairRequest> requests;
+    for (size_t a = 0; a < airlines.size(); a++)
+    {
+        double perHour = normalPerHour * airlines[a]->weight / totalWeight + (a == 0 ? floodPerHour : 0.0);
+        double meanGapMs = 3600000.0 / perHour;
+        unsigned long long key = CounterRandom::keyFor("bench/fair/" + airlines[a]->name, 0);
+        double entry = 0.0;
+        for (unsigned long long i = 0;; i++)
+        {
+            entry += -std::log(1.0 - CounterRandom::unit(key, i * 2)) * meanGapMs;
+            if (entry > durationMs) break;
+            FairRequest request;
+            request.entry = static_cast<SimTime>(entry);
+            request.airline = static_cast<int>(a);
+            request.emergency = CounterRandom::range(key, i * 2 + 1, 0, 99) == 0;
+            requests.push_back(request);
+        }
+    }
+    std::stable_sort(requests.begin(), requests.end(),
+                     [](const FairRequest& a, const FairRequest& b) { return a.entry < b.entry; });
+
+    std::vector<std::vector<SimTime>> priorityWaits, fairWaits;
+    bool quotaKept = true;
+    double priorityMs = bestOf(1, [&]() { runFairLoad(false, airlines, requests, durationMs, priorityWaits, quotaKept); });
+    double fairMs = bestOf(1, [&]() { runFairLoad(true, airlines, requests, durationMs, fairWaits, quotaKept); });
+
+    std::cout << "Fairness benchmark: " << requests.size() << " arrivals over " << durationMs / 3600000
+              << " h, 4 runways x 90 s, PIA +" << floodPerHour << "/h" << std::endl;
+    std::cout << std::left << std::setw(20) << "airline" << std::right << std::setw(8) << "served"
+              << std::setw(20) << "priority p50/p99" << std::setw(20) << "fair p50/p99" << "  (min)" << std::endl;
+
+    bool bounded = true;
+    for (size_t a = 0; a <= airlines.size(); a++)
+    {
+        std::string name = a < airlines.size() ? airlines[a]->name : "(emergencies)";
+        std::cout << std::left << std::setw(20) << name << std::right << std::setw(8) << fairWaits[a].size()
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << waitPercentile(priorityWaits[a], 0.50) << " / " << std::setw(5)
+                  << waitPercentile(priorityWaits[a], 0.99)
+                  << std::setw(12) << waitPercentile(fairWaits[a], 0.50) << " / " << std::setw(5)
+                  << waitPercentile(fairWaits[a], 0.99) << std::endl;
+
+        // Everyone but the flooding airline gets a runway within a few service times
+        if (a > 0 && waitPercentile(fairWaits[a], 0.99) > 10.0) bounded = false;
+    }
+    std::cout << std::setprecision(1) << "Scheduling time: priority " << priorityMs << " ms, fair " << fairMs << " ms"
+              << std::endl;
+
+    if (!bounded || !quotaKept)
+    {
+        std::cerr << (quotaKept ? "An airline's p99 wait grew past 10 minutes under fair scheduling!"
+                                : "An airline held more runways than its quota!") << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Same entries in the same order (key, sequence and aircraft)
+static bool sameEntries(const std::vector<IndexedHeap::Entry>& heapEntries, const std::vector<PersistentQueue::Entry>& queueEntries)
+{
+    if (heapEntries.size() != queueEntries.size()) return false;
+    for (size_t i = 0; i < heapEntries.size(); i++)
+    {
+        if (heapEntries[i].key != queueEntries[i].key || heapEntries[i].sequence != queueEntries[i].sequence ||
+            heapEntries[i].handle != queueEntries[i].handle) return false;
+    }
+    return true;
+}
+
+// One what-if question on a fork: RWY-C takes the next flight, or the first queued cargo departure?
+// Returns the better branch's score
+static SimTime evaluateCargoChoice(const SchedulerState& state, int flexibleRunway, std::vector<PersistentQueue::Entry>& scratch)
+{
+    SchedulerState next = state.fork();
+    next.assignNext(flexibleRunway);
+
+    SchedulerState cargo = state.fork();
+    cargo.getDepartures().topEntries(50, scratch);
+    for (const PersistentQueue::Entry& flight : scratch)
+    {
+        if (flight.type == AirCraftType::Cargo && cargo.assign(flight, flexibleRunway)) break;
+    }
+
+    return std::min(next.score(), cargo.score());
+}
+
+/**
+ * Forks of a scheduler with 10k arrivals and 10k departures queued: the
+ * cost of a fork with persistent queues against copying the heaps, what-if
+ * evaluations per second, and what keeping the persistent copies costs
+ * each enqueue. Checks the persistent copies against the heaps after
+ * pushes, re-keys and removals, and that forks leave the live queues alone.
+ */
+static int benchWhatIf(const BenchmarkOptions& options)
+{
+    (void)options;
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    const size_t perQueue = 10000;
+    const size_t forks = 1000;
+    const size_t evaluations = 1000;
+    unsigned long long key = CounterRandom::keyFor("bench/whatif", 0);
+
+    std::deque<Aircraft> fleet;
+    for (size_t i = 0; i < perQueue * 2; i++)
+    {
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 6],
+                           static_cast<AirCraftType>(CounterRandom::range(key, i * 2, 0, 4)));
+        fleet.back().EmergencyNo = (CounterRandom::range(key, i * 2 + 1, 0, 199) == 0) ? 1 : 0;
+    }
+
+    // Queue everything twice, with and without the persistent copies, on a virtual clock
+    double queueMs[2];
+    FlightsScheduler plain, persistent;
+    persistent.setPersistentQueues(true);
+    FlightsScheduler* schedulers[2] = {&plain, &persistent};
+    std::deque<Aircraft> plainFleet(fleet);
+    for (int s = 0; s < 2; s++)
+    {
+        std::deque<Aircraft>& aircraft = s == 0 ? plainFleet : fleet;
+        SimClock::instance().configure(ClockMode::AsFastAsPossible);
+        queueMs[s] = bestOf(1, [&]() {
+            for (size_t i = 0; i < aircraft.size(); i++)
+            {
+                SimClock::instance().advanceTo(static_cast<SimTime>(i) * 100);
+                if (i % 2 == 0) schedulers[s]->addArrival(&aircraft[i]);
+                else schedulers[s]->addDeparture(&aircraft[i]);
+            }
+        });
+    }
+
+    // Emergencies declared and flights leaving, so the copies have re-keys and removals to follow
+    bool valid = true;
+    for (size_t i = 0; i < fleet.size(); i += 97)
+    {
+        fleet[i].EmergencyNo = 2;
+        persistent.updatePriority(&fleet[i]);
+    }
+    for (size_t i = 5; i < fleet.size(); i += 89)
+    {
+        persistent.removeFlight(&fleet[i]);
+    }
+    std::vector<IndexedHeap::Entry> heapEntries;
+    std::vector<PersistentQueue::Entry> queueEntries;
+    persistent.getArrivalQueue().topEntries(persistent.getArrivalQueue().size(), heapEntries);
+    persistent.getArrivalQueue().snapshot().topEntries(persistent.getArrivalQueue().size(), queueEntries);
+    valid = valid && sameEntries(heapEntries, queueEntries);
+    persistent.getDepartureQueue().topEntries(persistent.getDepartureQueue().size(), heapEntries);
+    persistent.getDepartureQueue().snapshot().topEntries(persistent.getDepartureQueue().size(), queueEntries);
+    valid = valid && sameEntries(heapEntries, queueEntries);
+
+    RunwayClass rwyA("RWY-A", RunwayType::Arrival, false);
+    RunwayClass rwyB("RWY-B", RunwayType::Departure, true);
+    RunwayClass rwyC("RWY-C", RunwayType::Flexible, false);
+    rwyA.index = 0;
+    rwyB.index = 1;
+    rwyC.index = 2;
+    std::vector<RunwayClass*> runways = {&rwyA, &rwyB, &rwyC};
+
+    // A fork against copying both heaps (what a snapshot costs without shared structure)
+    size_t queued = persistent.getArrivalQueue().size() + persistent.getDepartureQueue().size();
+    SimTime checksum = 0;
+    double copyMs = bestOf(3, [&]() {
+        for (size_t i = 0; i < forks / 10; i++)
+        {
+            IndexedHeap arrivals = persistent.getArrivalQueue();
+            IndexedHeap departures = persistent.getDepartureQueue();
+            checksum += static_cast<SimTime>(arrivals.size() + departures.size());
+        }
+    });
+    double forkMs = bestOf(3, [&]() {
+        for (size_t i = 0; i < forks; i++)
+        {
+            SchedulerState state = persistent.fork(runways);
+            checksum += static_cast<SimTime>(state.getArrivals().size());
+        }
+    });
+
+    std::cout << "What-if benchmark: " << queued << " queued flights, 3 runways" << std::endl;
+    std::cout << std::left << std::setw(22) << "" << std::right
+              << std::setw(13) << "copy" << std::setw(13) << "persistent" << std::setw(12) << "speedup" << std::endl;
+    printComparison("  snapshot", perOperation(copyMs, forks / 10), perOperation(forkMs, forks), " us");
+
+    // Whole what-if questions, each two branches scored 100 flights ahead
+    SchedulerState root = persistent.fork(runways);
+    std::vector<PersistentQueue::Entry> scratch;
+    SimTime best = 0;
+    double evaluateMs = bestOf(3, [&]() {
+        for (size_t i = 0; i < evaluations; i++)
+        {
+            best = evaluateCargoChoice(root, rwyC.index, scratch);
+        }
+    });
+    std::cout << std::fixed << std::setprecision(0) << "  what-if evaluations: "
+              << (evaluateMs > 0 ? evaluations * 1000.0 / evaluateMs : 0.0) << "/s (" << std::setprecision(1)
+              << perOperation(evaluateMs, evaluations) << " us each)" << std::endl;
+    std::cout << "  enqueue: " << std::setprecision(2) << perOperation(queueMs[0], fleet.size()) << " us, with persistent copies "
+              << perOperation(queueMs[1], fleet.size()) << " us" << std::endl;
+
+    // The same question on a fork built by copying the queues must come out the same,
+    // and none of the forks may have touched the live queues
+    persistent.setPersistentQueues(false);
+    valid = valid && evaluateCargoChoice(persistent.fork(runways), rwyC.index, scratch) == best;
+    valid = valid && persistent.getArrivalQueue().size() + persistent.getDepartureQueue().size() == queued;
+    valid = valid && checksum > 0;
+
+    if (!valid)
+    {
+        std::cerr << "Persistent queues drifted from the heaps or a fork changed the scheduler!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * ATC assignment rounds on an airport of 'runwayCount' runways, with both
+ * queues deep enough to fill every runway every round. Each round frees
+ * all runways first, so it makes one assignment per runway. Without the
+ * arrival plan only the matching pass is timed. Checks that no round left
+ * a runway idle and no flight got a runway lacking a capability it needs.
+ * Returns the total milliseconds spent in assignRunway().
+ */
+static double timeAssignRounds(int runwayCount, int rounds, bool planned, long long& assignments, bool& valid)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    SimClock::instance().configure(ClockMode::AsFastAsPossible);
+    RunwayManager runwayManager;
+    runwayManager.initialize(runwayCount);
+    ATCScontroller controller;
+    controller.setVerbose(false);
+    controller.setRunwayManager(&runwayManager);
+    FlightsScheduler& scheduler = *controller.getScheduler();
+    if (!planned) scheduler.setArrivalRunways(std::vector<RunwayClass*>());
+
+    // Enough of each flow to fill every runway every round, plus some cargo and emergencies
+    size_t flights = static_cast<size_t>(rounds) * runwayCount * 2 + 1000;
+    unsigned long long key = CounterRandom::keyFor("bench/assign", runwayCount);
+    std::deque<Aircraft> fleet;
+    for (size_t i = 0; i < flights; i++)
+    {
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 6],
+                           static_cast<AirCraftType>(CounterRandom::range(key, i * 2, 0, 4)));
+        Aircraft& aircraft = fleet.back();
+        aircraft.EmergencyNo = (CounterRandom::range(key, i * 2 + 1, 0, 99) == 0) ? 1 : 0;
+        aircraft.direction = static_cast<Direction>(i % 4);
+        if (i % 4 < 2) scheduler.addArrival(&aircraft);
+        else scheduler.addDeparture(&aircraft);
+    }
+
+    double totalMs = 0.0;
+    assignments = 0;
+    std::vector<IndexedHeap::Entry> passedOver;
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < runwayCount; i++)
+        {
+            RunwayClass* runway = runwayManager.getRunwayByIndex(i);
+            runway->release(runway->getLease());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        controller.assignRunway();
+        auto end = std::chrono::steady_clock::now();
+        totalMs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+
+        int occupied = 0;
+        std::vector<RunwayClass*> idle;
+        for (int i = 0; i < runwayCount; i++)
+        {
+            RunwayClass* runway = runwayManager.getRunwayByIndex(i);
+            if (runway->isOccupied()) occupied++;
+            else idle.push_back(runway);
+        }
+        assignments += occupied;
+
+        // A runway may only stay idle when nothing near either queue's head can use it
+        // (a run of cargo there, say, waiting for the cargo runways)
+        if (!idle.empty())
+        {
+            FlightsScheduler::CandidateFilter fitsIdle = [&idle](const Aircraft& aircraft) {
+                for (RunwayClass* runway : idle)
+                {
+                    if (runway->canServe(aircraft)) return true;
+                }
+                return false;
+            };
+            valid = valid && scheduler.peekArrivals(ATCScontroller::candidateWindow, fitsIdle, passedOver, 1) == 0 &&
+                    scheduler.peekDepartures(ATCScontroller::candidateWindow, fitsIdle, passedOver, 1) == 0;
+        }
+    }
+
+    for (const Aircraft& aircraft : fleet)
+    {
+        if (aircraft.assignedRunway < 0) continue;
+        valid = valid && runwayManager.getRunwayByIndex(aircraft.assignedRunway)->canServe(aircraft);
+    }
+    return totalMs;
+}
+
+// The runway one flight gets when it is alone in its queue and RWY-A, B and C are all free
+static std::string runwayGivenTo(AirCraftType type, Direction direction, int emergencyLevel)
+{
+    SimClock::instance().configure(ClockMode::AsFastAsPossible);
+    RunwayManager runwayManager;
+    runwayManager.initialize(3);
+    ATCScontroller controller;
+    controller.setVerbose(false);
+    controller.setRunwayManager(&runwayManager);
+
+    Aircraft aircraft(0, "FedEx", type);
+    aircraft.direction = direction;
+    aircraft.EmergencyNo = emergencyLevel;
+    if (direction == Direction::North || direction == Direction::South) controller.getScheduler()->addArrival(&aircraft);
+    else controller.getScheduler()->addDeparture(&aircraft);
+    controller.assignRunway();
+
+    RunwayClass* runway = runwayManager.getRunwayByIndex(aircraft.assignedRunway);
+    return runway ? runway->id : "none";
+}
+
+/**
+ * Assignment rounds on airports of 3 to 48 runways. A round re-plans the
+ * arrivals (a fixed 500-flight horizon) and then matches the queue heads
+ * to the free runways; the matching costs the same per assignment
+ * whatever the runway count.
+ */
+static int benchAssign(const BenchmarkOptions& options)
+{
+    (void)options;
+    const int runwayCounts[] = {3, 6, 12, 24, 48};
+    const int rounds = 200;
+
+    std::cout << "Assignment benchmark: " << rounds << " ATC rounds per airport, every runway freed each round" << std::endl;
+    std::cout << std::left << std::setw(10) << "runways" << std::right << std::setw(18) << "round with plan"
+              << std::setw(16) << "matching only" << std::setw(16) << "per assignment" << std::setw(16) << "assignments/s"
+              << std::endl;
+
+    bool valid = true;
+    for (int runwayCount : runwayCounts)
+    {
+        long long plannedAssignments, assignments;
+        double plannedMs = timeAssignRounds(runwayCount, rounds, true, plannedAssignments, valid);
+        double matchingMs = timeAssignRounds(runwayCount, rounds, false, assignments, valid);
+
+        std::cout << std::left << std::setw(10) << runwayCount << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(15) << perOperation(plannedMs, rounds) << " us"
+                  << std::setw(13) << perOperation(matchingMs, rounds) << " us"
+                  << std::setw(13) << perOperation(matchingMs, static_cast<size_t>(assignments)) << " us"
+                  << std::setw(16) << std::setprecision(0) << (matchingMs > 0 ? assignments * 1000.0 / matchingMs : 0.0)
+                  << std::endl;
+    }
+
+    // RWY-C is the cargo runway even when the others are free too; emergencies may use any runway
+    std::string cargoArrival = runwayGivenTo(AirCraftType::Cargo, Direction::North, 0);
+    std::string cargoDeparture = runwayGivenTo(AirCraftType::Cargo, Direction::East, 0);
+    std::string arrival = runwayGivenTo(AirCraftType::Commercial, Direction::South, 0);
+    std::string departure = runwayGivenTo(AirCraftType::Commercial, Direction::West, 0);
+    std::string cargoEmergency = runwayGivenTo(AirCraftType::Cargo, Direction::North, 2);
+    bool cargoOnC = cargoArrival == "RWY-C" && cargoDeparture == "RWY-C" && arrival == "RWY-A" &&
+                    departure == "RWY-B" && cargoEmergency == "RWY-A";
+    std::cout << "  All three free: cargo arrival " << cargoArrival << ", cargo departure " << cargoDeparture
+              << ", arrival " << arrival << ", departure " << departure << ", cargo emergency " << cargoEmergency << std::endl;
+
+    if (!valid || !cargoOnC)
+    {
+        std::cerr << "A round left a runway idle, gave a flight a runway it can't use, or cargo missed RWY-C!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Departures for the claim benchmark: same priority, a third of them heading north
+static void queueDepartures(size_t count, std::deque<Aircraft>& fleet, FlightsScheduler& scheduler)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "Pakistan Airforce", "AghaKhan Air"};
+    unsigned long long key = CounterRandom::keyFor("bench/claim", 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        fleet.emplace_back(static_cast<int>(i), airlines[i % 4], AirCraftType::Commercial);
+        fleet.back().direction = (CounterRandom::range(key, i, 0, 2) == 0) ? Direction::North : Direction::East;
+        scheduler.addDeparture(&fleet.back());
+    }
+}
+
+/**
+ * Two runways take turns picking a departure, 'decisions' picks in all:
+ * one takes any flight, the other can't take the northbound ones. The old
+ * way pops flights until one fits and queues the rest again (new entry
+ * time, so they fall behind the flights queued after them); peek-and-claim
+ * looks at the first candidateWindow flights and takes the one that fits.
+ * 'resets' counts flights whose entry time changed, 'ordered' whether the
+ * runway that takes any flight still got them in the order they queued.
+ */
+static double timeDecisions(bool claim, size_t queued, size_t decisions, size_t& decided, size_t& resets, bool& ordered)
+{
+    SimClock::instance().configure(ClockMode::AsFastAsPossible);
+    FlightsScheduler scheduler;
+    std::deque<Aircraft> fleet;
+    queueDepartures(queued, fleet, scheduler);
+    SimClock::instance().advanceTo(60000);      // A minute later, so a new entry time shows
+
+    FlightsScheduler::CandidateFilter notNorth = [](const Aircraft& aircraft) {
+        return aircraft.direction != Direction::North;
+    };
+    std::vector<IndexedHeap::Entry> candidates;
+    std::vector<Aircraft*> passedOver;
+    int lastTaken = -1;
+    decided = 0;
+    ordered = true;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < decisions; i++)
+    {
+        bool restricted = (i % 2) == 1;
+        Aircraft* chosen = nullptr;
+        if (!restricted)
+        {
+            chosen = scheduler.getNextDeparture();
+        }
+        else if (claim)
+        {
+            if (scheduler.peekDepartures(ATCScontroller::candidateWindow, notNorth, candidates, 1) > 0 &&
+                scheduler.claim(candidates.front()))
+            {
+                chosen = candidates.front().aircraft;
+            }
+        }
+        else
+        {
+            passedOver.clear();
+            while ((chosen = scheduler.getNextDeparture()) != nullptr && !notNorth(*chosen))
+            {
+                passedOver.push_back(chosen);
+            }
+            for (Aircraft* aircraft : passedOver)
+            {
+                scheduler.addDeparture(aircraft);
+            }
+        }
+        if (chosen == nullptr) break;
+
+        // Everything has the same priority, so the runway taking any flight takes them in queue order
+        if (!restricted)
+        {
+            ordered = ordered && chosen->aircraftIndex > lastTaken;
+            lastTaken = chosen->aircraftIndex;
+        }
+        decided++;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    resets = 0;
+    for (const Aircraft& aircraft : fleet)
+    {
+        if (aircraft.queueEntryTime != 0) resets++;
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
+static int benchClaim(const BenchmarkOptions& options)
+{
+    (void)options;
+    const size_t queueSizes[] = {10000, 100000, 1000000};
+    const size_t decisions = 1000;
+
+    std::cout << "Claim benchmark: " << decisions << " departure picks, every other one by a runway that can't take"
+              << " the northbound third" << std::endl;
+    std::cout << std::left << std::setw(22) << "queued" << std::right << std::setw(13) << "pop/requeue"
+              << std::setw(13) << "peek/claim" << std::setw(12) << "speedup" << std::setw(16) << "re-stamped" << std::endl;
+
+    bool valid = true;
+    for (size_t queued : queueSizes)
+    {
+        size_t oldDecided, newDecided, oldResets, newResets;
+        bool oldOrdered, newOrdered;
+        double oldMs = timeDecisions(false, queued, decisions, oldDecided, oldResets, oldOrdered);
+        double newMs = timeDecisions(true, queued, decisions, newDecided, newResets, newOrdered);
+        double oldNs = perOperation(oldMs, oldDecided) * 1000.0;
+        double newNs = perOperation(newMs, newDecided) * 1000.0;
+        std::cout << std::left << std::setw(22) << ("  " + std::to_string(queued)) << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(10) << oldNs << " ns" << std::setw(10) << newNs << " ns"
+                  << std::setw(11) << (newNs > 0 ? oldNs / newNs : 0.0) << "x"
+                  << std::setw(8) << oldResets << " vs " << newResets << (oldOrdered ? "" : "  (order lost)") << std::endl;
+
+        valid = valid && newDecided == decisions && oldDecided == decisions && newOrdered && newResets == 0;
+    }
+    std::cout << "  re-stamped = flights whose queue entry time was reset (FCFS aging lost)" << std::endl;
+    SimClock::instance().configure(ClockMode::AsFastAsPossible);
+
+    if (!valid)
+    {
+        std::cerr << "Peek-and-claim missed a pick, took one out of order or touched a flight it passed over!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// A runway as it was before leases: an occupied flag and its owner behind a lock
+struct LockedRunway
+{
+    std::mutex lock;
+    bool occupied = false;
+    AircraftHandle owner = invalidAircraftHandle;
+};
+
+// Wall time for 'threads' threads to take and give back a runway 'turns' times each, cycling
+// through the runways. 'overlaps' counts a runway found held by two threads at once.
+static double timeRunwayTurns(std::vector<RunwayClass>& runways, size_t turns, int threads, bool leased,
+                              std::atomic<long long>& taken, std::atomic<long long>& overlaps)
+{
+    std::vector<LockedRunway> locked(runways.size());
+    std::vector<std::atomic<int>> holders(runways.size());
+    for (std::atomic<int>& holder : holders) holder.store(0);
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]() {
+            AircraftHandle owner = static_cast<AircraftHandle>(t);
+            long long mine = 0;
+            for (size_t i = 0; i < turns; i++)
+            {
+                size_t r = (i + t) % runways.size();
+                RunwayLease lease = noRunwayLease;
+                if (leased)
+                {
+                    lease = runways[r].acquire(owner, 0, RunwayClass::defaultLeaseMs);
+                    if (lease == noRunwayLease) continue;
+                }
+                else
+                {
+                    std::lock_guard<std::mutex> guard(locked[r].lock);
+                    if (locked[r].occupied) continue;
+                    locked[r].occupied = true;
+                    locked[r].owner = owner;
+                }
+
+                if (holders[r].fetch_add(1) != 0) overlaps++;
+                holders[r].fetch_sub(1);
+                mine++;
+
+                if (leased)
+                {
+                    if (!runways[r].release(lease)) overlaps++;
+                }
+                else
+                {
+                    std::lock_guard<std::mutex> guard(locked[r].lock);
+                    if (locked[r].owner != owner) overlaps++;
+                    locked[r].occupied = false;
+                }
+            }
+            taken += mine;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+}
+
+/**
+ * Runway turnover: flights taking and giving back runways from many
+ * threads, a CAS lease against a lock per runway. Also checks that a
+ * lease runs out, and that the flight that lost it can't free the runway
+ * of the flight that has it now.
+ */
+static int benchLease(const BenchmarkOptions& options)
+{
+    (void)options;
+    const size_t turns = 500000;
+    const int threadCounts[] = {1, 2, 4, 8};
+    const int runwayCount = 8;
+
+    std::cout << "Lease benchmark: nanoseconds per runway turn (take + give back), " << turns << " tries per thread on "
+              << runwayCount << " runways, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(22) << "flight threads" << std::right
+              << std::setw(13) << "mutex" << std::setw(13) << "lease CAS" << std::setw(12) << "speedup"
+              << std::setw(16) << "turns/s" << std::endl;
+
+    bool valid = true;
+    for (int threads : threadCounts)
+    {
+        std::vector<RunwayClass> runways(runwayCount);
+        std::atomic<long long> lockedTurns(0), leasedTurns(0), overlaps(0);
+        double lockedMs = timeRunwayTurns(runways, turns, threads, false, lockedTurns, overlaps);
+        double leasedMs = timeRunwayTurns(runways, turns, threads, true, leasedTurns, overlaps);
+        double lockedNs = perOperation(lockedMs, lockedTurns.load()) * 1000.0;
+        double leasedNs = perOperation(leasedMs, leasedTurns.load()) * 1000.0;
+        std::cout << std::left << std::setw(22) << ("  " + std::to_string(threads) + (threads == 1 ? " thread" : " threads"))
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << lockedNs << " ns" << std::setw(10) << leasedNs << " ns"
+                  << std::setw(11) << (leasedNs > 0 ? lockedNs / leasedNs : 0.0) << "x"
+                  << std::setw(16) << std::setprecision(0) << (leasedMs > 0 ? leasedTurns.load() * 1000.0 / leasedMs : 0.0)
+                  << std::endl;
+
+        valid = valid && overlaps.load() == 0 && leasedTurns.load() > 0;
+        for (const RunwayClass& runway : runways)
+        {
+            valid = valid && !runway.isOccupied(0);
+        }
+    }
+
+    // A lease that runs out: the runway goes to the next flight, and the first one can't free it
+    RunwayClass runway("RWY-A", RunwayType::Arrival, false);
+    RunwayLease first = runway.acquire(1, 0, 10000);
+    bool expiryWorks = first != noRunwayLease && RunwayClass::ownerOf(first) == 1 &&
+                       runway.acquire(2, 5000, 10000) == noRunwayLease;
+    RunwayLease second = runway.acquire(2, 10000, 10000);
+    expiryWorks = expiryWorks && second != noRunwayLease && RunwayClass::ownerOf(second) == 2 &&
+                  !runway.release(first) && runway.isOccupied(15000) && runway.release(second) &&
+                  !runway.isOccupied(15000);
+    std::cout << "  Expired lease taken over, stale release refused: " << (expiryWorks ? "yes" : "NO") << std::endl;
+
+    if (!valid || !expiryWorks)
+    {
+        std::cerr << "Two flights held one runway, or a lease didn't expire or release as it should!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Reaction times of a controller thread to 'signals' runway-freed signals spaced 'gapUs' apart,
+// blocked on the signal or polling it every 'pollUs'
+static LogHistogram::Snapshot timeReactions(int signals, int gapUs, bool blocking, int pollUs, unsigned long long& rounds)
+{
+    RunwayManager runwayManager;
+    runwayManager.initialize(3);
+    ATCScontroller controller;
+    controller.setVerbose(false);
+    controller.setRunwayManager(&runwayManager);
+
+    std::atomic<bool> running(true);
+    std::thread atc([&]() {
+        if (blocking)
+        {
+            controller.runEventLoop(running);
+            return;
+        }
+        while (running.load())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(pollUs));
+            controller.handleSignals();
+        }
+    });
+
+    for (int i = 0; i < signals; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(gapUs));
+        controller.notifyRunwayFreed();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    running = false;
+    atc.join();
+    controller.handleSignals();     // A signal the loop missed would count as a slow round here
+
+    LogHistogram::Snapshot times = controller.getReactionTimes();
+    rounds = times.count;
+    return times;
+}
+
+/**
+ * How fast the ATC gets to a freed runway: a controller thread blocked on
+ * its ControllerSignal against one that polls on a timer (the engine's
+ * old loop polled once per simulated second; 1 ms here keeps the run
+ * short and still shows the gap).
+ */
+static int benchReact(const BenchmarkOptions& options)
+{
+    (void)options;
+    const int signals = 2000;
+    const int gapUs = 200;
+    const int pollUs = 1000;
+
+    std::cout << "Reaction benchmark: " << signals << " runway-freed signals " << gapUs << " us apart, "
+              << "wall time from signal to assignment round, " << std::thread::hardware_concurrency()
+              << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(22) << "controller" << std::right << std::setw(10) << "rounds"
+              << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << std::endl;
+
+    bool valid = true;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        bool blocking = (mode == 1);
+        unsigned long long rounds;
+        LogHistogram::Snapshot times = timeReactions(signals, gapUs, blocking, pollUs, rounds);
+        std::cout << std::left << std::setw(22) << (blocking ? "  blocked on signal" : "  polling every 1 ms")
+                  << std::right << std::setw(10) << rounds << std::fixed << std::setprecision(1)
+                  << std::setw(9) << times.percentile(0.5) / 1000.0 << " us"
+                  << std::setw(9) << times.percentile(0.9) / 1000.0 << " us"
+                  << std::setw(9) << times.percentile(0.99) / 1000.0 << " us"
+                  << std::setw(9) << times.max / 1000.0 << " us" << std::endl;
+
+        // Every signal is handled, and a blocked controller handles them one round each
+        valid = valid && rounds > 0 && rounds <= static_cast<unsigned long long>(signals);
+        if (blocking) valid = valid && times.percentile(0.5) < static_cast<unsigned long long>(gapUs) * 1000;
+    }
+
+    if (!valid)
+    {
+        std::cerr << "A signal went unhandled, or the blocked controller was slower than the signal gap!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// What one network run did
+struct NetworkRun
+{
+    double wallMs;
+    unsigned long long departures, arrivals, timeouts, handoffs, windows;
+    SimTime simulatedTime;
+    bool drained;       // No airport left with a flight when run() returned
+};
+
+// 'perAirport' aircraft at each of 'airports' airports, entering over ten minutes, 'legs' legs each
+static NetworkRun timeNetwork(int airports, int perAirport, int legs, bool pinCores)
+{
+    static const char* airlines[] = {"PIA", "AirBlue", "FedEx", "Pakistan Airforce", "Blue Dart", "AghaKhan Air"};
+    static const AirCraftType types[] = {AirCraftType::Commercial, AirCraftType::Commercial, AirCraftType::Cargo,
+                                         AirCraftType::Military, AirCraftType::Cargo, AirCraftType::Medical};
+    AirportNetwork network;
+    network.initialize(airports, 3, 150.0, pinCores);
+
+    std::deque<Aircraft> fleet;
+    for (int i = 0; i < airports * perAirport; i++)
+    {
+        fleet.emplace_back(i / 6, airlines[i % 6], types[i % 6]);
+        unsigned long long key = CounterRandom::keyFor("bench/network", i);
+        network.addFlight(&fleet.back(), i % airports, static_cast<SimTime>(CounterRandom::unit(key, 0) * 600000.0), legs);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    network.start();
+    network.run();
+    auto end = std::chrono::steady_clock::now();
+    network.stop();
+
+    NetworkRun result = {};
+    result.wallMs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+    result.drained = true;
+    for (int i = 0; i < airports; i++)
+    {
+        const AirportNetwork::Airport& airport = network.getAirport(i);
+        result.departures += airport.departures;
+        result.arrivals += airport.arrivals;
+        result.timeouts += airport.timeouts;
+        result.drained = result.drained && airport.engine->getActiveFlightCount() == 0;
+    }
+    result.handoffs = network.getHandoffCount();
+    result.windows = network.getWindowCount();
+    result.simulatedTime = network.getSimulatedTime();
+    return result;
+}
+
+/**
+ * A growing network with the same traffic per airport. The work per airport
+ * is fixed, so with one core per shard the wall time should stay flat and
+ * flights per wall second grow with the shards; 'efficiency' is that growth
+ * against the cores the shards actually have.
+ */
+static int benchNetwork(const BenchmarkOptions& options)
+{
+    (void)options;
+    const int airportCounts[] = {2, 4, 8, 16, 32, 48};
+    const int perAirport = 200;
+    const int legs = 3;
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "Network benchmark: " << perAirport << " aircraft per airport, " << legs << " legs each, one shard per airport, "
+              << cores << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(12) << "airports" << std::right << std::setw(10) << "flights"
+              << std::setw(10) << "windows" << std::setw(13) << "wall" << std::setw(16) << "flights/s"
+              << std::setw(13) << "efficiency" << std::endl;
+
+    bool valid = true;
+    double baseRate = 0.0;
+    int baseCores = 1;
+    for (int airports : airportCounts)
+    {
+        NetworkRun run = timeNetwork(airports, perAirport, legs, true);
+        unsigned long long flights = run.departures + run.arrivals;
+        double rate = run.wallMs > 0 ? flights * 1000.0 / run.wallMs : 0.0;
+        int usedCores = std::min(airports, cores);
+        if (baseRate == 0.0)
+        {
+            baseRate = rate;
+            baseCores = usedCores;
+        }
+        double efficiency = baseRate > 0 ? (rate / baseRate) / (static_cast<double>(usedCores) / baseCores) : 0.0;
+
+        std::cout << std::left << std::setw(12) << ("  " + std::to_string(airports)) << std::right
+                  << std::setw(10) << flights << std::setw(10) << run.windows << std::fixed << std::setprecision(1)
+                  << std::setw(10) << run.wallMs << " ms" << std::setw(16) << std::setprecision(0) << rate
+                  << std::setw(12) << std::setprecision(0) << efficiency * 100.0 << "%" << std::endl;
+
+        // Every departure reached another airport, and nothing was left flying
+        valid = valid && run.drained && run.handoffs == run.departures && run.departures > 0;
+    }
+
+    // Same traffic, pinned or not, gives the same run
+    NetworkRun pinned = timeNetwork(8, perAirport, legs, true);
+    NetworkRun unpinned = timeNetwork(8, perAirport, legs, false);
+    bool repeatable = pinned.departures == unpinned.departures && pinned.arrivals == unpinned.arrivals &&
+                      pinned.timeouts == unpinned.timeouts && pinned.simulatedTime == unpinned.simulatedTime;
+    std::cout << "  8 airports pinned vs unpinned: " << (repeatable ? "same" : "DIFFERENT") << " flights and end time" << std::endl;
+
+    if (!valid || !repeatable)
+    {
+        std::cerr << "A handoff went missing, a flight was left in the air or the run depended on the threads!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// What one single-airport run came to - everything but the wall-clock numbers
+struct AirportRun
+{
+    int completed, timedOut;
+    SimTime completionTime;
+    std::vector<SimTime> runwayWaits;   // In the order the flights finished
+    std::vector<SimTime> flightTimes;
+
+    bool operator==(const AirportRun& other) const
+    {
+        return completed == other.completed && timedOut == other.timedOut && completionTime == other.completionTime &&
+               runwayWaits == other.runwayWaits && flightTimes == other.flightTimes;
+    }
+};
+
+// The headless engine's fixed-fleet run on its own clock, entries spread over five minutes
+static AirportRun runAirport(int aircraftCount, int workers, int stepWorkers, bool atcTick)
+{
+    SimClock clock(ClockMode::AsFastAsPossible);
+    SimClock::bindThread(&clock);
+
+    AirlineManager airlineManager;
+    RunwayManager runwayManager;
+    ATCScontroller atcController;
+    airlineManager.initialize(aircraftCount);
+    runwayManager.initialize(3);
+    atcController.setRunwayManager(&runwayManager);
+    atcController.setVerbose(false);
+
+    SimulationEngine engine(&atcController, &runwayManager, &clock);
+    engine.setStepInterval(1000, stepWorkers);
+    for (Airline* airline : airlineManager.getAllAirlines())
+    {
+        for (Aircraft& aircraft : airline->aircrafts)
+        {
+            unsigned long long key = CounterRandom::keyFor("entry/" + airline->name, aircraft.aircraftIndex);
+            engine.addFlight(&aircraft, static_cast<SimTime>(CounterRandom::unit(key, 0) * 300000.0));
+        }
+    }
+
+    int tick = 0;
+    if (atcTick)
+    {
+        engine.addPeriodicTask(1000, [&]() {
+            atcController.monitorFlight();
+            tick++;
+            return tick < 300 || engine.getActiveFlightCount() > 0;
+        });
+    }
+    else
+    {
+        engine.setControllerEvents(true);
+    }
+
+    engine.start(workers);
+    engine.waitForCompletion();
+    engine.stop();
+    SimClock::bindThread(nullptr);
+
+    AirportRun run;
+    run.completed = engine.getCompletedFlightCount();
+    run.timedOut = engine.getTimedOutFlightCount();
+    run.completionTime = engine.getCompletionTime();
+    run.runwayWaits = engine.getRunwayWaitTimes();
+    run.flightTimes = engine.getFlightTimes();
+    return run;
+}
+
+/**
+ * The same seeded run with 1-4 event workers and step workers, each twice,
+ * with ATC rounds on signals and on the one-second tick. Every run has to
+ * finish the same flights at the same times as the single-threaded one.
+ */
+static int benchRepeat(const BenchmarkOptions& options)
+{
+    const int threadCounts[] = {1, 2, 4};
+    int aircraftCount = std::max(options.aircraftCount, 2000);
+
+    std::cout << "Repeatability: " << aircraftCount << " aircraft, seed " << options.seed
+              << ", same run for every worker count" << std::endl;
+    std::cout << std::left << std::setw(12) << "atc" << std::right << std::setw(10) << "workers"
+              << std::setw(10) << "steps" << std::setw(12) << "completed" << std::setw(12) << "timed out"
+              << std::setw(12) << "end (s)" << std::setw(12) << "result" << std::endl;
+
+    bool repeatable = true;
+    for (bool atcTick : {false, true})
+    {
+        AirportRun reference = runAirport(aircraftCount, 1, 1, atcTick);
+        for (int workers : threadCounts)
+        {
+            for (int stepWorkers : threadCounts)
+            {
+                for (int attempt = 0; attempt < 2; attempt++)
+                {
+                    AirportRun run = runAirport(aircraftCount, workers, stepWorkers, atcTick);
+                    bool same = run == reference;
+                    repeatable = repeatable && same;
+                    if (attempt > 0 && same) continue;
+
+                    std::cout << std::left << std::setw(12) << (atcTick ? "  tick" : "  signals") << std::right
+                              << std::setw(10) << workers << std::setw(10) << stepWorkers << std::setw(12) << run.completed
+                              << std::setw(12) << run.timedOut << std::setw(12) << std::fixed << std::setprecision(2)
+                              << run.completionTime / 1000.0 << std::setw(12) << (same ? "same" : "DIFFERENT") << std::endl;
+                }
+            }
+        }
+    }
+
+    if (!repeatable)
+    {
+        std::cerr << "A run depended on how many threads ran it!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Every benchmark with its name and one-line description
+struct Benchmark
+{
+    const char* name;
+    const char* description;
+    int (*run)(const BenchmarkOptions&);
+};
+
+static const Benchmark benchmarks[] = {
+    {"scan", "Aircraft* sweeps vs AircraftTable column sweeps (--aircraft N)", benchScan},
+    {"queue", "Sorted vector vs ranked IndexedHeap scheduler queue at 10k and 100k flights", benchQueue},
+    {"intake", "Locked queue inserts vs lock-free intake rings with 1-8 producer threads", benchIntake},
+    {"plan", "Arrival planner plan/re-plan time and delay vs queue order for 100-1000 arrivals", benchPlan},
+    {"telemetry", "Queue telemetry updates behind a mutex vs lock-free with 1-8 threads", benchTelemetry},
+    {"fair", "Per-airline arrival waits with one airline flooding the queue, priority vs weighted-fair order", benchFair},
+    {"whatif", "Scheduler forks with persistent queues vs copying the heaps, and what-if evaluations per second", benchWhatIf},
+    {"assign", "ATC runway assignment rounds on 3-48 runways, time per assignment", benchAssign},
+    {"lease", "Runway turnover from 1-8 threads, lock per runway vs CAS leases, and lease expiry", benchLease},
+    {"react", "ATC reaction time to a freed runway, polling controller vs blocked on its signal", benchReact},
+    {"claim", "Best departure a runway fits, pop/requeue vs peek-and-claim at 10k-1M queued", benchClaim},
+    {"network", "Airport network of 2-48 shards with the same traffic each, flights per wall second", benchNetwork},
+    {"repeat", "Same seeded airport run with 1-4 event and step workers, checks every result matches", benchRepeat}
+};
+
+std::string benchmarkNames()
+{
+    std::string names;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        names += std::string("    ") + benchmark.name + " - " + benchmark.description + "\n";
+    }
+    return names;
+}
+
+int runBenchmark(const std::string& name, const BenchmarkOptions& options)
+{
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (name == benchmark.name)
+        {
+            return benchmark.run(options);
+        }
+    }
+
+    std::cerr << "Unknown benchmark: " << name << "\nAvailable:\n" << benchmarkNames();
+    return 1;
+}
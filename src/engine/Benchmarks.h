@@ -0,0 +1,24 @@
+#ifndef AIRCONTROLX_ENGINE_BENCHMARKS_H
+#define AIRCONTROLX_ENGINE_BENCHMARKS_H
+
+#include <string>
+
+/**
+ * Micro-benchmarks of the core data structures, run with
+ * aircontrolx-engine --bench NAME. Each one prints its own report.
+ */
+
+// Settings shared by every benchmark
+struct BenchmarkOptions
+{
+    int aircraftCount;      // Problem size
+    unsigned int seed;      // Seed for the generated data
+};
+
+// Names accepted by runBenchmark(), for the usage text
+std::string benchmarkNames();
+
+// Run one benchmark - returns the process exit code (1 = unknown name)
+int runBenchmark(const std::string& name, const BenchmarkOptions& options);
+
+#endif // AIRCONTROLX_ENGINE_BENCHMARKS_H
@@ -0,0 +1,463 @@
+#include "../../include/SimulationEngine.h"
+#include "../../include/AirlineManager.h"
+#include "../../include/RunwayManager.h"
+#include "../../include/ATCScontroller.h"
+#include "../../include/SimClock.h"
+#include "../../include/TrafficGenerator.h"
+#include "../../include/AirportNetwork.h"
+#include "../../include/CounterRandom.h"
+#include "Benchmarks.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * Headless AirControlX engine
+ * Runs the scheduler, ATC, radar and runways without SFML and prints
+ * throughput and latency summaries - meant for servers and benchmarks.
+ */
+
+// Command line options with their defaults
+struct EngineOptions
+{
+    int aircraftCount = 20;      // Total aircraft across the six airlines
+    int runwayCount = 3;         // RWY-A/B/C plus extras
+    int durationSeconds = 300;   // Simulated seconds over which flights enter
+    unsigned int seed = 1;       // Seed for entry times and aircraft randomness
+    int workerCount = 0;         // Engine workers (0 = hardware threads)
+    int stepWorkers = 0;         // Step pool workers (0 = hardware threads)
+    int stepMs = 1000;           // Simulated ms between per-aircraft steps (0 = off)
+    double timeScale = 0.0;      // 0 = as fast as possible, 1 = real time, N = N x faster
+    bool verbose = false;        // Print every flight event
+    double flightsPerDay = 0.0;  // > 0 = synthetic traffic instead of the fixed fleet
+    bool dailyProfile = true;    // Time-of-day profile (false = constant-rate Poisson)
+    double emergencyRate = 0.01; // Fraction of generated flights declaring an emergency
+    bool fair = false;           // Weighted-fair queues with airline quotas
+    bool atcTick = false;        // ATC rounds once per simulated second instead of on signals
+    int airportCount = 0;        // > 0 = network of this many airports, one shard each
+    int legs = 2;                // Legs each aircraft flies in the network
+    std::string benchmark;       // Run this micro-benchmark instead of a simulation
+};
+
+static void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --aircraft N         Number of aircraft (default 20)\n"
+              << "  --runways N          Number of runways (default 3)\n"
+              << "  --duration S         Simulated seconds over which flights enter (default 300)\n"
+              << "  --seed N             Random seed (default 1)\n"
+              << "  --workers N          Engine worker threads (default: hardware threads)\n"
+              << "  --step-ms N          Simulated ms between per-aircraft steps, 0 = off (default 1000)\n"
+              << "  --step-workers N     Step pool threads (default: hardware threads)\n"
+              << "  --speed X            Time compression: 1 = real time, 100 = 100x (default: as fast as possible)\n"
+              << "  --flights-per-day N  Generate synthetic traffic at this daily rate instead of a fixed fleet\n"
+              << "  --profile P          Generated traffic shape: daily or flat (default daily)\n"
+              << "  --emergency-rate P   Fraction of generated flights with an emergency (default 0.01)\n"
+              << "  --fair               Share the runways between airlines by weight, with their flight quotas\n"
+              << "  --atc-tick           Run ATC rounds once per simulated second instead of on queue/runway signals\n"
+              << "  --airports N         Simulate a network of N airports, one shard per core (--aircraft and --runways per airport)\n"
+              << "  --legs N             Legs each aircraft flies between network airports (default 2)\n"
+              << "  --bench NAME         Run a micro-benchmark instead of a simulation:\n"
+              << benchmarkNames()
+              << "  --verbose            Print every flight event\n"
+              << "  --help               Show this help" << std::endl;
+}
+
+// Parse the command line - returns false if the program should exit
+static bool parseOptions(int argc, char* argv[], EngineOptions& options, int& exitCode)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage(argv[0]);
+            exitCode = 0;
+            return false;
+        }
+        else if (arg == "--verbose")
+        {
+            options.verbose = true;
+        }
+        else if (arg == "--fair")
+        {
+            options.fair = true;
+        }
+        else if (arg == "--atc-tick")
+        {
+            options.atcTick = true;
+        }
+        else if (arg == "--aircraft" && hasValue)
+        {
+            options.aircraftCount = std::atoi(argv[++i]);
+        }
+        else if (arg == "--runways" && hasValue)
+        {
+            options.runwayCount = std::atoi(argv[++i]);
+        }
+        else if (arg == "--airports" && hasValue)
+        {
+            options.airportCount = std::atoi(argv[++i]);
+        }
+        else if (arg == "--legs" && hasValue)
+        {
+            options.legs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--duration" && hasValue)
+        {
+            options.durationSeconds = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--workers" && hasValue)
+        {
+            options.workerCount = std::atoi(argv[++i]);
+        }
+        else if (arg == "--step-ms" && hasValue)
+        {
+            options.stepMs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--step-workers" && hasValue)
+        {
+            options.stepWorkers = std::atoi(argv[++i]);
+        }
+        else if (arg == "--flights-per-day" && hasValue)
+        {
+            options.flightsPerDay = std::atof(argv[++i]);
+        }
+        else if (arg == "--profile" && hasValue)
+        {
+            std::string profile = argv[++i];
+            if (profile != "daily" && profile != "flat")
+            {
+                std::cerr << "Unknown traffic profile: " << profile << std::endl;
+                exitCode = 1;
+                return false;
+            }
+            options.dailyProfile = (profile == "daily");
+        }
+        else if (arg == "--emergency-rate" && hasValue)
+        {
+            options.emergencyRate = std::atof(argv[++i]);
+        }
+        else if (arg == "--bench" && hasValue)
+        {
+            options.benchmark = argv[++i];
+        }
+        else if (arg == "--speed" && hasValue)
+        {
+            options.timeScale = std::atof(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            printUsage(argv[0]);
+            exitCode = 1;
+            return false;
+        }
+    }
+
+    if (options.aircraftCount <= 0 || options.runwayCount < 3 || options.durationSeconds <= 0)
+    {
+        std::cerr << "Need at least 1 aircraft, 3 runways and a positive duration" << std::endl;
+        exitCode = 1;
+        return false;
+    }
+
+    if (options.airportCount > 0 && (options.airportCount < 2 || options.legs <= 0 || options.timeScale > 0.0 ||
+                                     options.flightsPerDay > 0.0 || options.fair || options.atcTick))
+    {
+        std::cerr << "A network needs at least 2 airports and 1 leg, and runs its fixed fleet as fast as possible"
+                  << " (no --speed, --flights-per-day, --fair or --atc-tick)" << std::endl;
+        exitCode = 1;
+        return false;
+    }
+
+    return true;
+}
+
+// Print mean and percentiles of a set of latency samples (in seconds)
+static void printLatency(const std::string& label, std::vector<SimTime> samples)
+{
+    std::cout << std::left << std::setw(18) << label;
+    if (samples.empty())
+    {
+        std::cout << "no samples" << std::endl;
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (SimTime sample : samples) sum += sample;
+
+    auto percentile = [&samples](double p) {
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[index] / 1000.0;
+    };
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "mean " << (sum / samples.size()) / 1000.0
+              << "  p50 " << percentile(0.50)
+              << "  p90 " << percentile(0.90)
+              << "  p99 " << percentile(0.99)
+              << "  max " << samples.back() / 1000.0 << "  (s)" << std::endl;
+}
+
+/**
+ * Network mode: --aircraft per airport, each starting at its home airport
+ * as a departure some time in the first --duration seconds
+ */
+static int runNetwork(const EngineOptions& options)
+{
+    CounterRandom::setSeed(options.seed);
+
+    AirlineManager airlineManager;
+    airlineManager.initialize(options.aircraftCount * options.airportCount);
+
+    AirportNetwork network;
+    network.initialize(options.airportCount, options.runwayCount);
+    for (int i = 0; i < network.getAirportCount(); i++)
+    {
+        network.getAirport(i).controller.setVerbose(options.verbose);
+    }
+
+    SimTime durationMs = options.durationSeconds * 1000LL;
+    int home = 0;
+    for (Airline* airline : airlineManager.getAllAirlines())
+    {
+        for (Aircraft& aircraft : airline->aircrafts)
+        {
+            unsigned long long key = CounterRandom::keyFor("entry/" + airline->name, aircraft.aircraftIndex);
+            SimTime entryTime = static_cast<SimTime>(CounterRandom::unit(key, 0) * durationMs);
+            network.addFlight(&aircraft, home, entryTime, options.legs);
+            home = (home + 1) % options.airportCount;
+        }
+    }
+
+    std::cout << "AirControlX network: " << options.airportCount << " airports, " << options.aircraftCount
+              << " aircraft and " << options.runwayCount << " runways each, " << options.legs << " legs, seed "
+              << options.seed << std::endl;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    network.start();
+    network.run();
+    auto wallEnd = std::chrono::steady_clock::now();
+    network.stop();
+
+    double wallSeconds = std::chrono::duration_cast<std::chrono::microseconds>(wallEnd - wallStart).count() / 1e6;
+    double simSeconds = network.getSimulatedTime() / 1000.0;
+    int completed = network.getCompletedFlightCount();
+    unsigned long long events = network.getProcessedEventCount();
+
+    std::vector<SimTime> runwayWaits;
+    unsigned long long departures = 0, arrivals = 0, timeouts = 0;
+    for (int i = 0; i < network.getAirportCount(); i++)
+    {
+        AirportNetwork::Airport& airport = network.getAirport(i);
+        std::vector<SimTime> waits = airport.engine->getRunwayWaitTimes();
+        runwayWaits.insert(runwayWaits.end(), waits.begin(), waits.end());
+        departures += airport.departures;
+        arrivals += airport.arrivals;
+        timeouts += airport.timeouts;
+    }
+
+    // ================ SUMMARY ================
+    std::cout << std::endl << "===== Network Summary =====" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Shards:           " << network.getAirportCount() << " (1 engine worker each, "
+              << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+    std::cout << "Simulated time:   " << simSeconds << " s in " << network.getWindowCount() << " windows of "
+              << network.getLookahead() / 1000.0 << " s" << std::endl;
+    std::cout << "Wall time:        " << wallSeconds << " s" << std::endl;
+    std::cout << "Flights:          " << departures << " departures, " << arrivals << " arrivals, "
+              << timeouts << " timed out" << std::endl;
+    std::cout << "Handoffs:         " << network.getHandoffCount() << " between airports, "
+              << network.getOverflowCount() << " through the overflow lock" << std::endl;
+    std::cout << "Throughput:       " << (wallSeconds > 0 ? completed / wallSeconds : 0.0) << " flights/wall second, "
+              << (wallSeconds > 0 ? events / wallSeconds : 0.0) << " events/s" << std::endl;
+    printLatency("Runway wait:", runwayWaits);
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    EngineOptions options;
+    int exitCode = 0;
+    if (!parseOptions(argc, argv, options, exitCode))
+    {
+        return exitCode;
+    }
+
+    if (!options.benchmark.empty())
+    {
+        BenchmarkOptions benchmarkOptions;
+        benchmarkOptions.aircraftCount = options.aircraftCount;
+        benchmarkOptions.seed = options.seed;
+        CounterRandom::setSeed(options.seed);
+        return runBenchmark(options.benchmark, benchmarkOptions);
+    }
+
+    if (options.airportCount > 0)
+    {
+        return runNetwork(options);
+    }
+
+    // Configure simulated time before anything reads the clock
+    SimClock& clock = SimClock::instance();
+    if (options.timeScale <= 0.0)
+    {
+        clock.configure(ClockMode::AsFastAsPossible);
+    }
+    else if (options.timeScale == 1.0)
+    {
+        clock.configure(ClockMode::RealTime);
+    }
+    else
+    {
+        clock.configure(ClockMode::Scaled, options.timeScale);
+    }
+
+    CounterRandom::setSeed(options.seed);
+
+    // Core components - same ones the visual simulation uses
+    AirlineManager airlineManager;
+    RunwayManager runwayManager;
+    ATCScontroller atcController;
+
+    if (options.flightsPerDay <= 0.0)
+    {
+        airlineManager.initialize(options.aircraftCount);
+    }
+    else if (options.fair)
+    {
+        airlineManager.initialize(0);   // No fleets - just the airlines' weights and quotas
+    }
+    runwayManager.initialize(options.runwayCount);
+    atcController.setRunwayManager(&runwayManager);
+    if (options.fair)
+    {
+        atcController.getScheduler()->setFairScheduling(true);
+        atcController.getScheduler()->setAirlinePolicies(airlineManager.getAllAirlines());
+    }
+    atcController.setVerbose(options.verbose);
+
+    SimulationEngine engine(&atcController, &runwayManager);
+    engine.setStepInterval(options.stepMs, options.stepWorkers);
+    if (options.verbose)
+    {
+        engine.setLogger([](const std::string& message) { std::cout << message << std::endl; });
+    }
+
+    TrafficGenerator traffic(&engine);
+    if (options.flightsPerDay > 0.0)
+    {
+        // Stream synthetic flights over the whole run
+        TrafficConfig config = TrafficGenerator::defaultConfig(
+            options.flightsPerDay, options.durationSeconds * 1000LL, options.seed);
+        config.useDailyProfile = options.dailyProfile;
+        config.emergencyRate = options.emergencyRate;
+        traffic.configure(config);
+        traffic.start();
+    }
+    else
+    {
+        // Spread flight entries uniformly over the run so the airport sees a steady stream
+        SimTime durationMs = options.durationSeconds * 1000LL;
+        for (Airline* airline : airlineManager.getAllAirlines())
+        {
+            for (Aircraft& aircraft : airline->aircrafts)
+            {
+                unsigned long long key = CounterRandom::keyFor("entry/" + airline->name, aircraft.aircraftIndex);
+                SimTime entryTime = static_cast<SimTime>(CounterRandom::unit(key, 0) * durationMs);
+                engine.addFlight(&aircraft, entryTime);
+            }
+        }
+    }
+
+    // ATC rounds whenever a flight queues, a runway is freed or an emergency is declared -
+    // or, with --atc-tick, once per simulated second until the run is over and the queues drained
+    int tick = 0;
+    if (options.atcTick)
+    {
+        engine.addPeriodicTask(1000, [&]() {
+            atcController.monitorFlight();
+            tick++;
+            return tick < options.durationSeconds || engine.getActiveFlightCount() > 0;
+        });
+    }
+    else
+    {
+        engine.setControllerEvents(true);
+    }
+
+    std::cout << "AirControlX engine: ";
+    if (options.flightsPerDay > 0.0)
+    {
+        std::cout << static_cast<long long>(options.flightsPerDay) << " flights/day (" << (options.dailyProfile ? "daily" : "flat")
+                  << " profile), ";
+    }
+    else
+    {
+        std::cout << options.aircraftCount << " aircraft, ";
+    }
+    std::cout << options.runwayCount << " runways, " << options.durationSeconds << " s, seed "
+              << options.seed << std::endl;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    engine.start(options.workerCount);
+    engine.waitForCompletion();
+    auto wallEnd = std::chrono::steady_clock::now();
+    int workerCount = engine.getWorkerCount();
+    std::string poolReport = engine.getStepPool().getStatsReport();
+    engine.stop();
+
+    double wallSeconds = std::chrono::duration_cast<std::chrono::microseconds>(wallEnd - wallStart).count() / 1e6;
+    double simSeconds = engine.getCompletionTime() / 1000.0;
+    int completed = engine.getCompletedFlightCount();
+    int timedOut = engine.getTimedOutFlightCount();
+
+    // ================ SUMMARY ================
+    std::cout << std::endl << "===== Engine Summary =====" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Workers:          " << workerCount << std::endl;
+    std::cout << "Simulated time:   " << simSeconds << " s" << std::endl;
+    std::cout << "Wall time:        " << wallSeconds << " s" << std::endl;
+    std::cout << "Flights:          " << completed << " completed, " << timedOut << " timed out" << std::endl;
+    std::cout << "Throughput:       " << (simSeconds > 0 ? completed * 3600.0 / simSeconds : 0.0)
+              << " flights/simulated hour, "
+              << (wallSeconds > 0 ? completed / wallSeconds : 0.0) << " flights/wall second" << std::endl;
+    std::cout << "Events processed: " << engine.getProcessedEventCount() << " ("
+              << (wallSeconds > 0 ? engine.getProcessedEventCount() / wallSeconds : 0.0) << "/s)" << std::endl;
+    printLatency("Runway wait:", engine.getRunwayWaitTimes());
+    printLatency("Flight time:", engine.getFlightTimes());
+    if (!options.atcTick)
+    {
+        std::cout << "ATC rounds:       " << atcController.getReactionReport() << std::endl;
+    }
+    std::cout << atcController.getScheduler()->getTelemetry().getReport();
+    if (options.flightsPerDay > 0.0)
+    {
+        std::cout << "Generated:        " << traffic.getGeneratedCount() << " flights, "
+                  << traffic.getEmergencyCount() << " emergencies, "
+                  << traffic.getPoolSize() << " aircraft objects allocated" << std::endl;
+    }
+    if (options.stepMs > 0)
+    {
+        std::cout << poolReport;
+        std::cout << "Snapshots:        " << engine.getWorldSnapshots().getPublishedCount() << " published, "
+                  << engine.getWorldSnapshots().getSkippedCount() << " skipped" << std::endl;
+    }
+
+    return 0;
+}